@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/shortest_paths/delta_stepping.hpp>
+#include <xnetwork/algorithms/shortest_paths/weighted.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/utils/random.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+/*!
+ * @brief A random digraph with 2^20 nodes, 16 arcs per node and weights
+ *        in [1, 1000], shared by all benchmarks
+ */
+static auto random_graph() -> const xn::CSRGraph<int>&
+{
+    static const auto G = [] {
+        constexpr auto n = std::uint32_t(1) << 20;
+        auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+        auto weights = std::vector<int> {};
+        edges.reserve(16 * n);
+        weights.reserve(16 * n);
+        auto rng = xn::SplitMix64 {42};
+        for (auto k = 0U; k != 16 * n; ++k)
+        {
+            const auto u = std::uint32_t(rng.below(n));
+            const auto v = std::uint32_t(rng.below(n));
+            edges.emplace_back(u, v);
+            weights.push_back(int(1 + rng.below(1000)));
+        }
+        return xn::csr_graph_from_edges<int>(n, edges, weights);
+    }();
+    return G;
+}
+
+static void BM_Dijkstra(benchmark::State& state)
+{
+    const auto& G = random_graph();
+    auto ws = xn::DijkstraWorkspace<int> {G.number_of_nodes()};
+    for (auto _ : state)
+    {
+        xn::single_source_dijkstra(G, 0U, ws);
+        benchmark::DoNotOptimize(ws.dist(1));
+    }
+}
+
+BENCHMARK(BM_Dijkstra)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+//~~~~~~~~~~~~~~~~
+
+// Scaling across cores: the argument is the number of threads
+static void BM_DeltaStepping(benchmark::State& state)
+{
+    const auto& G = random_graph();
+    const auto num_threads = unsigned(state.range(0));
+    auto pool = xn::ThreadPool {num_threads};
+    auto ws =
+        xn::DeltaSteppingWorkspace<int> {G.number_of_nodes(), num_threads};
+    ws.prepare(G, xn::default_delta(G), pool);
+    for (auto _ : state)
+    {
+        xn::delta_stepping(G, 0U, pool, ws);
+        benchmark::DoNotOptimize(ws.dist(1));
+    }
+}
+
+BENCHMARK(BM_DeltaStepping)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+//~~~~~~~~~~~~~~~~
+
+// Effect of the bucket width at a fixed number of threads
+static void BM_DeltaSteppingDelta(benchmark::State& state)
+{
+    const auto& G = random_graph();
+    auto pool = xn::ThreadPool {4};
+    auto ws = xn::DeltaSteppingWorkspace<int> {G.number_of_nodes(), 4};
+    ws.prepare(G, int(state.range(0)), pool);
+    for (auto _ : state)
+    {
+        xn::delta_stepping(G, 0U, pool, ws);
+        benchmark::DoNotOptimize(ws.dist(1));
+    }
+}
+
+BENCHMARK(BM_DeltaSteppingDelta)
+    ->RangeMultiplier(4)
+    ->Range(4, 1024)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
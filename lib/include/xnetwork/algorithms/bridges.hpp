@@ -0,0 +1,52 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native bridge-finding, on the biconnected components of
+components/biconnected.hpp: a bridge is a biconnected component of one
+edge.
+*/
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/components/biconnected.hpp>
+
+namespace xn
+{
+
+/*! Return the bridges of an undirected graph.
+
+    A *bridge* in a graph is an edge whose removal causes the number of
+    connected components of the graph to increase.  Equivalently, a
+    bridge is an edge that does not belong to any cycle.
+
+    Parameters
+    ----------
+    G : CSRGraph with both directions of every edge; an edge with a
+        parallel copy is never a bridge
+
+    Returns
+    -------
+    The bridges (u, v), u < v, in increasing order.
+
+    Examples
+    --------
+    >>> auto C = xn::to_csr_graph(G);  // G a SimpleGraph
+    >>> xn::bridges(C);
+*/
+template <typename CSR>
+auto bridges(const CSR& G)
+    -> std::vector<std::pair<std::uint32_t, std::uint32_t>>
+{
+    return biconnected_components(G)._bridges;
+}
+
+/*! Return whether the graph has any bridges.  See `bridges`. */
+template <typename CSR>
+auto has_bridges(const CSR& G) -> bool
+{
+    return !bridges(G).empty();
+}
+
+} // namespace xn
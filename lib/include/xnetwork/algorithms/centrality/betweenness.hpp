@@ -0,0 +1,808 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native betweenness centrality (Brandes, 2001).
+
+Each source runs one BFS (unweighted) or Dijkstra (weighted) search that
+counts shortest paths, then a backward pass over the nodes in the reverse
+order of their distances accumulates the dependencies.  Predecessors are
+not stored: the backward pass scans the arcs out of each node and keeps
+those that are tight, so the per-thread state is a few flat arrays.
+Sources are spread over a thread pool and every thread adds into its own
+accumulator; the accumulators are summed at the end.
+
+`approximate_betweenness_centrality` samples shortest paths instead
+(Riondato and Kornaropoulos, 2016; Borassi and Natale, 2019): each sample
+is a uniform shortest path between a random pair of nodes, found by a
+balanced bidirectional BFS, and sampling stops as soon as the estimates
+meet an (epsilon, delta) bound.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/heaps.hpp>
+#include <xnetwork/utils/random.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Per-thread state of Brandes' algorithm.
+
+    Parameters
+    ----------
+    num_nodes : number of nodes of the graph
+    num_edges : number of arcs, if edge betweenness is accumulated
+        (default: 0)
+*/
+template <typename Dist>
+class BrandesWorkspace
+{
+  public:
+    using node_t = std::uint32_t;
+    using dist_t = Dist;
+
+    static constexpr auto infinity() -> Dist
+    {
+        return std::numeric_limits<Dist>::has_infinity
+            ? std::numeric_limits<Dist>::infinity()
+            : std::numeric_limits<Dist>::max();
+    }
+
+    std::vector<Dist> _dist;
+    std::vector<double> _sigma; // number of shortest paths
+    std::vector<double> _delta; // dependency of the source
+    std::vector<node_t> _stack; // reached nodes by distance
+    DaryHeap<Dist, node_t> _heap;
+    std::vector<double> _centrality; // sums over this thread's sources
+    std::vector<double> _edge_centrality;
+
+    explicit BrandesWorkspace(
+        std::size_t num_nodes, std::size_t num_edges = 0)
+        : _dist(num_nodes, infinity())
+        , _sigma(num_nodes, 0.0)
+        , _delta(num_nodes, 0.0)
+        , _centrality(num_nodes, 0.0)
+        , _edge_centrality(num_edges, 0.0)
+    {
+    }
+
+    /*! Forget the last source in O(number of reached nodes). */
+    void reset()
+    {
+        for (auto v : this->_stack)
+        {
+            this->_dist[v] = infinity();
+            this->_sigma[v] = 0.0;
+            this->_delta[v] = 0.0;
+        }
+        this->_stack.clear();
+    }
+};
+
+/*! Count the shortest paths from s by BFS. */
+template <typename CSR, typename Dist>
+void _brandes_bfs(
+    const CSR& G, std::uint32_t s, BrandesWorkspace<Dist>& ws)
+{
+    ws.reset();
+    ws._dist[s] = Dist(0);
+    ws._sigma[s] = 1.0;
+    ws._stack.push_back(s);
+    for (auto head = std::size_t(0); head != ws._stack.size(); ++head)
+    {
+        const auto u = ws._stack[head];
+        const auto nd = Dist(ws._dist[u] + 1);
+        for (auto v : G.neighbors(u))
+        {
+            if (ws._dist[v] == ws.infinity())
+            {
+                ws._dist[v] = nd;
+                ws._stack.push_back(v);
+            }
+            if (ws._dist[v] == nd)
+            {
+                ws._sigma[v] += ws._sigma[u];
+            }
+        }
+    }
+}
+
+/*! Count the shortest paths from s by Dijkstra; the stack receives the
+    nodes in the order they are settled. */
+template <typename CSR, typename Dist>
+void _brandes_dijkstra(
+    const CSR& G, std::uint32_t s, BrandesWorkspace<Dist>& ws)
+{
+    ws.reset();
+    ws._heap.clear();
+    ws._dist[s] = Dist(0);
+    ws._sigma[s] = 1.0;
+    ws._heap.push(Dist(0), s);
+    while (!ws._heap.empty())
+    {
+        const auto [d, u] = ws._heap.pop();
+        if (ws._dist[u] < d)
+        {
+            continue; // stale entry
+        }
+        ws._stack.push_back(u);
+        for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+        {
+            const auto v = G.target(e);
+            const auto nd = Dist(d + G.weight(e));
+            if (nd < ws._dist[v])
+            {
+                ws._dist[v] = nd;
+                ws._sigma[v] = ws._sigma[u];
+                ws._heap.push(nd, v);
+            }
+            else if (nd == ws._dist[v])
+            {
+                // v is not settled yet: weights are positive
+                ws._sigma[v] += ws._sigma[u];
+            }
+        }
+    }
+}
+
+/*! Accumulate the dependencies of source s into the thread's sums. */
+template <typename CSR, typename Dist>
+void _brandes_accumulate(const CSR& G, std::uint32_t s,
+    BrandesWorkspace<Dist>& ws, bool endpoints, bool edges)
+{
+    if (endpoints)
+    {
+        ws._centrality[s] += double(ws._stack.size() - 1);
+    }
+    for (auto i = ws._stack.size(); i-- != 0;)
+    {
+        const auto w = ws._stack[i];
+        auto delta = 0.0;
+        for (auto e = G.edge_begin(w); e != G.edge_end(w); ++e)
+        {
+            const auto x = G.target(e);
+            if (ws._dist[x] == ws.infinity()
+                || !(Dist(ws._dist[w] + G.weight(e)) == ws._dist[x]))
+            {
+                continue;
+            }
+            const auto c =
+                ws._sigma[w] / ws._sigma[x] * (1.0 + ws._delta[x]);
+            delta += c;
+            if (edges)
+            {
+                ws._edge_centrality[e] += c;
+            }
+        }
+        ws._delta[w] = delta;
+        if (w != s)
+        {
+            ws._centrality[w] += endpoints ? delta + 1.0 : delta;
+        }
+    }
+}
+
+/*! Run Brandes' algorithm from every node of `sources` and return the
+    unscaled sums (per node, or per arc if `edges`). */
+template <typename CSR, typename Sources>
+auto _brandes(const CSR& G, ThreadPool& pool, const Sources& sources,
+    bool endpoints, bool edges) -> std::vector<double>
+{
+    using Dist = typename CSR::weight_t;
+    using WS = BrandesWorkspace<Dist>;
+
+    const auto n = G.number_of_nodes();
+    const auto m = edges ? G.number_of_edges() : 0;
+    auto workspaces = std::vector<WS> {};
+    workspaces.reserve(pool.size());
+    for (auto t = 0U; t != pool.size(); ++t)
+    {
+        workspaces.emplace_back(n, m);
+    }
+    const auto weighted = G.is_weighted();
+    parallel_for(pool, 0, sources.size(), 1,
+        [&](unsigned tid, std::size_t i) {
+            auto& ws = workspaces[tid];
+            const auto s = std::uint32_t(sources[i]);
+            if (weighted)
+            {
+                _brandes_dijkstra(G, s, ws);
+            }
+            else
+            {
+                _brandes_bfs(G, s, ws);
+            }
+            _brandes_accumulate(G, s, ws, endpoints, edges);
+        });
+
+    auto total = std::move(
+        edges ? workspaces[0]._edge_centrality : workspaces[0]._centrality);
+    for (auto t = std::size_t(1); t != workspaces.size(); ++t)
+    {
+        const auto& part = edges ? workspaces[t]._edge_centrality
+                                 : workspaces[t]._centrality;
+        for (auto i = std::size_t(0); i != total.size(); ++i)
+        {
+            total[i] += part[i];
+        }
+    }
+    return total;
+}
+
+/*! Scale node betweenness as XNetwork does; k is the number of sources
+    the sums were taken over. */
+inline void _rescale_betweenness(std::vector<double>& betweenness,
+    std::size_t n, std::size_t k, bool normalized, bool directed,
+    bool endpoints)
+{
+    auto scale = 1.0;
+    if (normalized)
+    {
+        if (endpoints ? n < 2 : n <= 2)
+        {
+            return; // no normalization
+        }
+        scale = endpoints ? 1.0 / (double(n) * double(n - 1))
+                          : 1.0 / (double(n - 1) * double(n - 2));
+    }
+    else if (!directed)
+    {
+        scale = 0.5;
+    }
+    scale *= double(n) / double(k);
+    for (auto& b : betweenness)
+    {
+        b *= scale;
+    }
+}
+
+/*! Return the list of all nodes `0 .. n-1`. */
+inline auto _all_nodes(std::size_t n) -> std::vector<std::uint32_t>
+{
+    auto nodes = std::vector<std::uint32_t>(n);
+    for (auto v = std::uint32_t(0); v != n; ++v)
+    {
+        nodes[v] = v;
+    }
+    return nodes;
+}
+
+/*! Compute the shortest-path betweenness centrality of all nodes.
+
+    XNetwork's version takes a graph and a weight attribute; here the
+    graph is a CSRGraph snapshot, searched with Dijkstra if it has
+    weights and with BFS otherwise.
+
+    Parameters
+    ----------
+    G : CSRGraph (both directions of every edge for an undirected graph)
+    pool : ThreadPool
+    directed : whether G is directed; without normalization the sums of
+        an undirected graph are halved
+    normalized : normalize by `1/((n-1)(n-2))` (default: true)
+    endpoints : count the endpoints of the paths too (default: false)
+
+    Returns
+    -------
+    The betweenness of every node, indexed by node.
+
+    Notes
+    -----
+    Every thread keeps O(n) state plus an accumulator of n doubles.  The
+    path counts are doubles, which stay exact up to 2^53 paths.  Weights
+    must be positive; zero-weight arcs may miss some shortest paths.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto C = xn::to_csr_graph(G);  // undirected
+    >>> auto bc = xn::betweenness_centrality(C, pool, false);
+*/
+template <typename CSR>
+auto betweenness_centrality(const CSR& G, ThreadPool& pool, bool directed,
+    bool normalized = true, bool endpoints = false) -> std::vector<double>
+{
+    const auto n = G.number_of_nodes();
+    auto betweenness = _brandes(G, pool, _all_nodes(n), endpoints, false);
+    _rescale_betweenness(betweenness, n, n, normalized, directed, endpoints);
+    return betweenness;
+}
+
+/*! Compute the betweenness centrality of all edges.
+
+    Parameters
+    ----------
+    G : CSRGraph (both directions of every edge for an undirected graph)
+    pool : ThreadPool
+    directed : whether G is directed
+    normalized : normalize by `1/(n(n-1))` (default: true)
+
+    Returns
+    -------
+    The betweenness of every arc, indexed like `G.target(e)`.  For an
+    undirected graph both arcs of an edge hold the betweenness of the
+    edge.
+*/
+template <typename CSR>
+auto edge_betweenness_centrality(const CSR& G, ThreadPool& pool,
+    bool directed, bool normalized = true) -> std::vector<double>
+{
+    const auto n = G.number_of_nodes();
+    auto betweenness = _brandes(G, pool, _all_nodes(n), false, true);
+    if (!directed)
+    {
+        // paths through an edge use one arc or the other
+        auto edge = std::vector<double>(betweenness.size());
+        for (auto u = std::uint32_t(0); u != n; ++u)
+        {
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                const auto v = G.target(e);
+                edge[e] = betweenness[e];
+                for (auto r = G.edge_begin(v); r != G.edge_end(v); ++r)
+                {
+                    if (G.target(r) == u)
+                    {
+                        edge[e] += betweenness[r];
+                        break;
+                    }
+                }
+            }
+        }
+        betweenness.swap(edge);
+    }
+    auto scale = 1.0;
+    if (normalized)
+    {
+        scale = n <= 1 ? 1.0 : 1.0 / (double(n) * double(n - 1));
+    }
+    else if (!directed)
+    {
+        scale = 0.5;
+    }
+    for (auto& b : betweenness)
+    {
+        b *= scale;
+    }
+    return betweenness;
+}
+
+/*! Per-thread state of shortest path sampling.
+
+    Parameters
+    ----------
+    num_nodes : number of nodes of the graph
+*/
+class PathSamplingWorkspace
+{
+  public:
+    using node_t = std::uint32_t;
+
+    static constexpr auto none = std::numeric_limits<node_t>::max();
+
+    struct Meeting
+    {
+        node_t _u; // last node of the forward search
+        node_t _v; // first node of the backward search
+        double _paths;
+    };
+
+    std::vector<node_t> _dist_f; // hops from s
+    std::vector<node_t> _dist_b; // hops to t
+    std::vector<double> _sigma_f;
+    std::vector<double> _sigma_b;
+    std::vector<node_t> _touched;
+    std::vector<node_t> _frontier_f;
+    std::vector<node_t> _frontier_b;
+    std::vector<node_t> _next;
+    std::vector<Meeting> _meeting;
+    std::vector<node_t> _path; // inner nodes of the last sample
+    std::vector<std::uint64_t> _count; // samples through every node
+
+    explicit PathSamplingWorkspace(std::size_t num_nodes)
+        : _dist_f(num_nodes, none)
+        , _dist_b(num_nodes, none)
+        , _sigma_f(num_nodes, 0.0)
+        , _sigma_b(num_nodes, 0.0)
+        , _count(num_nodes, 0)
+    {
+    }
+
+    /*! Forget the last sample in O(number of visited nodes). */
+    void reset()
+    {
+        for (auto v : this->_touched)
+        {
+            this->_dist_f[v] = none;
+            this->_dist_b[v] = none;
+            this->_sigma_f[v] = 0.0;
+            this->_sigma_b[v] = 0.0;
+        }
+        this->_touched.clear();
+        this->_meeting.clear();
+        this->_path.clear();
+    }
+};
+
+/*! Expand one level of a bidirectional BFS.
+
+    `G` holds the arcs in the direction of the search.  Arcs into nodes
+    visited by the other side are meetings; they all lie on shortest
+    paths because the two balls were disjoint before this level.
+
+    Returns
+    -------
+    The sum of the degrees of the new frontier.
+*/
+template <typename CSR>
+auto _expand_level(const CSR& G, PathSamplingWorkspace& ws, bool forward)
+    -> std::size_t
+{
+    auto& dist = forward ? ws._dist_f : ws._dist_b;
+    auto& sigma = forward ? ws._sigma_f : ws._sigma_b;
+    const auto& other = forward ? ws._dist_b : ws._dist_f;
+    const auto& other_sigma = forward ? ws._sigma_b : ws._sigma_f;
+    auto& frontier = forward ? ws._frontier_f : ws._frontier_b;
+
+    auto degree = std::size_t(0);
+    ws._next.clear();
+    for (auto u : frontier)
+    {
+        const auto level = dist[u] + 1;
+        for (auto v : G.neighbors(u))
+        {
+            if (other[v] != ws.none)
+            {
+                const auto paths = sigma[u] * other_sigma[v];
+                ws._meeting.push_back(forward
+                        ? PathSamplingWorkspace::Meeting {u, v, paths}
+                        : PathSamplingWorkspace::Meeting {v, u, paths});
+                continue;
+            }
+            if (dist[v] == ws.none)
+            {
+                if (ws._dist_f[v] == ws.none && ws._dist_b[v] == ws.none)
+                {
+                    ws._touched.push_back(v);
+                }
+                dist[v] = level;
+                ws._next.push_back(v);
+                degree += G.degree(v);
+            }
+            if (dist[v] == level)
+            {
+                sigma[v] += sigma[u];
+            }
+        }
+    }
+    frontier.swap(ws._next);
+    return degree;
+}
+
+/*! Walk from u back to the root of a search, picking every step with
+    probability proportional to the number of paths through it.  The
+    nodes other than the root are appended to the path. */
+template <typename CSR>
+void _walk_to_root(const CSR& G, std::uint32_t u,
+    const std::vector<std::uint32_t>& dist, const std::vector<double>& sigma,
+    SplitMix64& rng, std::vector<std::uint32_t>& path)
+{
+    while (dist[u] != 0)
+    {
+        path.push_back(u);
+        auto r = rng.uniform() * sigma[u];
+        auto next = u;
+        for (auto p : G.neighbors(u))
+        {
+            if (dist[p] + 1 == dist[u])
+            {
+                next = p;
+                r -= sigma[p];
+                if (r < 0.0)
+                {
+                    break;
+                }
+            }
+        }
+        u = next;
+    }
+}
+
+/*! Draw a uniform shortest path from s to t (s != t).
+
+    The side whose frontier has fewer arcs is expanded first, so both
+    balls stay small when the pair is close.  On return `ws._path` holds
+    the inner nodes of the path, and is empty if t is not reachable.
+
+    Parameters
+    ----------
+    G : CSRGraph
+    GT : its transpose (G itself for an undirected graph)
+*/
+template <typename CSR>
+void _sample_shortest_path(const CSR& G, const CSR& GT, std::uint32_t s,
+    std::uint32_t t, SplitMix64& rng, PathSamplingWorkspace& ws)
+{
+    ws.reset();
+    ws._dist_f[s] = 0;
+    ws._sigma_f[s] = 1.0;
+    ws._dist_b[t] = 0;
+    ws._sigma_b[t] = 1.0;
+    ws._touched.insert(ws._touched.end(), {s, t});
+    ws._frontier_f.assign(1, s);
+    ws._frontier_b.assign(1, t);
+    auto degree_f = G.degree(s);
+    auto degree_b = GT.degree(t);
+    while (ws._meeting.empty())
+    {
+        if (ws._frontier_f.empty() || ws._frontier_b.empty())
+        {
+            return; // no path
+        }
+        if (degree_f <= degree_b)
+        {
+            degree_f = _expand_level(G, ws, true);
+        }
+        else
+        {
+            degree_b = _expand_level(GT, ws, false);
+        }
+    }
+    auto total = 0.0;
+    for (const auto& m : ws._meeting)
+    {
+        total += m._paths;
+    }
+    auto r = rng.uniform() * total;
+    auto pick = ws._meeting.back();
+    for (const auto& m : ws._meeting)
+    {
+        r -= m._paths;
+        if (r < 0.0)
+        {
+            pick = m;
+            break;
+        }
+    }
+    _walk_to_root(GT, pick._u, ws._dist_f, ws._sigma_f, rng, ws._path);
+    _walk_to_root(G, pick._v, ws._dist_b, ws._sigma_b, rng, ws._path);
+}
+
+/*! Return an upper bound on the number of nodes of a shortest path.
+
+    For an undirected graph a BFS from one node of every component gives
+    `2 ecc + 1`; a directed graph gets the trivial bound n.
+*/
+template <typename CSR>
+auto _vertex_diameter_bound(const CSR& G, bool directed) -> std::size_t
+{
+    const auto n = G.number_of_nodes();
+    if (directed)
+    {
+        return n;
+    }
+    auto dist = std::vector<std::uint32_t>(n, PathSamplingWorkspace::none);
+    auto queue = std::vector<std::uint32_t> {};
+    auto bound = std::size_t(1);
+    for (auto r = std::uint32_t(0); r != n; ++r)
+    {
+        if (dist[r] != PathSamplingWorkspace::none)
+        {
+            continue;
+        }
+        dist[r] = 0;
+        queue.assign(1, r);
+        for (auto head = std::size_t(0); head != queue.size(); ++head)
+        {
+            const auto u = queue[head];
+            for (auto v : G.neighbors(u))
+            {
+                if (dist[v] == PathSamplingWorkspace::none)
+                {
+                    dist[v] = dist[u] + 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+        const auto ecc = std::size_t(dist[queue.back()]);
+        bound = std::max(bound, std::min(2 * ecc + 1, queue.size()));
+    }
+    return bound;
+}
+
+/*! Result of `approximate_betweenness_centrality`. */
+struct ApproximateBetweenness
+{
+    /*! Estimated fraction of the ordered pairs (s, t), s != t, whose
+        shortest paths pass through every node. */
+    std::vector<double> _betweenness;
+    /*! The k nodes of highest estimate, highest first. */
+    std::vector<std::uint32_t> _ranking;
+    /*! With probability at least 1 - delta every estimate is within
+        `_error` of the exact value. */
+    double _error = 0.0;
+    double _delta = 0.0;
+    std::size_t _samples = 0;
+    std::size_t _max_samples = 0;
+};
+
+/*! Estimate the betweenness centrality of all nodes by sampling shortest
+    paths.
+
+    Parameters
+    ----------
+    G : CSRGraph without weights (both directions of every edge for an
+        undirected graph)
+    pool : ThreadPool
+    directed : whether G is directed
+    epsilon : absolute error bound, in (0, 1) (default: 0.01)
+    delta : probability that the bound fails, in (0, 1) (default: 0.1)
+    k : if positive, stop as soon as the k most central nodes are told
+        apart from the others (default: 0)
+    seed : random seed (default: 0)
+
+    Returns
+    -------
+    An ApproximateBetweenness with the estimates, the top k ranking, the
+    bound met and the number of samples.
+
+    Raises
+    ------
+    XNetworkError
+        If epsilon or delta is not in (0, 1).
+    XNetworkNotImplemented
+        If G has weights.
+
+    Notes
+    -----
+    The estimates use the scale of Riondato and Kornaropoulos, the
+    fraction of ordered pairs; multiply by `n / (n - 2)` to compare with
+    `betweenness_centrality(G, pool, directed)`.
+
+    At most `0.5 / epsilon^2 (floor(log2(VD - 2)) + 1 + ln(2 / delta))`
+    paths are sampled, where VD bounds the number of nodes of a shortest
+    path; that many samples meet the bound whatever the graph.  Sampling
+    stops earlier once an empirical Bernstein bound, taken at doubling
+    checkpoints and split over all nodes and checkpoints, certifies
+    epsilon for every node, or certifies the top k set.  In the latter
+    case `_error` may exceed epsilon.  The results do not depend on the
+    number of threads.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto C = xn::to_csr_graph(G);  // undirected
+    >>> auto r = xn::approximate_betweenness_centrality(C, pool, false);
+*/
+template <typename CSR>
+auto approximate_betweenness_centrality(const CSR& G, ThreadPool& pool,
+    bool directed, double epsilon = 0.01, double delta = 0.1,
+    std::size_t k = 0, std::uint64_t seed = 0) -> ApproximateBetweenness
+{
+    if (!(epsilon > 0.0 && epsilon < 1.0) || !(delta > 0.0 && delta < 1.0))
+    {
+        throw XNetworkError("epsilon and delta must be in (0, 1)");
+    }
+    if (G.is_weighted())
+    {
+        throw XNetworkNotImplemented(
+            "approximate betweenness of a weighted graph");
+    }
+    const auto n = G.number_of_nodes();
+    auto result = ApproximateBetweenness {};
+    result._betweenness.assign(n, 0.0);
+    result._delta = delta;
+    k = std::min(k, n);
+    const auto by_estimate = [&](std::uint32_t a, std::uint32_t b) {
+        const auto& est = result._betweenness;
+        return est[a] > est[b] || (est[a] == est[b] && a < b);
+    };
+    auto order = _all_nodes(n);
+    if (n < 3)
+    {
+        result._ranking.assign(order.begin(), order.begin() + long(k));
+        return result;
+    }
+
+    const auto vd = _vertex_diameter_bound(G, directed);
+    const auto log_vd = vd > 3 ? std::floor(std::log2(double(vd - 2))) : 0.0;
+    const auto omega = std::max(std::size_t(2),
+        std::size_t(std::ceil(0.5 / (epsilon * epsilon)
+            * (log_vd + 1.0 + std::log(2.0 / delta)))));
+    result._max_samples = omega;
+    auto target = std::min(omega, std::max(omega / 64, std::size_t(1000)));
+    auto checkpoints = 1.0;
+    for (auto tau = target; tau < omega; tau *= 2)
+    {
+        checkpoints += 1.0;
+    }
+    // ln(4 / delta') with delta' = delta / (2 n checkpoints)
+    const auto log_term = std::log(8.0 * double(n) * checkpoints / delta);
+
+    const auto GT = directed ? G.transpose() : CSR {};
+    const auto& R = directed ? GT : G;
+    auto workspaces = std::vector<PathSamplingWorkspace> {};
+    workspaces.reserve(pool.size());
+    for (auto t = 0U; t != pool.size(); ++t)
+    {
+        workspaces.emplace_back(n);
+    }
+    auto radius = std::vector<double>(n);
+    auto samples = std::size_t(0);
+    while (true)
+    {
+        parallel_for(pool, samples, target, 64,
+            [&](unsigned tid, std::size_t i) {
+                auto& ws = workspaces[tid];
+                auto rng = SplitMix64 {seed ^ (i * 0xd1b54a32d192ed03ULL)};
+                const auto s = std::uint32_t(rng.below(n));
+                auto t = std::uint32_t(rng.below(n - 1));
+                t += t >= s ? 1 : 0;
+                _sample_shortest_path(G, R, s, t, rng, ws);
+                for (auto v : ws._path)
+                {
+                    ++ws._count[v];
+                }
+            });
+        samples = target;
+
+        const auto tau = double(samples);
+        auto max_radius = 0.0;
+        for (auto v = std::size_t(0); v != n; ++v)
+        {
+            auto count = std::uint64_t(0);
+            for (const auto& ws : workspaces)
+            {
+                count += ws._count[v];
+            }
+            const auto p = double(count) / tau;
+            // empirical Bernstein bound (Maurer and Pontil, 2009)
+            const auto var = p * (1.0 - p) * tau / (tau - 1.0);
+            radius[v] = std::sqrt(2.0 * var * log_term / tau)
+                + 7.0 * log_term / (3.0 * (tau - 1.0));
+            result._betweenness[v] = p;
+            max_radius = std::max(max_radius, radius[v]);
+        }
+        result._error = max_radius;
+
+        auto done = max_radius <= epsilon;
+        if (!done && k != 0 && k != n)
+        {
+            std::sort(order.begin(), order.end(), by_estimate);
+            const auto& est = result._betweenness;
+            auto lower = 1.0;
+            for (auto i = std::size_t(0); i != k; ++i)
+            {
+                lower = std::min(lower, est[order[i]] - radius[order[i]]);
+            }
+            auto upper = 0.0;
+            for (auto i = k; i != n; ++i)
+            {
+                upper = std::max(upper, est[order[i]] + radius[order[i]]);
+            }
+            done = lower > upper;
+        }
+        if (done || samples == omega)
+        {
+            break;
+        }
+        target = std::min(omega, 2 * target);
+    }
+    if (samples == omega)
+    {
+        result._error = std::min(result._error, epsilon);
+    }
+    result._samples = samples;
+    std::sort(order.begin(), order.end(), by_estimate);
+    result._ranking.assign(order.begin(), order.begin() + long(k));
+    return result;
+}
+
+} // namespace xn
@@ -0,0 +1,424 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native closeness centrality of unweighted graphs.
+
+`closeness_centrality` runs the searches 64 sources at a time with
+`multi_source_bfs`, one batch per task of a thread pool, and keeps only
+the per-source sums.  `top_k_closeness_centrality` follows Bergamini,
+Borassi, Crescenzi, Marino and Meyerhenke (2016): sources are taken in
+decreasing order of degree, and the search from a node stops as soon as
+an upper bound on its closeness falls below the k-th best value found so
+far.  Both measures use the distances *to* a node, so the searches of a
+directed graph run on its transpose.
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/traversal/breadth_first_search.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Sums over the distances to every node, see `_distance_sums`. */
+struct DistanceSums
+{
+    std::vector<std::uint64_t> _reach; // nodes at finite distance
+    std::vector<double> _farness;      // sum of the distances
+    std::vector<double> _harmonic;     // sum of their reciprocals
+};
+
+/*! Throw XNetworkNotImplemented if G has weights. */
+template <typename CSR>
+void _require_unweighted(const CSR& G)
+{
+    if (G.is_weighted())
+    {
+        throw XNetworkNotImplemented("distance sums of a weighted graph");
+    }
+}
+
+/*! Sum the distances from every node of R with batches of 64 searches.
+
+    Parameters
+    ----------
+    R : CSRGraph searched from every node (weights are ignored)
+    pool : ThreadPool
+*/
+template <typename CSR>
+auto _distance_sums(const CSR& R, ThreadPool& pool) -> DistanceSums
+{
+    using WS = MultiSourceBFSWorkspace<64>;
+    using node_t = WS::node_t;
+
+    const auto n = R.number_of_nodes();
+    auto sums = DistanceSums {std::vector<std::uint64_t>(n),
+        std::vector<double>(n), std::vector<double>(n)};
+    auto workspaces = std::vector<WS> {};
+    workspaces.reserve(pool.size());
+    for (auto t = 0U; t != pool.size(); ++t)
+    {
+        workspaces.emplace_back(n);
+    }
+    const auto num_batches = (n + WS::width - 1) / WS::width;
+    parallel_for(pool, 0, num_batches, 1, [&](unsigned tid, std::size_t b) {
+        const auto first = b * WS::width;
+        const auto last = std::min(n, first + WS::width);
+        auto sources = std::vector<node_t> {};
+        for (auto i = first; i != last; ++i)
+        {
+            sources.push_back(node_t(i));
+        }
+        auto reach = std::array<std::uint64_t, WS::width> {};
+        auto farness = std::array<std::uint64_t, WS::width> {};
+        auto harmonic = std::array<double, WS::width> {};
+        multi_source_bfs(R, sources, workspaces[tid],
+            [&](node_t, std::uint32_t level, const WS::mask_t& mask) {
+                const auto inverse = level == 0 ? 0.0 : 1.0 / level;
+                mask.for_each([&](std::size_t i) {
+                    ++reach[i];
+                    farness[i] += level;
+                    harmonic[i] += inverse;
+                });
+            });
+        for (auto i = first; i != last; ++i)
+        {
+            sums._reach[i] = reach[i - first];
+            sums._farness[i] = double(farness[i - first]);
+            sums._harmonic[i] = harmonic[i - first];
+        }
+    });
+    return sums;
+}
+
+/*! Closeness from the sums over the nodes at finite distance. */
+inline auto _closeness(double reach, double farness, std::size_t n,
+    bool wf_improved) -> double
+{
+    if (!(farness > 0.0) || n < 2)
+    {
+        return 0.0;
+    }
+    const auto closeness = (reach - 1.0) / farness;
+    return wf_improved ? closeness * (reach - 1.0) / double(n - 1)
+                       : closeness;
+}
+
+/*! Compute the closeness centrality of all nodes.
+
+    Parameters
+    ----------
+    G : CSRGraph without weights (both directions of every edge for an
+        undirected graph)
+    pool : ThreadPool
+    directed : whether G is directed; the distances are then taken from
+        the other nodes to a node, as in XNetwork
+    wf_improved : scale by the fraction of nodes reachable (Wasserman and
+        Faust) (default: true)
+
+    Returns
+    -------
+    The closeness of every node, indexed by node.
+
+    Raises
+    ------
+    XNetworkNotImplemented
+        If G has weights.
+
+    Notes
+    -----
+    The n searches run 64 at a time, so every arc is scanned about n / 64
+    times per level of the batch.  Use `top_k_closeness_centrality` when
+    only the most central nodes are needed.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto C = xn::to_csr_graph(G);  // undirected
+    >>> auto cc = xn::closeness_centrality(C, pool, false);
+*/
+template <typename CSR>
+auto closeness_centrality(const CSR& G, ThreadPool& pool, bool directed,
+    bool wf_improved = true) -> std::vector<double>
+{
+    _require_unweighted(G);
+    const auto n = G.number_of_nodes();
+    const auto GT = directed ? G.transpose() : CSR {};
+    const auto sums = _distance_sums(directed ? GT : G, pool);
+    auto closeness = std::vector<double>(n);
+    for (auto v = std::size_t(0); v != n; ++v)
+    {
+        closeness[v] = _closeness(
+            double(sums._reach[v]), sums._farness[v], n, wf_improved);
+    }
+    return closeness;
+}
+
+/*! State of a pruned search, see `_top_k_bfs`.  The nodes at `_level`
+    are being expanded; the nodes seen so far lie within `_level + 1`,
+    the unseen ones at `_level + 1` or more. */
+struct BFSLevelBound
+{
+    std::uint32_t _level;
+    std::uint64_t _visited;  // nodes seen
+    std::uint64_t _next;     // bound on the unseen nodes at _level + 1
+    std::uint64_t _reach;    // bound on the nodes at finite distance
+    double _farness;         // sum of the distances of the nodes seen
+    double _harmonic;        // sum of their reciprocals
+};
+
+/*! Return a bound on the number of nodes every node of R reaches: the
+    size of its component for an undirected graph, n otherwise. */
+template <typename CSR>
+auto _reach_bound(const CSR& R, bool directed) -> std::vector<std::uint64_t>
+{
+    const auto n = R.number_of_nodes();
+    auto bound = std::vector<std::uint64_t>(n, n);
+    if (directed)
+    {
+        return bound;
+    }
+    auto seen = std::vector<char>(n, 0);
+    auto queue = std::vector<std::uint32_t> {};
+    for (auto r = std::uint32_t(0); r != n; ++r)
+    {
+        if (seen[r])
+        {
+            continue;
+        }
+        seen[r] = 1;
+        queue.assign(1, r);
+        for (auto head = std::size_t(0); head != queue.size(); ++head)
+        {
+            for (auto v : R.neighbors(queue[head]))
+            {
+                if (!seen[v])
+                {
+                    seen[v] = 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+        for (auto v : queue)
+        {
+            bound[v] = queue.size();
+        }
+    }
+    return bound;
+}
+
+/*! Find the k nodes of R with the highest score by pruned searches.
+
+    `upper(b)` must bound the score of a node from the state `b` of its
+    search, checked before every node is expanded, and return the exact
+    score once the search is over (then `b._next == 0` and
+    `b._reach == b._visited`).
+
+    Returns
+    -------
+    Pairs (node, score) by decreasing score, ties by node.
+*/
+template <typename CSR, typename Upper>
+auto _top_k_bfs(const CSR& R, ThreadPool& pool, bool directed,
+    std::size_t k, Upper&& upper)
+    -> std::vector<std::pair<std::uint32_t, double>>
+{
+    using node_t = std::uint32_t;
+    using Entry = std::pair<double, node_t>;
+
+    const auto n = R.number_of_nodes();
+    const auto none = std::numeric_limits<node_t>::max();
+    k = std::min(k, n);
+    if (k == 0)
+    {
+        return {};
+    }
+    const auto reach = _reach_bound(R, directed);
+    auto order = std::vector<node_t>(n);
+    for (auto v = node_t(0); v != n; ++v)
+    {
+        order[v] = v;
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [&](node_t a, node_t b) { return R.degree(a) > R.degree(b); });
+
+    // the k best scores so far, worst on top
+    auto best = std::priority_queue<Entry, std::vector<Entry>,
+        std::greater<Entry>> {};
+    auto mutex = std::mutex {};
+    auto threshold = std::atomic<double> {-1.0};
+
+    struct Search
+    {
+        std::vector<node_t> _dist;
+        std::vector<node_t> _queue;
+    };
+    auto searches = std::vector<Search>(pool.size());
+    for (auto& search : searches)
+    {
+        search._dist.assign(n, none);
+    }
+
+    const auto score = [&](node_t s, Search& search) -> double {
+        auto& dist = search._dist;
+        auto& queue = search._queue;
+        for (auto v : queue)
+        {
+            dist[v] = none;
+        }
+        queue.assign(1, s);
+        dist[s] = 0;
+        auto b = BFSLevelBound {0, 1, 0, reach[s], 0.0, 0.0};
+        for (auto head = std::size_t(0); head != queue.size();)
+        {
+            // the unseen nodes one level below are bounded by the arcs
+            // out of the rest of this level
+            const auto level_end = queue.size();
+            const auto back = !directed && b._level != 0 ? 1U : 0U;
+            auto arcs = std::uint64_t(0);
+            for (auto i = head; i != level_end; ++i)
+            {
+                arcs += R.degree(queue[i]) - back;
+            }
+            for (; head != level_end; ++head)
+            {
+                b._next = std::min(arcs, b._reach - b._visited);
+                if (upper(b) < threshold.load(std::memory_order_relaxed))
+                {
+                    return -1.0; // cannot enter the top k
+                }
+                const auto u = queue[head];
+                arcs -= R.degree(u) - back;
+                for (auto v : R.neighbors(u))
+                {
+                    if (dist[v] == none)
+                    {
+                        dist[v] = b._level + 1;
+                        queue.push_back(v);
+                        ++b._visited;
+                        b._farness += b._level + 1.0;
+                        b._harmonic += 1.0 / (b._level + 1.0);
+                    }
+                }
+            }
+            ++b._level;
+        }
+        b._next = 0;
+        b._reach = b._visited;
+        return upper(b);
+    };
+
+    // rounds let the threshold rise before the low-degree nodes
+    const auto round = std::size_t(256) * pool.size();
+    for (auto first = std::size_t(0); first < n; first += round)
+    {
+        const auto last = std::min(n, first + round);
+        parallel_for(pool, first, last, 1, [&](unsigned tid, std::size_t i) {
+            const auto s = order[i];
+            const auto value = score(s, searches[tid]);
+            if (value < threshold.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            best.emplace(value, s);
+            if (best.size() > k)
+            {
+                best.pop();
+            }
+            if (best.size() == k)
+            {
+                threshold.store(best.top().first, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    auto result = std::vector<std::pair<node_t, double>> {};
+    for (; !best.empty(); best.pop())
+    {
+        result.emplace_back(best.top().second, best.top().first);
+    }
+    std::sort(result.begin(), result.end(), [](auto& a, auto& b) {
+        return a.second > b.second
+            || (a.second == b.second && a.first < b.first);
+    });
+    return result;
+}
+
+/*! Find the k nodes of highest closeness centrality.
+
+    Parameters
+    ----------
+    G : CSRGraph without weights (both directions of every edge for an
+        undirected graph)
+    pool : ThreadPool
+    directed : whether G is directed
+    k : number of nodes
+    wf_improved : scale by the fraction of nodes reachable (default: true)
+
+    Returns
+    -------
+    Pairs (node, closeness) by decreasing closeness.  Nodes tied with the
+    k-th value may be swapped for one another.
+
+    Raises
+    ------
+    XNetworkNotImplemented
+        If G has weights.
+
+    Notes
+    -----
+    Before every node of the search from u is expanded, the nodes not
+    seen yet are one level below the current one or further, and at most
+    as many of them as there are arcs left out of the current level are
+    one level below; this bounds the farness of u from below.  Most
+    searches stop within a few levels, and the k values returned are
+    exact.  The number of nodes u can reach is known for an undirected
+    graph; a directed graph falls back on n, which prunes less.
+
+    Examples
+    --------
+    >>> auto top = xn::top_k_closeness_centrality(C, pool, false, 100);
+*/
+template <typename CSR>
+auto top_k_closeness_centrality(const CSR& G, ThreadPool& pool,
+    bool directed, std::size_t k, bool wf_improved = true)
+    -> std::vector<std::pair<std::uint32_t, double>>
+{
+    _require_unweighted(G);
+    const auto n = G.number_of_nodes();
+    const auto GT = directed ? G.transpose() : CSR {};
+    const auto& R = directed ? GT : G;
+    return _top_k_bfs(R, pool, directed, k, [&](const BFSLevelBound& b) {
+        const auto at = [&](std::uint64_t reach) {
+            const auto near = std::min(b._next, reach - b._visited);
+            const auto far = reach - b._visited - near;
+            const auto farness = b._farness
+                + double(near) * (b._level + 1.0)
+                + double(far) * (b._level + 2.0);
+            return _closeness(double(reach), farness, n, wf_improved);
+        };
+        if (!directed)
+        {
+            return at(b._reach); // the exact reach
+        }
+        // the closeness is largest at an end of one of the linear pieces
+        // of the farness bound
+        return std::max({at(b._visited),
+            at(std::min(b._reach, b._visited + b._next)), at(b._reach)});
+    });
+}
+
+} // namespace xn
@@ -0,0 +1,342 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native current-flow betweenness centrality (Brandes and Fleischer, 2005).
+
+The graph is read as an electrical network with the edge weights as
+conductances.  A unit current from s to t sets potentials p = L+ (e_s -
+e_t), and the throughput of a node v not in {s, t} is half the current
+through its edges.  Current-flow betweenness sums the throughput over all
+pairs s < t.
+
+Instead of the rows of a dense inverse Laplacian, the flows are computed
+edge by edge: for an edge (u, v) of conductance c the vector a = c L+ (e_u
+- e_v) holds, at every node s, the current through (u, v) when a unit
+current enters at s, so the current for the pair (s, t) is a[s] - a[t]
+and the sum of |a[s] - a[t]| over all pairs follows from sorting a.  Each
+edge costs one grounded Laplacian solve (see laplacian_solver.hpp) and
+O(n) memory; the solves run in parallel, one workspace per thread.
+
+`approximate_current_flow_betweenness_centrality` solves for random
+pairs (s, t) only.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/linalg/laplacian_solver.hpp>
+#include <xnetwork/utils/random.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Per-thread state of the current-flow solves. */
+class CurrentFlowWorkspace
+{
+  public:
+    CGWorkspace _cg;
+    std::vector<double> _b; // right-hand side, kept zero between solves
+    std::vector<double> _x;
+
+    explicit CurrentFlowWorkspace(std::size_t num_nodes = 0)
+        : _cg(num_nodes)
+        , _b(num_nodes, 0.0)
+        , _x(num_nodes, 0.0)
+    {
+    }
+};
+
+/*! Return, for every edge of L, the sum over the pairs s < t of the
+    current through the edge for a unit s-t current. */
+inline auto _edge_current_sums(const GroundedLaplacian& L, ThreadPool& pool,
+    double tol) -> std::vector<double>
+{
+    const auto n = L.number_of_nodes();
+    const auto& E = L.edges();
+    auto sums = std::vector<double>(E.size());
+    auto workspaces = std::vector<CurrentFlowWorkspace>(
+        pool.size(), CurrentFlowWorkspace(n));
+    parallel_for(pool, 0, E.size(), 1, [&](unsigned tid, std::size_t i) {
+        auto& ws = workspaces[tid];
+        const auto& e = E[i];
+        ws._b[e._u] = 1.0;
+        ws._b[e._v] = -1.0;
+        L.solve(ws._b, ws._x, ws._cg, tol);
+        ws._b[e._u] = ws._b[e._v] = 0.0;
+        // sum |a[s] - a[t]| over s < t: the j-th smallest entry is added
+        // j times and subtracted n - 1 - j times
+        std::sort(ws._x.begin(), ws._x.end());
+        auto sum = 0.0;
+        for (auto j = std::size_t(0); j != n; ++j)
+        {
+            sum += ws._x[j] * (2.0 * double(j) - double(n - 1));
+        }
+        sums[i] = e._conductance * sum;
+    });
+    return sums;
+}
+
+/*! Compute current-flow betweenness centrality for nodes.
+
+    Current-flow betweenness centrality uses an electrical current model
+    for information spreading, in contrast to betweenness centrality,
+    which uses shortest paths.  It is also known as random-walk
+    betweenness centrality [2].
+
+    Parameters
+    ----------
+    G : CSRGraph of a connected undirected graph, holding both directions
+        of every edge; the weights (or 1) are the conductances
+    pool : ThreadPool
+    normalized : if true the values are normalized by 2 / ((n-1)(n-2))
+    preconditioner : preconditioner of the conjugate gradient solves
+    tol : relative residual of the solves
+
+    Returns
+    -------
+    The current-flow betweenness of every node, indexed by node.
+
+    Raises
+    ------
+    XNetworkError
+        If G is not connected.
+    XNetworkPointlessConcept
+        If G has no nodes.
+
+    Notes
+    -----
+    The algorithm takes one Laplacian solve per edge, each O(m) per
+    conjugate gradient iteration, and O(n) memory per thread plus O(m),
+    instead of the O(n^2) of a dense inverse.
+
+    References
+    ----------
+    .. [1] Ulrik Brandes and Daniel Fleischer,
+       Centrality Measures Based on Current Flow.
+       Proc. 22nd Symp. Theoretical Aspects of Computer Science (STACS '05).
+       LNCS 3404, pp. 533-544. Springer-Verlag, 2005.
+    .. [2] A measure of betweenness centrality based on random walks,
+       M. E. J. Newman, Social Networks 27, 39-54 (2005).
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto cfb = xn::current_flow_betweenness_centrality(C, pool);
+*/
+template <typename CSR>
+auto current_flow_betweenness_centrality(const CSR& G, ThreadPool& pool,
+    bool normalized = true,
+    LaplacianPreconditioner preconditioner =
+        LaplacianPreconditioner::incomplete_cholesky,
+    double tol = 1.0e-8) -> std::vector<double>
+{
+    const auto L = GroundedLaplacian {G, preconditioner};
+    const auto n = L.number_of_nodes();
+    auto betweenness = std::vector<double>(n, 0.0);
+    if (n <= 2)
+    {
+        return betweenness;
+    }
+    const auto sums = _edge_current_sums(L, pool, tol);
+    const auto& E = L.edges();
+    for (auto i = std::size_t(0); i != E.size(); ++i)
+    {
+        betweenness[E[i]._u] += sums[i];
+        betweenness[E[i]._v] += sums[i];
+    }
+    // the n - 1 pairs with v as an end carry a unit current into or out
+    // of v that is not throughput
+    const auto nb = double(n - 1) * double(n - 2);
+    const auto scale = normalized ? 1.0 / nb : 0.5;
+    for (auto& b : betweenness)
+    {
+        b = (b - double(n - 1)) * scale;
+    }
+    return betweenness;
+}
+
+/*! Compute current-flow betweenness centrality for edges.
+
+    Parameters
+    ----------
+    G : CSRGraph of a connected undirected graph, holding both directions
+        of every edge; the weights (or 1) are the conductances
+    pool : ThreadPool
+    normalized : if true the values are normalized by 2 / ((n-1)(n-2))
+    preconditioner : preconditioner of the conjugate gradient solves
+    tol : relative residual of the solves
+
+    Returns
+    -------
+    One value per arc of G, indexed by arc: both arcs of an edge hold the
+    value of the edge; parallel edges share their current in proportion
+    to their conductances; self-loops hold 0.
+
+    Raises
+    ------
+    XNetworkError
+        If G is not connected.
+    XNetworkPointlessConcept
+        If G has no nodes.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto ecf = xn::edge_current_flow_betweenness_centrality(C, pool);
+    >>> ecf[C.edge_begin(u)];  // the first edge of u
+*/
+template <typename CSR>
+auto edge_current_flow_betweenness_centrality(const CSR& G,
+    ThreadPool& pool, bool normalized = true,
+    LaplacianPreconditioner preconditioner =
+        LaplacianPreconditioner::incomplete_cholesky,
+    double tol = 1.0e-8) -> std::vector<double>
+{
+    using Edge = GroundedLaplacian::Edge;
+    const auto L = GroundedLaplacian {G, preconditioner};
+    const auto n = L.number_of_nodes();
+    auto betweenness = std::vector<double>(G.number_of_edges(), 0.0);
+    if (n <= 2)
+    {
+        return betweenness;
+    }
+    const auto sums = _edge_current_sums(L, pool, tol);
+    const auto& E = L.edges();
+    const auto scale = normalized ? 1.0 / (double(n - 1) * double(n - 2))
+                                  : 0.5;
+    for (auto u = 0U; u != n; ++u)
+    {
+        for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+        {
+            const auto v = G.target(e);
+            if (u == v)
+            {
+                continue;
+            }
+            const auto key = Edge {std::min(u, v), std::max(u, v), 0.0};
+            const auto it = std::lower_bound(E.begin(), E.end(), key,
+                [](const Edge& a, const Edge& b) {
+                    return a._u != b._u ? a._u < b._u : a._v < b._v;
+                });
+            const auto share = double(G.weight(e)) / it->_conductance;
+            betweenness[e] = sums[std::size_t(it - E.begin())] * share * scale;
+        }
+    }
+    return betweenness;
+}
+
+/*! Compute the approximate current-flow betweenness centrality for nodes.
+
+    Approximates the current-flow betweenness centrality within absolute
+    error of epsilon with high probability [1].
+
+    Parameters
+    ----------
+    G : CSRGraph of a connected undirected graph, holding both directions
+        of every edge; the weights (or 1) are the conductances
+    pool : ThreadPool
+    normalized : if true the values are normalized by 2 / ((n-1)(n-2))
+    epsilon : absolute error tolerance
+    kmax : maximum number of sample pairs
+    seed : seed of the pair sampling; the result does not depend on the
+        number of threads, up to rounding
+    preconditioner : preconditioner of the conjugate gradient solves
+    tol : relative residual of the solves
+
+    Returns
+    -------
+    The estimated current-flow betweenness of every node, indexed by node.
+
+    Raises
+    ------
+    XNetworkError
+        If G is not connected, or if more than kmax pairs are needed.
+    XNetworkPointlessConcept
+        If G has no nodes.
+
+    Notes
+    -----
+    k = ceil((c / epsilon)^2 log n) random pairs are solved for, with
+    c = n (n-1) / ((n-1)(n-2)); each costs one Laplacian solve.
+
+    References
+    ----------
+    .. [1] Ulrik Brandes and Daniel Fleischer,
+       Centrality Measures Based on Current Flow.
+       Proc. 22nd Symp. Theoretical Aspects of Computer Science (STACS '05).
+       LNCS 3404, pp. 533-544. Springer-Verlag, 2005.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto cfb = xn::approximate_current_flow_betweenness_centrality(
+    ...     C, pool, true, 0.1, 100000);
+*/
+template <typename CSR>
+auto approximate_current_flow_betweenness_centrality(const CSR& G,
+    ThreadPool& pool, bool normalized = true, double epsilon = 0.5,
+    std::size_t kmax = 10000, std::uint64_t seed = 0,
+    LaplacianPreconditioner preconditioner =
+        LaplacianPreconditioner::incomplete_cholesky,
+    double tol = 1.0e-8) -> std::vector<double>
+{
+    const auto L = GroundedLaplacian {G, preconditioner};
+    const auto n = L.number_of_nodes();
+    if (n <= 2)
+    {
+        return std::vector<double>(n, 0.0);
+    }
+    const auto nb = double(n - 1) * double(n - 2);
+    const auto cstar = double(n) * double(n - 1) / nb;
+    const auto k = std::size_t(
+        std::ceil(std::pow(cstar / epsilon, 2) * std::log(double(n))));
+    if (k > kmax)
+    {
+        throw XNetworkError("Number random pairs k>kmax ("
+            + std::to_string(k) + ">" + std::to_string(kmax)
+            + ") Increase kmax or epsilon");
+    }
+    const auto cstar2k = cstar / (2.0 * double(k));
+    const auto& E = L.edges();
+    auto workspaces = std::vector<CurrentFlowWorkspace>(
+        pool.size(), CurrentFlowWorkspace(n));
+    auto partial = std::vector<std::vector<double>>(
+        pool.size(), std::vector<double>(n, 0.0));
+    parallel_for(pool, 0, k, 1, [&](unsigned tid, std::size_t i) {
+        auto& ws = workspaces[tid];
+        auto rng = SplitMix64 {seed ^ (i * 0xd1b54a32d192ed03ULL)};
+        const auto s = std::uint32_t(rng.below(n));
+        auto t = std::uint32_t(rng.below(n - 1));
+        t += t >= s ? 1U : 0U;
+        ws._b[s] = 1.0;
+        ws._b[t] = -1.0;
+        L.solve(ws._b, ws._x, ws._cg, tol);
+        ws._b[s] = ws._b[t] = 0.0;
+        auto& b = partial[tid];
+        for (const auto& e : E)
+        {
+            const auto current =
+                e._conductance * std::abs(ws._x[e._u] - ws._x[e._v]);
+            b[e._u] += e._u != s && e._u != t ? current : 0.0;
+            b[e._v] += e._v != s && e._v != t ? current : 0.0;
+        }
+    });
+    auto betweenness = std::vector<double>(n, 0.0);
+    const auto factor = (normalized ? 1.0 : nb / 2.0) * cstar2k;
+    for (const auto& b : partial)
+    {
+        for (auto v = std::size_t(0); v != n; ++v)
+        {
+            betweenness[v] += b[v] * factor;
+        }
+    }
+    return betweenness;
+}
+
+} // namespace xn
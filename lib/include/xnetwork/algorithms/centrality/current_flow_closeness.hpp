@@ -0,0 +1,241 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native current-flow closeness (information) centrality.
+
+Current-flow closeness of a node v is the inverse of the sum of the
+effective resistances R(v, w) over all nodes w.  With X the inverse of
+the Laplacian grounded at one node,
+
+    sum_w R(v, w) = n X[v][v] + trace(X) - 2 (X 1)[v],
+
+so the exact values take one grounded Laplacian solve per node for the
+diagonal of X, plus one for X 1, run in parallel with O(n) memory per
+thread (see laplacian_solver.hpp).
+
+`approximate_current_flow_closeness_centrality` follows Spielman and
+Srivastava: with B the edge-node incidence matrix, W the conductances and
+Q a random k x m sign matrix scaled by 1 / sqrt(k), the columns z_v of
+Z = Q W^1/2 B L+ satisfy R(v, w) ~ |z_v - z_w|^2 for all pairs at once
+(Johnson-Lindenstrauss), and Z takes only k solves.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <xnetwork/algorithms/centrality/current_flow_betweenness.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/linalg/laplacian_solver.hpp>
+#include <xnetwork/utils/random.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Compute current-flow closeness centrality for nodes.
+
+    Current-flow closeness centrality is a variant of closeness
+    centrality based on effective resistance between nodes in a network.
+    This metric is also known as information centrality.
+
+    Parameters
+    ----------
+    G : CSRGraph of a connected undirected graph, holding both directions
+        of every edge; the weights (or 1) are the conductances
+    pool : ThreadPool
+    preconditioner : preconditioner of the conjugate gradient solves
+    tol : relative residual of the solves
+
+    Returns
+    -------
+    The current-flow closeness of every node, indexed by node.
+
+    Raises
+    ------
+    XNetworkError
+        If G is not connected.
+    XNetworkPointlessConcept
+        If G has no nodes.
+
+    References
+    ----------
+    .. [1] Ulrik Brandes and Daniel Fleischer,
+       Centrality Measures Based on Current Flow.
+       Proc. 22nd Symp. Theoretical Aspects of Computer Science (STACS '05).
+       LNCS 3404, pp. 533-544. Springer-Verlag, 2005.
+    .. [2] Karen Stephenson and Marvin Zelen:
+       Rethinking centrality: Methods and examples.
+       Social Networks 11(1):1-37, 1989.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto cfc = xn::current_flow_closeness_centrality(C, pool);
+*/
+template <typename CSR>
+auto current_flow_closeness_centrality(const CSR& G, ThreadPool& pool,
+    LaplacianPreconditioner preconditioner =
+        LaplacianPreconditioner::incomplete_cholesky,
+    double tol = 1.0e-8) -> std::vector<double>
+{
+    const auto L = GroundedLaplacian {G, preconditioner};
+    const auto n = L.number_of_nodes();
+    auto closeness = std::vector<double>(n, 0.0);
+    if (n == 1)
+    {
+        return closeness;
+    }
+    // task v < n solves for column v of X; task n solves for X 1
+    auto diag = std::vector<double>(n, 0.0);
+    auto row_sums = std::vector<double>(n, 0.0);
+    auto workspaces = std::vector<CurrentFlowWorkspace>(
+        pool.size(), CurrentFlowWorkspace(n));
+    parallel_for(pool, 0, n + 1, 1, [&](unsigned tid, std::size_t v) {
+        auto& ws = workspaces[tid];
+        if (v == n)
+        {
+            auto ones = std::vector<double>(n, 1.0);
+            L.solve(ones, row_sums, ws._cg, tol);
+            return;
+        }
+        ws._b[v] = 1.0;
+        L.solve(ws._b, ws._x, ws._cg, tol);
+        ws._b[v] = 0.0;
+        diag[v] = ws._x[v];
+    });
+    auto trace = 0.0;
+    for (auto d : diag)
+    {
+        trace += d;
+    }
+    for (auto v = std::size_t(0); v != n; ++v)
+    {
+        closeness[v] =
+            1.0 / (double(n) * diag[v] + trace - 2.0 * row_sums[v]);
+    }
+    return closeness;
+}
+
+/*! Information centrality; the same as current-flow closeness. */
+template <typename CSR>
+auto information_centrality(const CSR& G, ThreadPool& pool)
+    -> std::vector<double>
+{
+    return current_flow_closeness_centrality(G, pool);
+}
+
+/*! Compute the approximate current-flow closeness centrality for nodes.
+
+    Parameters
+    ----------
+    G : CSRGraph of a connected undirected graph, holding both directions
+        of every edge; the weights (or 1) are the conductances
+    pool : ThreadPool
+    epsilon : relative error of the effective resistances, in (0, 1)
+    seed : seed of the random projections; the result does not depend on
+        the number of threads, up to rounding
+    preconditioner : preconditioner of the conjugate gradient solves
+    tol : relative residual of the solves
+
+    Returns
+    -------
+    The estimated current-flow closeness of every node, indexed by node.
+
+    Raises
+    ------
+    XNetworkError
+        If G is not connected, or if epsilon is not in (0, 1).
+    XNetworkPointlessConcept
+        If G has no nodes.
+
+    Notes
+    -----
+    k = ceil(4 ln n / (epsilon^2 / 2 - epsilon^3 / 3)) random projections
+    keep every effective resistance, and hence every sum of them, within
+    a factor 1 +- epsilon with high probability.  Each projection costs
+    one Laplacian solve; the memory is O(n) per thread.
+
+    References
+    ----------
+    .. [1] Daniel A. Spielman and Nikhil Srivastava,
+       Graph Sparsification by Effective Resistances.
+       SIAM Journal on Computing 40(6):1913-1926, 2011.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto cfc = xn::approximate_current_flow_closeness_centrality(
+    ...     C, pool, 0.2);
+*/
+template <typename CSR>
+auto approximate_current_flow_closeness_centrality(const CSR& G,
+    ThreadPool& pool, double epsilon = 0.5, std::uint64_t seed = 0,
+    LaplacianPreconditioner preconditioner =
+        LaplacianPreconditioner::incomplete_cholesky,
+    double tol = 1.0e-8) -> std::vector<double>
+{
+    if (!(epsilon > 0.0 && epsilon < 1.0))
+    {
+        throw XNetworkError("epsilon must be in (0, 1)");
+    }
+    const auto L = GroundedLaplacian {G, preconditioner};
+    const auto n = L.number_of_nodes();
+    auto closeness = std::vector<double>(n, 0.0);
+    if (n == 1)
+    {
+        return closeness;
+    }
+    const auto k = std::size_t(std::ceil(4.0 * std::log(double(n))
+        / (epsilon * epsilon / 2.0 - epsilon * epsilon * epsilon / 3.0)));
+    const auto& E = L.edges();
+    auto workspaces = std::vector<CurrentFlowWorkspace>(
+        pool.size(), CurrentFlowWorkspace(n));
+    auto partial = std::vector<std::vector<double>>(
+        pool.size(), std::vector<double>(n, 0.0));
+    parallel_for(pool, 0, k, 1, [&](unsigned tid, std::size_t j) {
+        auto& ws = workspaces[tid];
+        auto rng = SplitMix64 {seed ^ (j * 0xd1b54a32d192ed03ULL)};
+        // row j of Q W^1/2 B, transposed: a random +-sqrt(c) per edge
+        for (const auto& e : E)
+        {
+            const auto q = (rng() >> 63U) != 0U ? std::sqrt(e._conductance)
+                                                : -std::sqrt(e._conductance);
+            ws._b[e._u] += q;
+            ws._b[e._v] -= q;
+        }
+        L.solve(ws._b, ws._x, ws._cg, tol);
+        std::fill(ws._b.begin(), ws._b.end(), 0.0);
+        // sum_w (z_v - z_w)^2 = n z_v^2 - 2 z_v sum(z) + sum(z^2)
+        auto sum = 0.0;
+        auto squares = 0.0;
+        for (auto z : ws._x)
+        {
+            sum += z;
+            squares += z * z;
+        }
+        auto& r = partial[tid];
+        for (auto v = std::size_t(0); v != n; ++v)
+        {
+            const auto z = ws._x[v];
+            r[v] += double(n) * z * z - 2.0 * z * sum + squares;
+        }
+    });
+    auto resistance = std::vector<double>(n, 0.0);
+    for (const auto& r : partial)
+    {
+        for (auto v = std::size_t(0); v != n; ++v)
+        {
+            resistance[v] += r[v];
+        }
+    }
+    for (auto v = std::size_t(0); v != n; ++v)
+    {
+        closeness[v] = double(k) / resistance[v];
+    }
+    return closeness;
+}
+
+} // namespace xn
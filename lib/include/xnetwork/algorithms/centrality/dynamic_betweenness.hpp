@@ -0,0 +1,371 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Betweenness centrality maintained under edge insertions.
+
+Betweenness is a sum of per-source dependencies.  Inserting an arc
+(u, v) of weight w leaves the shortest-path DAG of a source s, and with
+it the dependencies of s, unchanged unless
+
+    d(s, u) + w <= d(s, v),
+
+that is, unless the new arc is on a shortest path from s (the distances
+change if the inequality is strict, only the path counts if it is an
+equality).  The distances d(., u) and d(., v) to the ends of the arc, for
+all sources at once, come from two searches on the reversed graph.  An
+update then subtracts the dependencies of the affected sources, computed
+on the old graph, inserts the arcs and adds the dependencies of the same
+sources on the new graph, so its cost is two Brandes passes per affected
+source instead of one per node.
+
+A batch of insertions is tested against the distances of the graph
+before the batch: a source that none of the earlier arcs of the batch
+affects keeps its distances, so the test of a later arc stays exact for
+it.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/centrality/betweenness.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Shortest-path betweenness of a graph that gains edges.
+
+    Parameters
+    ----------
+    G : CSRGraph (both directions of every edge for an undirected graph);
+        searched with Dijkstra if it has weights and with BFS otherwise
+    pool : ThreadPool; it must outlive the object
+    directed : whether G is directed
+
+    Notes
+    -----
+    Inserting an arc that is already there is a no-op, unless the new
+    weight is smaller: the weight then decreases, which is handled like
+    an insertion.  The sums are updated by differences, so rounding
+    errors slowly build up; `recompute` starts afresh.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto db = xn::DynamicBetweenness<int> {xn::to_csr_graph(G), pool,
+    ...     false};
+    >>> G.add_edge(3, 7);
+    >>> db.update(3, 7);  // the number of sources recomputed
+    >>> auto bc = db.betweenness();
+*/
+template <typename Weight = int>
+class DynamicBetweenness
+{
+  public:
+    using graph_t = CSRGraph<Weight>;
+    using node_t = std::uint32_t;
+    using edge_t = std::pair<node_t, node_t>;
+
+    graph_t _G;
+    graph_t _GT; // reversed arcs; empty if undirected
+    ThreadPool& _pool;
+    bool _directed;
+    std::vector<double> _sums; // unscaled sums over all sources
+
+    DynamicBetweenness(graph_t G, ThreadPool& pool, bool directed)
+        : _G {std::move(G)}
+        , _pool {pool}
+        , _directed {directed}
+    {
+        if (directed)
+        {
+            this->_GT = this->_G.transpose();
+        }
+        this->recompute();
+    }
+
+    [[nodiscard]] auto graph() const -> const graph_t&
+    {
+        return this->_G;
+    }
+
+    /*! Return the betweenness of every node, scaled as
+        `betweenness_centrality` does. */
+    [[nodiscard]] auto betweenness(bool normalized = true) const
+        -> std::vector<double>
+    {
+        const auto n = this->_G.number_of_nodes();
+        auto b = this->_sums;
+        _rescale_betweenness(b, n, n, normalized, this->_directed, false);
+        return b;
+    }
+
+    /*! Recompute the sums from all sources. */
+    void recompute()
+    {
+        const auto n = this->_G.number_of_nodes();
+        this->_sums =
+            _brandes(this->_G, this->_pool, _all_nodes(n), false, false);
+    }
+
+    /*! Insert the edge (u, v) and update the betweenness.
+
+        Parameters
+        ----------
+        u, v : nodes of the graph
+        weight : weight of the edge; ignored if the graph is unweighted
+
+        Returns
+        -------
+        The number of sources whose dependencies were recomputed.
+
+        Raises
+        ------
+        NodeNotFound
+            If u or v is not a node of the graph.
+    */
+    auto update(node_t u, node_t v, Weight weight = Weight(1))
+        -> std::size_t
+    {
+        return this->insert_edges(
+            std::vector<edge_t> {{u, v}}, std::vector<Weight> {weight});
+    }
+
+    /*! Insert a batch of edges and update the betweenness.
+
+        Parameters
+        ----------
+        edges : (u, v) pairs; one direction per edge of an undirected graph
+        weights : weights parallel to `edges`, or empty for unit weights
+
+        Returns
+        -------
+        The number of sources whose dependencies were recomputed.
+
+        Raises
+        ------
+        NodeNotFound
+            If an end of an edge is not a node of the graph.
+        XNetworkError
+            If weights is neither empty nor as long as edges.
+    */
+    auto insert_edges(const std::vector<edge_t>& edges,
+        const std::vector<Weight>& weights = {}) -> std::size_t
+    {
+        const auto n = this->_G.number_of_nodes();
+        if (!weights.empty() && weights.size() != edges.size())
+        {
+            throw XNetworkError("weights and edges differ in length");
+        }
+        auto changes = std::vector<std::pair<edge_t, Weight>> {};
+        for (auto i = std::size_t(0); i != edges.size(); ++i)
+        {
+            const auto [u, v] = edges[i];
+            if (u >= n || v >= n)
+            {
+                throw NodeNotFound("node " + std::to_string(u >= n ? u : v)
+                    + " is not in the graph");
+            }
+            const auto w = this->_G.is_weighted() && !weights.empty()
+                ? weights[i]
+                : Weight(1);
+            if (u != v && this->_lowers_arc(u, v, w))
+            {
+                changes.emplace_back(edges[i], w);
+            }
+        }
+        if (changes.empty())
+        {
+            return 0;
+        }
+        const auto sources = this->_affected_sources(changes);
+        this->_add_sums(sources, -1.0);
+        this->_apply(changes);
+        this->_add_sums(sources, 1.0);
+        return sources.size();
+    }
+
+  private:
+    /*! Whether an arc u -> v of weight w would be new or lighter. */
+    [[nodiscard]] auto _lowers_arc(node_t u, node_t v, Weight w) const
+        -> bool
+    {
+        for (auto e = this->_G.edge_begin(u); e != this->_G.edge_end(u); ++e)
+        {
+            if (this->_G.target(e) == v && !(w < this->_G.weight(e)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*! Return the sources whose shortest-path DAG one of the arcs joins. */
+    auto _affected_sources(
+        const std::vector<std::pair<edge_t, Weight>>& changes)
+        -> std::vector<node_t>
+    {
+        using WS = BrandesWorkspace<Weight>;
+        const auto n = this->_G.number_of_nodes();
+        const auto& R = this->_directed ? this->_GT : this->_G;
+        // task 2i searches to u_i, task 2i + 1 to v_i
+        auto dist = std::vector<std::vector<Weight>>(2 * changes.size());
+        auto workspaces = std::vector<WS> {};
+        workspaces.reserve(this->_pool.size());
+        for (auto t = 0U; t != this->_pool.size(); ++t)
+        {
+            workspaces.emplace_back(n);
+        }
+        parallel_for(this->_pool, 0, dist.size(), 1,
+            [&](unsigned tid, std::size_t i) {
+                auto& ws = workspaces[tid];
+                const auto& arc = changes[i / 2].first;
+                const auto x = i % 2 == 0 ? arc.first : arc.second;
+                if (R.is_weighted())
+                {
+                    _brandes_dijkstra(R, x, ws);
+                }
+                else
+                {
+                    _brandes_bfs(R, x, ws);
+                }
+                dist[i] = ws._dist;
+            });
+        const auto inf = WS::infinity();
+        auto joins = [&](Weight a, Weight b, Weight w) {
+            return a != inf && (b == inf || !(b < Weight(a + w)));
+        };
+        auto sources = std::vector<node_t> {};
+        for (auto s = node_t(0); s != n; ++s)
+        {
+            auto affected = false;
+            for (auto i = std::size_t(0); !affected && i != changes.size();
+                 ++i)
+            {
+                const auto du = dist[2 * i][s];
+                const auto dv = dist[2 * i + 1][s];
+                const auto w = changes[i].second;
+                affected = joins(du, dv, w)
+                    || (!this->_directed && joins(dv, du, w));
+            }
+            if (affected)
+            {
+                sources.push_back(s);
+            }
+        }
+        return sources;
+    }
+
+    /*! Add `sign` times the dependencies of `sources` to the sums. */
+    void _add_sums(const std::vector<node_t>& sources, double sign)
+    {
+        if (sources.empty())
+        {
+            return;
+        }
+        const auto part =
+            _brandes(this->_G, this->_pool, sources, false, false);
+        for (auto i = std::size_t(0); i != part.size(); ++i)
+        {
+            this->_sums[i] += sign * part[i];
+        }
+    }
+
+    /*! Insert the arcs, or lower their weights, in G and its reverse. */
+    void _apply(const std::vector<std::pair<edge_t, Weight>>& changes)
+    {
+        auto arcs = std::vector<std::pair<edge_t, Weight>> {};
+        for (const auto& [arc, w] : changes)
+        {
+            arcs.emplace_back(arc, w);
+            if (!this->_directed)
+            {
+                arcs.push_back({{arc.second, arc.first}, w});
+            }
+        }
+        this->_G = _with_arcs(this->_G, arcs, false);
+        if (this->_directed)
+        {
+            this->_GT = _with_arcs(this->_GT, arcs, true);
+        }
+    }
+
+    /*! Return a copy of C with the arcs inserted or lowered. */
+    static auto _with_arcs(const graph_t& C,
+        const std::vector<std::pair<edge_t, Weight>>& arcs, bool reversed)
+        -> graph_t
+    {
+        const auto n = C.number_of_nodes();
+        auto G = C;
+        auto extra = std::vector<std::vector<std::pair<node_t, Weight>>>(n);
+        auto added = std::size_t(0);
+        for (auto [arc, w] : arcs)
+        {
+            const auto [u, v] =
+                reversed ? edge_t {arc.second, arc.first} : arc;
+            auto found = false;
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                if (G.target(e) == v)
+                {
+                    found = true;
+                    if (G.is_weighted() && w < G._weights[e])
+                    {
+                        G._weights[e] = w;
+                    }
+                }
+            }
+            for (auto& [x, wx] : extra[u])
+            {
+                if (x == v)
+                {
+                    found = true;
+                    wx = std::min(wx, w);
+                }
+            }
+            if (!found)
+            {
+                extra[u].emplace_back(v, w);
+                ++added;
+            }
+        }
+        if (added == 0)
+        {
+            return G;
+        }
+        auto offsets = std::vector<std::size_t>(n + 1, 0);
+        auto targets = std::vector<node_t> {};
+        auto weights = std::vector<Weight> {};
+        targets.reserve(G.number_of_edges() + added);
+        for (auto u = node_t(0); u != n; ++u)
+        {
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                targets.push_back(G.target(e));
+                if (G.is_weighted())
+                {
+                    weights.push_back(G._weights[e]);
+                }
+            }
+            for (const auto& [v, w] : extra[u])
+            {
+                targets.push_back(v);
+                if (G.is_weighted())
+                {
+                    weights.push_back(w);
+                }
+            }
+            offsets[u + 1] = targets.size();
+        }
+        return graph_t {
+            std::move(offsets), std::move(targets), std::move(weights)};
+    }
+};
+
+} // namespace xn
@@ -0,0 +1,100 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native harmonic centrality of unweighted graphs.
+
+The searches are those of closeness.hpp: batches of 64 sources for all
+nodes, and searches pruned by an upper bound for the top k.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/centrality/closeness.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Compute the harmonic centrality of all nodes.
+
+    Harmonic centrality of a node u is the sum of `1 / d(v, u)` over the
+    nodes v != u; unreachable nodes add nothing.
+
+    Parameters
+    ----------
+    G : CSRGraph without weights (both directions of every edge for an
+        undirected graph)
+    pool : ThreadPool
+    directed : whether G is directed; the distances are then taken from
+        the other nodes to a node, as in XNetwork
+
+    Returns
+    -------
+    The harmonic centrality of every node, indexed by node.
+
+    Raises
+    ------
+    XNetworkNotImplemented
+        If G has weights.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto hc = xn::harmonic_centrality(C, pool, false);
+*/
+template <typename CSR>
+auto harmonic_centrality(const CSR& G, ThreadPool& pool, bool directed)
+    -> std::vector<double>
+{
+    _require_unweighted(G);
+    const auto GT = directed ? G.transpose() : CSR {};
+    return _distance_sums(directed ? GT : G, pool)._harmonic;
+}
+
+/*! Find the k nodes of highest harmonic centrality.
+
+    Parameters
+    ----------
+    G : CSRGraph without weights (both directions of every edge for an
+        undirected graph)
+    pool : ThreadPool
+    directed : whether G is directed
+    k : number of nodes
+
+    Returns
+    -------
+    Pairs (node, harmonic centrality) by decreasing value.  Nodes tied
+    with the k-th value may be swapped for one another.
+
+    Raises
+    ------
+    XNetworkNotImplemented
+        If G has weights.
+
+    Notes
+    -----
+    See `top_k_closeness_centrality`; the bound puts as many unseen nodes
+    as there are arcs left at distance `level + 1` and all others at
+    `level + 2`.
+*/
+template <typename CSR>
+auto top_k_harmonic_centrality(const CSR& G, ThreadPool& pool,
+    bool directed, std::size_t k)
+    -> std::vector<std::pair<std::uint32_t, double>>
+{
+    _require_unweighted(G);
+    const auto GT = directed ? G.transpose() : CSR {};
+    const auto& R = directed ? GT : G;
+    return _top_k_bfs(R, pool, directed, k, [](const BFSLevelBound& b) {
+        const auto rest = b._reach - b._visited;
+        const auto near = std::min(b._next, rest);
+        return b._harmonic + double(near) / (b._level + 1.0)
+            + double(rest - near) / (b._level + 2.0);
+    });
+}
+
+} // namespace xn
@@ -0,0 +1,145 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native Katz centrality on the SpMV engine of linalg/spmv.hpp.
+*/
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/linalg/spmv.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Iterate `x = alpha A^T x + beta(i)`; see `katz_centrality`. */
+template <typename CSR, typename Beta>
+auto _katz(const CSR& G, ThreadPool& pool, double alpha, Beta&& beta,
+    std::size_t max_iter, double tol, const std::vector<double>& nstart,
+    bool normalized) -> PowerIterationResult
+{
+    const auto n = G.number_of_nodes();
+    if (n == 0)
+    {
+        return PowerIterationResult {};
+    }
+    if (!nstart.empty() && nstart.size() != n)
+    {
+        throw XNetworkError("nstart must have a value for every node");
+    }
+    auto x = nstart.empty() ? std::vector<double>(n, 0.0) : nstart;
+    auto y = std::vector<double>(n);
+    const auto AT = G.transpose();
+    auto op = SpMV<CSR> {AT, pool};
+    for (auto it = std::size_t(1); it <= max_iter; ++it)
+    {
+        const auto change = op.map_rows(x, y, [&](std::size_t i, double ax) {
+            const auto yi = alpha * ax + beta(i);
+            return std::pair<double, double> {yi, std::abs(yi - x[i])};
+        });
+        x.swap(y);
+        if (change < double(n) * tol)
+        {
+            if (normalized)
+            {
+                const auto squares = op.for_each_part(
+                    [&](std::size_t first, std::size_t last) {
+                        auto sum = 0.0;
+                        for (auto i = first; i != last; ++i)
+                        {
+                            sum += x[i] * x[i];
+                        }
+                        return sum;
+                    });
+                const auto s = squares > 0.0 ? 1.0 / std::sqrt(squares) : 1.0;
+                for (auto& v : x)
+                {
+                    v *= s;
+                }
+            }
+            return PowerIterationResult {std::move(x), it, change};
+        }
+    }
+    throw PowerIterationFailedConvergence(max_iter);
+}
+
+/*! Compute the Katz centrality of all nodes.
+
+    The Katz centrality of node i is `x_i = alpha sum_j A_ji x_j + beta`,
+    summed over the arcs into i.
+
+    Parameters
+    ----------
+    G : CSRGraph; the weights are used if it has any
+    pool : ThreadPool
+    alpha : attenuation factor, below `1 / lambda_max` (default: 0.1)
+    beta : weight attributed to the immediate neighborhood (default: 1.0)
+    max_iter : maximum number of iterations (default: 1000)
+    tol : the iteration stops when the L1 change of the vector is below
+        `n * tol` (default: 1.0e-6)
+    nstart : starting vector, for example the result before a change of
+        the graph (default: all zeros)
+    normalized : scale the result to unit L2 norm (default: true)
+
+    Returns
+    -------
+    A PowerIterationResult: the centrality of every node, the number of
+    iterations and the last L1 change.
+
+    Raises
+    ------
+    XNetworkError
+        If nstart has the wrong size.
+    PowerIterationFailedConvergence
+        If the iteration does not converge within max_iter iterations.
+
+    Notes
+    -----
+    Every iteration is a single parallel pass over the arcs.  When
+    warm-starting from a normalized result, pass `normalized=false` the
+    first time, or scale nstart back, since the iteration converges to
+    the unnormalized vector.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto r = xn::katz_centrality(xn::to_csr_graph(G), pool, 0.05);
+*/
+template <typename CSR>
+auto katz_centrality(const CSR& G, ThreadPool& pool, double alpha = 0.1,
+    double beta = 1.0, std::size_t max_iter = 1000, double tol = 1.0e-6,
+    const std::vector<double>& nstart = {}, bool normalized = true)
+    -> PowerIterationResult
+{
+    return _katz(
+        G, pool, alpha, [beta](std::size_t) { return beta; }, max_iter, tol,
+        nstart, normalized);
+}
+
+/*! Compute the Katz centrality of all nodes with one beta per node.
+
+    Raises
+    ------
+    XNetworkError
+        If beta or nstart does not have a value for every node.
+*/
+template <typename CSR>
+auto katz_centrality(const CSR& G, ThreadPool& pool, double alpha,
+    const std::vector<double>& beta, std::size_t max_iter = 1000,
+    double tol = 1.0e-6, const std::vector<double>& nstart = {},
+    bool normalized = true) -> PowerIterationResult
+{
+    if (beta.size() != G.number_of_nodes())
+    {
+        throw XNetworkError("beta vector must have a value for every node");
+    }
+    return _katz(
+        G, pool, alpha, [&beta](std::size_t i) { return beta[i]; }, max_iter,
+        tol, nstart, normalized);
+}
+
+} // namespace xn
@@ -0,0 +1,312 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native connected components by Afforest (Sutton, Ben-Nun and Barak,
+2018).
+
+Every node starts as its own tree in a parent array.  Linking an edge
+hooks the root with the larger number under the other root by a
+compare-and-swap, so the threads link edges concurrently without locks,
+and compressing makes every node point at its root (Shiloach-Vishkin
+hook and compress, without label propagation).  Afforest links only the
+first few arcs of every node, which already joins most of the giant
+component, then finds that component by sampling the parent array and
+skips its nodes in the final pass over the remaining arcs.  On graphs
+with a giant component, most arcs are never looked at.
+
+A root is never hooked under a larger node, so the root of a tree is the
+smallest node of its component; the components are numbered in the order
+of their smallest nodes, whatever the number of threads.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/random.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Flat labeling of the nodes by component. */
+struct ComponentsResult
+{
+    using node_t = std::uint32_t;
+
+    std::vector<node_t> _labels;     // component of every node
+    std::vector<std::size_t> _sizes; // number of nodes of every component
+
+    [[nodiscard]] auto number_of_components() const -> std::size_t
+    {
+        return this->_sizes.size();
+    }
+};
+
+/*! The parent array of Afforest, shared by the threads. */
+using AfforestParents = std::vector<std::atomic<std::uint32_t>>;
+
+/*! Join the trees of u and v in the parent array `comp`. */
+inline void _afforest_link(
+    AfforestParents& comp, std::uint32_t u, std::uint32_t v)
+{
+    auto load = [&](std::uint32_t x) {
+        return comp[x].load(std::memory_order_relaxed);
+    };
+    auto p1 = load(u);
+    auto p2 = load(v);
+    while (p1 != p2)
+    {
+        const auto high = p1 > p2 ? p1 : p2;
+        const auto low = p1 > p2 ? p2 : p1;
+        auto p_high = load(high);
+        if (p_high == low
+            || (p_high == high
+                && comp[high].compare_exchange_strong(
+                    p_high, low, std::memory_order_relaxed)))
+        {
+            break;
+        }
+        p1 = load(load(high));
+        p2 = load(low);
+    }
+}
+
+/*! Make every node of `comp` point at the root of its tree. */
+inline void _afforest_compress(AfforestParents& comp, ThreadPool& pool)
+{
+    parallel_for(pool, 0, comp.size(), 4096, [&](unsigned, std::size_t v) {
+        auto load = [&](std::uint32_t x) {
+            return comp[x].load(std::memory_order_relaxed);
+        };
+        auto p = load(std::uint32_t(v));
+        for (auto gp = load(p); p != gp; gp = load(p))
+        {
+            p = gp;
+            comp[v].store(p, std::memory_order_relaxed);
+        }
+    });
+}
+
+/*! Return the most frequent root among `num_samples` random nodes. */
+inline auto _afforest_sample_frequent(const AfforestParents& comp,
+    std::size_t num_samples, std::uint64_t seed) -> std::uint32_t
+{
+    auto rng = SplitMix64 {seed};
+    auto samples = std::vector<std::uint32_t>(num_samples);
+    for (auto& c : samples)
+    {
+        c = comp[rng.below(comp.size())].load(std::memory_order_relaxed);
+    }
+    std::sort(samples.begin(), samples.end());
+    auto best = samples[0];
+    auto best_count = std::size_t(0);
+    for (auto i = std::size_t(0); i != samples.size();)
+    {
+        auto j = i;
+        while (j != samples.size() && samples[j] == samples[i])
+        {
+            ++j;
+        }
+        if (j - i > best_count)
+        {
+            best = samples[i];
+            best_count = j - i;
+        }
+        i = j;
+    }
+    return best;
+}
+
+/*! Return the root of the component of every node (its smallest node).
+
+    Parameters
+    ----------
+    G : CSRGraph with both directions of every edge
+    pool : ThreadPool
+    neighbor_rounds : number of arcs per node linked before sampling
+        (default: 2)
+*/
+template <typename CSR>
+auto _afforest(const CSR& G, ThreadPool& pool, std::size_t neighbor_rounds)
+    -> std::vector<std::uint32_t>
+{
+    const auto n = G.number_of_nodes();
+    auto roots = std::vector<std::uint32_t>(n);
+    if (n == 0)
+    {
+        return roots;
+    }
+    auto comp = AfforestParents(n);
+    for (auto v = std::size_t(0); v != n; ++v)
+    {
+        comp[v].store(std::uint32_t(v), std::memory_order_relaxed);
+    }
+    for (auto r = std::size_t(0); r != neighbor_rounds; ++r)
+    {
+        parallel_for(pool, 0, n, 1024, [&](unsigned, std::size_t u) {
+            const auto e = G.edge_begin(std::uint32_t(u)) + r;
+            if (e < G.edge_end(std::uint32_t(u)))
+            {
+                _afforest_link(comp, std::uint32_t(u), G.target(e));
+            }
+        });
+        _afforest_compress(comp, pool);
+    }
+    // every arc of the giant component is linked from its other end too,
+    // so its own nodes can skip their remaining arcs
+    const auto c = _afforest_sample_frequent(comp, 1024, 0x5eed);
+    parallel_for(pool, 0, n, 256, [&](unsigned, std::size_t u) {
+        if (comp[u].load(std::memory_order_relaxed) == c)
+        {
+            return;
+        }
+        const auto v = std::uint32_t(u);
+        for (auto e = G.edge_begin(v) + neighbor_rounds; e < G.edge_end(v);
+             ++e)
+        {
+            _afforest_link(comp, v, G.target(e));
+        }
+    });
+    _afforest_compress(comp, pool);
+    parallel_for(pool, 0, n, 4096, [&](unsigned, std::size_t v) {
+        roots[v] = comp[v].load(std::memory_order_relaxed);
+    });
+    return roots;
+}
+
+/*! Return the connected components of the graph.
+
+    Parameters
+    ----------
+    G : CSRGraph with both directions of every edge (an undirected graph,
+        or the arcs of a digraph in both directions for its weakly
+        connected components)
+    pool : ThreadPool
+    neighbor_rounds : number of arcs per node linked before the giant
+        component is sampled (default: 2)
+
+    Returns
+    -------
+    A ComponentsResult: the component of every node, the components
+    numbered from 0 in the order of their smallest nodes, and the size of
+    every component.
+
+    Notes
+    -----
+    The work is O(n + m) and the memory one node per node besides the
+    result.  With one arc of an edge missing, two nodes may be reported
+    in different components although they are joined.
+
+    References
+    ----------
+    .. [1] M. Sutton, T. Ben-Nun and A. Barak,
+       "Optimizing Parallel Graph Connectivity Computation via Subgraph
+       Sampling", IPDPS 2018.
+    .. [2] Y. Shiloach and U. Vishkin,
+       "An O(log n) Parallel Connectivity Algorithm",
+       Journal of Algorithms 3 (1): 57-67, 1982.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto C = xn::to_csr_graph(G);  // G a SimpleGraph
+    >>> auto cc = xn::connected_components(C, pool);
+    >>> cc._labels[v];  // the component of v
+    >>> cc._sizes[cc._labels[v]];  // and its size
+*/
+template <typename CSR>
+auto connected_components(const CSR& G, ThreadPool& pool,
+    std::size_t neighbor_rounds = 2) -> ComponentsResult
+{
+    const auto n = G.number_of_nodes();
+    auto comp = _afforest(G, pool, neighbor_rounds);
+    auto result = ComponentsResult {};
+    auto& ids = result._labels;
+    ids.assign(n, 0);
+    for (auto v = std::size_t(0); v != n; ++v)
+    {
+        if (comp[v] == v)
+        {
+            ids[v] = std::uint32_t(result._sizes.size());
+            result._sizes.push_back(0);
+        }
+    }
+    parallel_for(pool, 0, n, 4096,
+        [&](unsigned, std::size_t v) { comp[v] = ids[comp[v]]; });
+    for (auto c : comp)
+    {
+        ++result._sizes[c];
+    }
+    ids.swap(comp);
+    return result;
+}
+
+/*! Return the number of connected components.  See
+    `connected_components`. */
+template <typename CSR>
+auto number_connected_components(const CSR& G, ThreadPool& pool)
+    -> std::size_t
+{
+    const auto comp = _afforest(G, pool, 2);
+    auto count = std::size_t(0);
+    for (auto v = std::size_t(0); v != comp.size(); ++v)
+    {
+        count += comp[v] == v ? 1 : 0;
+    }
+    return count;
+}
+
+/*! Return whether the graph is connected.
+
+    Raises
+    ------
+    XNetworkPointlessConcept
+        If G has no nodes.
+*/
+template <typename CSR>
+auto is_connected(const CSR& G, ThreadPool& pool) -> bool
+{
+    if (G.number_of_nodes() == 0)
+    {
+        throw XNetworkPointlessConcept(
+            "Connectivity is undefined for the null graph.");
+    }
+    return number_connected_components(G, pool) == 1;
+}
+
+/*! Return the nodes of the component of `source`, in increasing order.
+
+    Raises
+    ------
+    NodeNotFound
+        If source is not a node of the graph.
+*/
+template <typename CSR>
+auto node_connected_component(const CSR& G, ThreadPool& pool,
+    std::uint32_t source) -> std::vector<std::uint32_t>
+{
+    const auto n = G.number_of_nodes();
+    if (source >= n)
+    {
+        throw NodeNotFound(
+            "node " + std::to_string(source) + " is not in the graph");
+    }
+    const auto comp = _afforest(G, pool, 2);
+    auto nodes = std::vector<std::uint32_t> {};
+    for (auto v = std::uint32_t(0); v != n; ++v)
+    {
+        if (comp[v] == comp[source])
+        {
+            nodes.push_back(v);
+        }
+    }
+    return nodes;
+}
+
+} // namespace xn
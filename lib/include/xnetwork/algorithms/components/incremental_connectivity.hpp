@@ -0,0 +1,146 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Connectivity of a graph that gains edges, on the native `UnionFind`.
+
+Every edge added through the object is added to the graph and unites
+the sets of its ends, so `connected(u, v)` and the number of components
+are answered in near-constant time instead of by a search of the whole
+graph after every change.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/union_find.hpp>
+
+namespace xn
+{
+
+/*! Connected components of a graph under edge insertions.
+
+    Parameters
+    ----------
+    G : graph with consecutive integer nodes `0 .. n-1` whose `G[u]`
+        iterates over the neighbors of u (`SimpleGraph`, `SimpleDiGraphS`);
+        it must outlive the object and gain edges only through it.  The
+        components of a digraph are its weakly connected components.
+
+    Examples
+    --------
+    >>> auto G = xn::SimpleGraph {4};
+    >>> auto cc = xn::IncrementalConnectivity<xn::SimpleGraph> {G};
+    >>> cc.add_edge(0, 1);  // true: two components were joined
+    >>> cc.add_edge(1, 0);  // false
+    >>> cc.connected(0, 1), cc.number_connected_components();
+    (true, 3)
+*/
+template <typename Graph>
+class IncrementalConnectivity
+{
+  public:
+    using node_t = std::uint32_t;
+    using Node = typename Graph::Node;
+
+    Graph& _G;
+    UnionFind _sets;
+
+    explicit IncrementalConnectivity(Graph& G)
+        : _G {G}
+        , _sets {std::size_t(G.number_of_nodes())}
+    {
+        const auto& CG = G;
+        for (auto u = node_t(0); u != this->_sets.size(); ++u)
+        {
+            for (auto&& v : CG[Node(u)])
+            {
+                this->_sets.unite(u, node_t(v));
+            }
+        }
+    }
+
+    [[nodiscard]] auto graph() const -> const Graph&
+    {
+        return this->_G;
+    }
+
+    /*! Add the edge (u, v) to the graph.
+
+        Returns
+        -------
+        Whether the edge joined two components.
+
+        Raises
+        ------
+        NodeNotFound
+            If u or v is not a node of the graph; the graph is unchanged.
+    */
+    auto add_edge(node_t u, node_t v) -> bool
+    {
+        this->_check(u);
+        this->_check(v);
+        this->_G.add_edge(Node(u), Node(v));
+        return this->_sets.unite(u, v);
+    }
+
+    /*! Add a batch of edges; return the number of components joined. */
+    auto add_edges_from(const std::vector<std::pair<node_t, node_t>>& edges)
+        -> std::size_t
+    {
+        for (const auto& [u, v] : edges)
+        {
+            this->_check(u);
+            this->_check(v);
+        }
+        auto joined = std::size_t(0);
+        for (const auto& [u, v] : edges)
+        {
+            this->_G.add_edge(Node(u), Node(v));
+            joined += this->_sets.unite(u, v) ? 1 : 0;
+        }
+        return joined;
+    }
+
+    /*! Return whether u and v are in the same component. */
+    auto connected(node_t u, node_t v) -> bool
+    {
+        this->_check(u);
+        this->_check(v);
+        return this->_sets.connected(u, v);
+    }
+
+    [[nodiscard]] auto number_connected_components() const -> std::size_t
+    {
+        return this->_sets.number_of_sets();
+    }
+
+    /*! Return the number of nodes of the component of u. */
+    auto component_size(node_t u) -> std::size_t
+    {
+        this->_check(u);
+        return this->_sets.set_size(u);
+    }
+
+    /*! Return the components, each in increasing order, ordered by their
+        smallest nodes. */
+    auto components() -> std::vector<std::vector<node_t>>
+    {
+        return this->_sets.to_sets();
+    }
+
+  private:
+    void _check(node_t u) const
+    {
+        if (u >= this->_sets.size())
+        {
+            throw NodeNotFound(
+                "node " + std::to_string(u) + " is not in the graph");
+        }
+    }
+};
+
+} // namespace xn
@@ -0,0 +1,581 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native strongly connected components.
+
+`strongly_connected_components` is Pearce's variant of Tarjan's
+algorithm (Pearce, 2016): one array `rindex` holds the DFS index of a
+node while it is open and the index of its component once it is done,
+and the DFS runs on an explicit stack of (node, next arc) frames, so a
+path of millions of nodes does not overflow the call stack.
+
+`parallel_strongly_connected_components` follows Method 2 of Hong,
+Rodia and Olukotun (2013):
+
+1. trim: nodes without an arc in or out of the remaining graph are
+   components of their own, in parallel rounds;
+2. forward-backward: the nodes both reachable from and reaching a pivot
+   of large degree form its component (the giant one of most real
+   graphs), found by two parallel BFS; the rest splits into the nodes
+   only reached forwards, those only reached backwards and the others,
+   and no component crosses these sets;
+3. trim again, then split what is left into weakly connected pieces with
+   `ConcurrentUnionFind` and run Pearce's algorithm on the pieces in
+   parallel, one piece per task.
+
+Both number the components in the order of their smallest nodes, so
+they return the same labels, whatever the number of threads.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/components/connected.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+#include <xnetwork/utils/union_find.hpp>
+
+namespace xn
+{
+
+/*! Iterative DFS state of Pearce's algorithm, reusable across calls.
+
+    Several instances may share the `rindex` and `rep` arrays as long as
+    they search disjoint sets of nodes.
+*/
+class PearceSCC
+{
+  public:
+    using node_t = std::uint32_t;
+
+    static constexpr node_t none = std::numeric_limits<node_t>::max();
+
+    struct Frame
+    {
+        node_t _v;
+        std::size_t _e; // next arc of v
+        bool _root;
+    };
+
+    std::vector<Frame> _frames;
+    std::vector<node_t> _stack; // nodes of open components
+    node_t _index = 1;          // next DFS index; 0 marks unvisited
+    node_t _c = none - 1;       // next component index, counting down
+
+    /*! Find the components of the nodes reachable from s through the
+        nodes for which `allowed` holds, unless s is already visited.
+        Every node w found gets `rep[w]`, the root of its component.  */
+    template <typename CSR, typename Allowed>
+    void visit(const CSR& G, node_t s, std::vector<node_t>& rindex,
+        std::vector<node_t>& rep, Allowed&& allowed)
+    {
+        if (rindex[s] != 0)
+        {
+            return;
+        }
+        rindex[s] = this->_index++;
+        this->_frames.push_back(Frame {s, G.edge_begin(s), true});
+        while (!this->_frames.empty())
+        {
+            auto& f = this->_frames.back();
+            if (f._e == G.edge_end(f._v))
+            {
+                this->_finish(f._v, f._root, rindex, rep);
+                this->_frames.pop_back();
+                continue;
+            }
+            const auto w = G.target(f._e);
+            if (!allowed(w))
+            {
+                ++f._e;
+                continue;
+            }
+            if (rindex[w] == 0)
+            {
+                // the arc is looked at again once w is done
+                rindex[w] = this->_index++;
+                this->_frames.push_back(Frame {w, G.edge_begin(w), true});
+                continue;
+            }
+            if (rindex[w] < rindex[f._v])
+            {
+                rindex[f._v] = rindex[w];
+                f._root = false;
+            }
+            ++f._e;
+        }
+    }
+
+  private:
+    void _finish(node_t v, bool root, std::vector<node_t>& rindex,
+        std::vector<node_t>& rep)
+    {
+        if (!root)
+        {
+            this->_stack.push_back(v);
+            return;
+        }
+        --this->_index;
+        while (!this->_stack.empty()
+            && rindex[v] <= rindex[this->_stack.back()])
+        {
+            const auto w = this->_stack.back();
+            this->_stack.pop_back();
+            rindex[w] = this->_c;
+            rep[w] = v;
+            --this->_index;
+        }
+        rindex[v] = this->_c--;
+        rep[v] = v;
+    }
+};
+
+/*! Number the components given by a representative node per node in
+    the order of their smallest nodes. */
+inline auto _components_by_smallest_node(
+    const std::vector<std::uint32_t>& rep) -> ComponentsResult
+{
+    const auto n = rep.size();
+    auto id = std::vector<std::uint32_t>(n, PearceSCC::none);
+    auto result = ComponentsResult {};
+    result._labels.resize(n);
+    for (auto v = std::size_t(0); v != n; ++v)
+    {
+        auto& c = id[rep[v]];
+        if (c == PearceSCC::none)
+        {
+            c = std::uint32_t(result._sizes.size());
+            result._sizes.push_back(0);
+        }
+        result._labels[v] = c;
+        ++result._sizes[c];
+    }
+    return result;
+}
+
+/*! Return the strongly connected components of a digraph.
+
+    Parameters
+    ----------
+    G : CSRGraph
+
+    Returns
+    -------
+    A ComponentsResult: the component of every node, the components
+    numbered from 0 in the order of their smallest nodes, and the size of
+    every component.
+
+    Notes
+    -----
+    Pearce's algorithm takes O(n + m) time and, besides the result, one
+    index per node and the DFS stack.  It does not recurse.
+
+    References
+    ----------
+    .. [1] Depth-first search and linear graph algorithms, R. Tarjan
+       SIAM Journal of Computing 1(2):146-160, (1972).
+    .. [2] D. J. Pearce, "A space-efficient algorithm for finding strongly
+       connected components", Information Processing Letters 116 (1):
+       47-52, 2016.
+
+    Examples
+    --------
+    >>> auto C = xn::to_csr_graph(G);  // G a SimpleDiGraphS
+    >>> auto scc = xn::strongly_connected_components(C);
+    >>> scc._labels[u] == scc._labels[v];  // u and v reach each other
+*/
+template <typename CSR>
+auto strongly_connected_components(const CSR& G) -> ComponentsResult
+{
+    const auto n = G.number_of_nodes();
+    auto rindex = std::vector<std::uint32_t>(n, 0);
+    auto rep = std::vector<std::uint32_t>(n);
+    auto dfs = PearceSCC {};
+    for (auto v = std::uint32_t(0); v != n; ++v)
+    {
+        dfs.visit(G, v, rindex, rep, [](std::uint32_t) { return true; });
+    }
+    return _components_by_smallest_node(rep);
+}
+
+/*! Give the nodes without an arc in or out of the remaining subgraph of
+    their color a component of their own, in rounds, until a round trims
+    less than 1% of the remaining nodes. */
+template <typename CSR>
+void _trim_trivial_components(const CSR& G, const CSR& GT,
+    ThreadPool& pool, const std::vector<std::uint8_t>& color,
+    std::vector<std::uint32_t>& rep)
+{
+    using node_t = std::uint32_t;
+    const auto n = G.number_of_nodes();
+    const auto none = PearceSCC::none;
+    auto remaining = std::size_t(0);
+    for (auto r : rep)
+    {
+        remaining += r == none ? 1 : 0;
+    }
+    auto trimmed = std::vector<std::vector<node_t>>(pool.size());
+    while (remaining != 0)
+    {
+        auto has_arc = [&](const CSR& H, node_t v) {
+            for (auto w : H.neighbors(v))
+            {
+                if (w != v && rep[w] == none && color[w] == color[v])
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+        parallel_for(pool, 0, n, 4096, [&](unsigned tid, std::size_t i) {
+            const auto v = node_t(i);
+            if (rep[v] == none && (!has_arc(G, v) || !has_arc(GT, v)))
+            {
+                trimmed[tid].push_back(v);
+            }
+        });
+        auto count = std::size_t(0);
+        for (auto& t : trimmed)
+        {
+            for (auto v : t)
+            {
+                rep[v] = v;
+            }
+            count += t.size();
+            t.clear();
+        }
+        remaining -= count;
+        if (count * 100 < remaining || count == 0)
+        {
+            break;
+        }
+    }
+}
+
+/*! Mark with `bit` in `mark` the nodes reached from s through the
+    remaining nodes of the color of s, by a parallel BFS. */
+template <typename CSR>
+void _reach_within_color(const CSR& G, ThreadPool& pool, std::uint32_t s,
+    const std::vector<std::uint8_t>& color,
+    const std::vector<std::uint32_t>& rep,
+    std::vector<std::atomic<std::uint8_t>>& mark, std::uint8_t bit)
+{
+    using node_t = std::uint32_t;
+    auto frontier = std::vector<node_t> {s};
+    auto next = std::vector<std::vector<node_t>>(pool.size());
+    mark[s].fetch_or(bit, std::memory_order_relaxed);
+    while (!frontier.empty())
+    {
+        parallel_for(pool, 0, frontier.size(), 64,
+            [&](unsigned tid, std::size_t i) {
+                for (auto w : G.neighbors(frontier[i]))
+                {
+                    if (rep[w] != PearceSCC::none || color[w] != color[s])
+                    {
+                        continue;
+                    }
+                    auto& m = mark[w];
+                    if ((m.load(std::memory_order_relaxed) & bit) == 0
+                        && (m.fetch_or(bit, std::memory_order_relaxed) & bit)
+                            == 0)
+                    {
+                        next[tid].push_back(w);
+                    }
+                }
+            });
+        frontier.clear();
+        for (auto& t : next)
+        {
+            frontier.insert(frontier.end(), t.begin(), t.end());
+            t.clear();
+        }
+    }
+}
+
+/*! Return the strongly connected components of a digraph, in parallel.
+
+    Parameters
+    ----------
+    G : CSRGraph
+    GT : the transpose of G, for example a predecessor index kept next to
+        G; it must have the same arcs reversed
+    pool : ThreadPool
+
+    Returns
+    -------
+    The same ComponentsResult as `strongly_connected_components`.
+
+    Notes
+    -----
+    The forward-backward step costs two BFS over the arcs of the
+    remaining graph; trimming and the last step are linear.  When the
+    graph has no giant component the work is done by the parallel
+    Pearce searches of the last step, so the speed-up then depends on
+    the number and balance of the weakly connected pieces.
+
+    References
+    ----------
+    .. [1] L. K. Fleischer, B. Hendrickson and A. Pinar, "On Identifying
+       Strongly Connected Components in Parallel", IPDPS Workshops 2000.
+    .. [2] S. Hong, N. C. Rodia and K. Olukotun, "On Fast Parallel
+       Detection of Strongly Connected Components (SCC) in Small-World
+       Graphs", SC 2013.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto C = xn::to_csr_graph(G);  // G a SimpleDiGraphS
+    >>> auto CT = C.transpose();
+    >>> auto scc = xn::parallel_strongly_connected_components(C, CT, pool);
+*/
+template <typename CSR>
+auto parallel_strongly_connected_components(const CSR& G, const CSR& GT,
+    ThreadPool& pool) -> ComponentsResult
+{
+    using node_t = std::uint32_t;
+    const auto n = G.number_of_nodes();
+    const auto none = PearceSCC::none;
+    auto rep = std::vector<node_t>(n, none);
+    auto color = std::vector<std::uint8_t>(n, 0);
+    _trim_trivial_components(G, GT, pool, color, rep);
+
+    // forward-backward from the remaining node of largest in * out degree
+    auto best = std::vector<std::pair<std::size_t, node_t>>(
+        pool.size(), {0, none});
+    parallel_for(pool, 0, n, 4096, [&](unsigned tid, std::size_t i) {
+        const auto v = node_t(i);
+        const auto score = (G.degree(v) + 1) * (GT.degree(v) + 1);
+        if (rep[v] == none && (best[tid].second == none
+                || score > best[tid].first
+                || (score == best[tid].first && v < best[tid].second)))
+        {
+            best[tid] = {score, v};
+        }
+    });
+    auto pivot = best[0];
+    for (const auto& b : best)
+    {
+        if (b.second != none
+            && (pivot.second == none || b.first > pivot.first
+                || (b.first == pivot.first && b.second < pivot.second)))
+        {
+            pivot = b;
+        }
+    }
+    if (pivot.second != none)
+    {
+        const auto s = pivot.second;
+        auto mark = std::vector<std::atomic<std::uint8_t>>(n);
+        for (auto& m : mark)
+        {
+            m.store(0, std::memory_order_relaxed);
+        }
+        _reach_within_color(G, pool, s, color, rep, mark, 1);
+        _reach_within_color(GT, pool, s, color, rep, mark, 2);
+        parallel_for(pool, 0, n, 4096, [&](unsigned, std::size_t v) {
+            if (rep[v] != none)
+            {
+                return;
+            }
+            const auto m = mark[v].load(std::memory_order_relaxed);
+            if (m == 3)
+            {
+                rep[v] = s;
+            }
+            else
+            {
+                // 1 neither, 2 forward only, 3 backward only
+                color[v] = std::uint8_t(m + 1);
+            }
+        });
+        _trim_trivial_components(G, GT, pool, color, rep);
+    }
+
+    // the weakly connected pieces of the rest, one Pearce search each
+    auto pieces = ConcurrentUnionFind {n};
+    parallel_for(pool, 0, n, 1024, [&](unsigned, std::size_t i) {
+        const auto u = node_t(i);
+        if (rep[u] != none)
+        {
+            return;
+        }
+        for (auto w : G.neighbors(u))
+        {
+            if (rep[w] == none && color[w] == color[u])
+            {
+                pieces.unite(u, w);
+            }
+        }
+    });
+    // group the remaining nodes by piece
+    auto piece = std::vector<node_t>(n, none);
+    auto index = std::vector<node_t>(n, none);
+    auto offsets = std::vector<std::size_t> {0};
+    for (auto v = node_t(0); v != n; ++v)
+    {
+        if (rep[v] == none)
+        {
+            auto& i = index[pieces.find(v)];
+            if (i == none)
+            {
+                i = node_t(offsets.size() - 1);
+                offsets.push_back(0);
+            }
+            piece[v] = i;
+            ++offsets[i + 1];
+        }
+    }
+    for (auto i = std::size_t(1); i != offsets.size(); ++i)
+    {
+        offsets[i] += offsets[i - 1];
+    }
+    auto fill = std::vector<std::size_t>(offsets.begin(), offsets.end() - 1);
+    auto nodes = std::vector<node_t>(offsets.back());
+    for (auto v = node_t(0); v != n; ++v)
+    {
+        if (piece[v] != none)
+        {
+            nodes[fill[piece[v]]++] = v;
+        }
+    }
+    auto rindex = std::vector<node_t>(n, 0);
+    auto searches = std::vector<PearceSCC>(pool.size());
+    parallel_for(pool, 0, offsets.size() - 1, 1,
+        [&](unsigned tid, std::size_t i) {
+            auto same_piece = [&](node_t w) { return piece[w] == i; };
+            for (auto j = offsets[i]; j != offsets[i + 1]; ++j)
+            {
+                searches[tid].visit(G, nodes[j], rindex, rep, same_piece);
+            }
+        });
+    return _components_by_smallest_node(rep);
+}
+
+/*! Return the strongly connected components of a digraph, in parallel;
+    the transpose of G is built for the call.  See
+    `parallel_strongly_connected_components(G, GT, pool)`. */
+template <typename CSR>
+auto parallel_strongly_connected_components(const CSR& G, ThreadPool& pool)
+    -> ComponentsResult
+{
+    return parallel_strongly_connected_components(G, G.transpose(), pool);
+}
+
+/*! Return the number of strongly connected components. */
+template <typename CSR>
+auto number_strongly_connected_components(const CSR& G) -> std::size_t
+{
+    return strongly_connected_components(G).number_of_components();
+}
+
+/*! Return whether every node reaches every other node.
+
+    Raises
+    ------
+    XNetworkPointlessConcept
+        If G has no nodes.
+*/
+template <typename CSR>
+auto is_strongly_connected(const CSR& G) -> bool
+{
+    if (G.number_of_nodes() == 0)
+    {
+        throw XNetworkPointlessConcept(
+            "Connectivity is undefined for the null graph.");
+    }
+    return number_strongly_connected_components(G) == 1;
+}
+
+/*! Return the condensation of G.
+
+    The condensation of G is the graph with each of the strongly
+    connected components contracted into a single node.
+
+    Parameters
+    ----------
+    G : CSRGraph
+    scc : the strongly connected components of G, as returned by
+        `strongly_connected_components`
+
+    Returns
+    -------
+    A CSRGraph DAG whose node c is the component c of `scc` and with an
+    arc c -> d if G has an arc from c to d; rows are sorted and have no
+    duplicates.  `scc._labels` maps the nodes of G to the nodes of the
+    DAG.
+
+    Examples
+    --------
+    >>> auto scc = xn::strongly_connected_components(C);
+    >>> auto D = xn::condensation(C, scc);
+    >>> D.neighbors(scc._labels[u]);  // the components u leads into
+*/
+template <typename CSR>
+auto condensation(const CSR& G, const ComponentsResult& scc) -> CSRGraph<int>
+{
+    using node_t = std::uint32_t;
+    const auto n = G.number_of_nodes();
+    const auto k = scc.number_of_components();
+    const auto& label = scc._labels;
+    // bucket the arcs between components by their tail component
+    auto offsets = std::vector<std::size_t>(k + 1, 0);
+    for (auto u = node_t(0); u != n; ++u)
+    {
+        for (auto v : G.neighbors(u))
+        {
+            offsets[label[u] + 1] += label[u] != label[v] ? 1 : 0;
+        }
+    }
+    for (auto c = std::size_t(0); c != k; ++c)
+    {
+        offsets[c + 1] += offsets[c];
+    }
+    auto fill = std::vector<std::size_t>(offsets.begin(), offsets.end() - 1);
+    auto targets = std::vector<node_t>(offsets.back());
+    for (auto u = node_t(0); u != n; ++u)
+    {
+        for (auto v : G.neighbors(u))
+        {
+            if (label[u] != label[v])
+            {
+                targets[fill[label[u]]++] = label[v];
+            }
+        }
+    }
+    // sort and deduplicate every row in place
+    auto out = std::size_t(0);
+    for (auto c = std::size_t(0); c != k; ++c)
+    {
+        const auto first = targets.begin() + std::ptrdiff_t(offsets[c]);
+        const auto last = targets.begin() + std::ptrdiff_t(offsets[c + 1]);
+        std::sort(first, last);
+        const auto row_end = std::unique(first, last);
+        // shift the row left; a row already in place is not copied onto
+        // itself, which std::copy does not allow
+        if (out != offsets[c])
+        {
+            std::copy(first, row_end, targets.begin() + std::ptrdiff_t(out));
+        }
+        offsets[c] = out;
+        out += std::size_t(row_end - first);
+    }
+    offsets[k] = out;
+    targets.resize(out);
+    return CSRGraph<int> {std::move(offsets), std::move(targets)};
+}
+
+/*! Return the condensation of G; the components are computed for the
+    call.  See `condensation(G, scc)`. */
+template <typename CSR>
+auto condensation(const CSR& G) -> CSRGraph<int>
+{
+    return condensation(G, strongly_connected_components(G));
+}
+
+} // namespace xn
@@ -0,0 +1,183 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native HITS hubs and authorities on the SpMV engine of linalg/spmv.hpp.
+
+Every iteration pulls `a = A^T h` over the rows of the transpose (the
+arcs into a node) and `h = A a` over the rows of the graph (the arcs out
+of a node), so both products are row-parallel without atomics.  Each
+product also returns the largest entry, folded part by part, and one
+pass over the nodes scales both vectors by their maxima and sums the
+change of h.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/centrality/eigenvector.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/linalg/spmv.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Result of `hits`. */
+struct HITSResult
+{
+    std::vector<double> _hubs;
+    std::vector<double> _authorities;
+    std::size_t _iterations = 0;
+    double _residual = 0.0; // L1 change of the hubs in the last iteration
+};
+
+/*! Return HITS hubs and authorities values for nodes.
+
+    The HITS algorithm computes two numbers for a node.  Authorities
+    estimates the node value based on the incoming links.  Hubs estimates
+    the node value based on outgoing links.
+
+    Parameters
+    ----------
+    G : CSRGraph; the weights are used if it has any
+    GT : the transpose of G, for example a predecessor index kept next to
+        G; it must have the same arcs reversed
+    pool : ThreadPool
+    max_iter : maximum number of iterations (default: 100)
+    tol : the iteration stops when the L1 change of the hubs, each scaled
+        to a largest value of 1, is below tol (default: 1.0e-8)
+    nstart : starting hub values (default: uniform)
+    normalized : scale both results to sum 1 (default: true)
+
+    Returns
+    -------
+    A HITSResult: flat hub and authority arrays indexed by node, the
+    number of iterations and the last L1 change.  The arrays are empty
+    for the null graph and all zero for a graph without arcs.
+
+    Raises
+    ------
+    XNetworkError
+        If nstart has the wrong size or only zeros.
+    PowerIterationFailedConvergence
+        If the iteration does not converge within max_iter iterations.
+
+    References
+    ----------
+    .. [1] A. Langville and C. Meyer,
+       "A survey of eigenvector methods of web information retrieval."
+       http://citeseer.ist.psu.edu/713792.html
+    .. [2] Jon Kleinberg,
+       Authoritative sources in a hyperlinked environment
+       Journal of the ACM 46 (5): 604-32, 1999.
+       doi:10.1145/324133.324140.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto C = xn::to_csr_graph(G);
+    >>> auto CT = C.transpose();  // kept for later calls
+    >>> auto r = xn::hits(C, CT, pool);
+    >>> r._hubs[v], r._authorities[v];
+*/
+template <typename CSR>
+auto hits(const CSR& G, const CSR& GT, ThreadPool& pool,
+    std::size_t max_iter = 100, double tol = 1.0e-8,
+    const std::vector<double>& nstart = {}, bool normalized = true)
+    -> HITSResult
+{
+    const auto n = G.number_of_nodes();
+    if (n == 0)
+    {
+        return HITSResult {};
+    }
+    // scaled like the iterates, so that a warm start stops at once
+    auto h = _power_iteration_start(n, nstart);
+    const auto hmax0 = *std::max_element(h.begin(), h.end());
+    for (auto& x : h)
+    {
+        x /= hmax0;
+    }
+    auto a = std::vector<double>(n);
+    auto h_next = std::vector<double>(n);
+    auto forward = SpMV<CSR> {G, pool};
+    auto backward = SpMV<CSR> {GT, pool};
+    auto largest = [](double x, double y) { return std::max(x, y); };
+    for (auto it = std::size_t(1); it <= max_iter; ++it)
+    {
+        const auto* ph = h.data();
+        const auto amax = backward.reduce_parts(
+            [&](std::size_t first, std::size_t last) {
+                auto m = 0.0;
+                for (auto i = first; i != last; ++i)
+                {
+                    a[i] = backward.row_dot(i, ph);
+                    m = std::max(m, a[i]);
+                }
+                return m;
+            },
+            0.0, largest);
+        const auto* pa = a.data();
+        const auto hmax = forward.reduce_parts(
+            [&](std::size_t first, std::size_t last) {
+                auto m = 0.0;
+                for (auto i = first; i != last; ++i)
+                {
+                    h_next[i] = forward.row_dot(i, pa);
+                    m = std::max(m, h_next[i]);
+                }
+                return m;
+            },
+            0.0, largest);
+        // all zero only without arcs; leave the zeros
+        const auto sa = amax > 0.0 ? 1.0 / amax : 1.0;
+        const auto sh = hmax > 0.0 ? 1.0 / hmax : 1.0;
+        const auto change = forward.for_each_part(
+            [&](std::size_t first, std::size_t last) {
+                auto sum = 0.0;
+                for (auto i = first; i != last; ++i)
+                {
+                    a[i] *= sa;
+                    h_next[i] *= sh;
+                    sum += std::abs(h_next[i] - h[i]);
+                }
+                return sum;
+            });
+        h.swap(h_next);
+        if (change < tol)
+        {
+            if (normalized)
+            {
+                for (auto* v : {&h, &a})
+                {
+                    auto sum = 0.0;
+                    for (auto x : *v)
+                    {
+                        sum += x;
+                    }
+                    for (auto& x : *v)
+                    {
+                        x = sum > 0.0 ? x / sum : x;
+                    }
+                }
+            }
+            return HITSResult {std::move(h), std::move(a), it, change};
+        }
+    }
+    throw PowerIterationFailedConvergence(max_iter);
+}
+
+/*! Return HITS hubs and authorities values for nodes; the transpose of
+    G is built for the call.  See `hits(G, GT, pool, ...)`. */
+template <typename CSR>
+auto hits(const CSR& G, ThreadPool& pool, std::size_t max_iter = 100,
+    double tol = 1.0e-8, const std::vector<double>& nstart = {},
+    bool normalized = true) -> HITSResult
+{
+    return hits(G, G.transpose(), pool, max_iter, tol, nstart, normalized);
+}
+
+} // namespace xn
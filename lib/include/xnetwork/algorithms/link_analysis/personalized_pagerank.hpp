@@ -0,0 +1,326 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Local personalized PageRank by forward push (Andersen, Chung and Lang,
+2006).
+
+The PageRank personalized on a seed s is approximated by a vector p and
+a residual r, starting from p = 0 and r = e_s.  Pushing a node u moves
+`(1 - alpha) r[u]` into p[u] and spreads `alpha r[u]` over the arcs out
+of u in proportion to their weights (back to the seed if u is dangling,
+as the `pagerank` dangling vector defaults to the personalization).
+Nodes are pushed while `r[u] > epsilon W(u)`, W(u) the out-weight of u
+(1 if u is dangling).  The work is O(1 / ((1 - alpha) epsilon)) pushes
+whatever the size of the graph, and only the nodes near the seed are
+touched.
+
+A `PushWorkspace` keeps dense arrays that are reset through the list of
+touched nodes, so a query costs neither an allocation nor a pass over
+the graph; the batched query takes one workspace per thread from the
+caller, so that it allocates only its results.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Per-thread state of forward push.
+
+    Parameters
+    ----------
+    num_nodes : number of nodes of the graph
+*/
+class PushWorkspace
+{
+  public:
+    using node_t = std::uint32_t;
+
+    std::vector<double> _p; // estimate
+    std::vector<double> _r; // residual
+    std::vector<std::uint8_t> _touched_flag;
+    std::vector<std::uint8_t> _queued;
+    std::vector<node_t> _touched;
+    std::vector<node_t> _queue;
+
+    explicit PushWorkspace(std::size_t num_nodes = 0)
+        : _p(num_nodes, 0.0)
+        , _r(num_nodes, 0.0)
+        , _touched_flag(num_nodes, 0)
+        , _queued(num_nodes, 0)
+    {
+    }
+
+    /*! Forget the last query in O(number of touched nodes). */
+    void reset()
+    {
+        for (auto v : this->_touched)
+        {
+            this->_p[v] = this->_r[v] = 0.0;
+            this->_touched_flag[v] = this->_queued[v] = 0;
+        }
+        this->_touched.clear();
+        this->_queue.clear();
+    }
+
+    void touch(node_t v)
+    {
+        if (this->_touched_flag[v] == 0)
+        {
+            this->_touched_flag[v] = 1;
+            this->_touched.push_back(v);
+        }
+    }
+};
+
+/*! Approximate personalized PageRank by forward push.
+
+    Parameters
+    ----------
+    G : CSRGraph (both directions of every edge for an undirected graph);
+        the weights are used if it has any.  It must outlive the object.
+    alpha : damping parameter, as in `pagerank` (default: 0.85)
+    epsilon : residual threshold per unit of out-weight (default: 1e-6)
+
+    Raises
+    ------
+    XNetworkError
+        If alpha is not in [0, 1) or epsilon is not positive.
+
+    Notes
+    -----
+    When a query returns, every residual is at most epsilon times the
+    out-weight of its node (1 for a dangling node).  For an undirected
+    graph the estimate of every node v is then below its PageRank
+    personalized on the seed by at most `epsilon * W(v)`.
+
+    Examples
+    --------
+    >>> auto ppr = xn::PersonalizedPageRankPush<decltype(C)> {C, 0.85,
+    ...     1.0e-5};
+    >>> auto ws = xn::PushWorkspace {C.number_of_nodes()};
+    >>> auto scores = ppr.query(user, ws);  // (node, score), best first
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto wss = std::vector<xn::PushWorkspace>(pool.size(), ws);
+    >>> auto top = ppr.query(pool, users, wss, 10);  // ten per user
+*/
+template <typename CSR>
+class PersonalizedPageRankPush
+{
+  public:
+    using node_t = std::uint32_t;
+    using scores_t = std::vector<std::pair<node_t, double>>;
+
+    const CSR& _G;
+    std::vector<double> _out_weight; // empty if G is unweighted
+    double _alpha;
+    double _epsilon;
+
+    explicit PersonalizedPageRankPush(
+        const CSR& G, double alpha = 0.85, double epsilon = 1.0e-6)
+        : _G {G}
+        , _alpha {alpha}
+        , _epsilon {epsilon}
+    {
+        if (!(alpha >= 0.0 && alpha < 1.0))
+        {
+            throw XNetworkError("alpha must be in [0, 1)");
+        }
+        if (!(epsilon > 0.0))
+        {
+            throw XNetworkError("epsilon must be positive");
+        }
+        if (G.is_weighted())
+        {
+            const auto n = G.number_of_nodes();
+            this->_out_weight.assign(n, 0.0);
+            for (auto u = 0U; u != n; ++u)
+            {
+                for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+                {
+                    this->_out_weight[u] += double(G.weight(e));
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] auto out_weight(node_t u) const -> double
+    {
+        return this->_out_weight.empty() ? double(this->_G.degree(u))
+                                         : this->_out_weight[u];
+    }
+
+    /*! Run forward push from `seed`; the estimate is left in `ws._p`
+        over the nodes of `ws._touched`.
+
+        Raises
+        ------
+        NodeNotFound
+            If seed is not a node of the graph.
+        XNetworkError
+            If ws is not sized for the graph.
+    */
+    void push(node_t seed, PushWorkspace& ws) const
+    {
+        const auto& G = this->_G;
+        this->_check_seed(seed);
+        this->_check_workspace(ws);
+        const auto alpha = this->_alpha;
+        auto threshold = [&](node_t v) {
+            const auto w = this->out_weight(v);
+            return this->_epsilon * (w > 0.0 ? w : 1.0);
+        };
+        auto add = [&](node_t v, double mass) {
+            ws.touch(v);
+            ws._r[v] += mass;
+            if (ws._queued[v] == 0 && ws._r[v] > threshold(v))
+            {
+                ws._queued[v] = 1;
+                ws._queue.push_back(v);
+            }
+        };
+        ws.reset();
+        add(seed, 1.0);
+        for (auto head = std::size_t(0); head != ws._queue.size(); ++head)
+        {
+            const auto u = ws._queue[head];
+            ws._queued[u] = 0;
+            const auto ru = ws._r[u];
+            ws._r[u] = 0.0;
+            ws._p[u] += (1.0 - alpha) * ru;
+            const auto w = this->out_weight(u);
+            if (!(w > 0.0))
+            {
+                add(seed, alpha * ru); // dangling: back to the seed
+                continue;
+            }
+            const auto share = alpha * ru / w;
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                add(G.target(e), share * double(G.weight(e)));
+            }
+        }
+    }
+
+    /*! Return the approximate PageRank personalized on `seed`.
+
+        Parameters
+        ----------
+        seed : node
+        ws : PushWorkspace of this thread
+        top_k : keep only the k best nodes; 0 keeps all touched nodes
+            with a positive estimate
+
+        Returns
+        -------
+        Pairs (node, estimate) by decreasing estimate.
+
+        Raises
+        ------
+        NodeNotFound
+            If seed is not a node of the graph.
+        XNetworkError
+            If ws is not sized for the graph.
+    */
+    auto query(node_t seed, PushWorkspace& ws, std::size_t top_k = 0) const
+        -> scores_t
+    {
+        this->push(seed, ws);
+        auto scores = scores_t {};
+        for (auto v : ws._touched)
+        {
+            if (ws._p[v] > 0.0)
+            {
+                scores.emplace_back(v, ws._p[v]);
+            }
+        }
+        auto better = [](const auto& a, const auto& b) {
+            return a.second != b.second ? a.second > b.second
+                                        : a.first < b.first;
+        };
+        if (top_k != 0 && top_k < scores.size())
+        {
+            std::partial_sort(scores.begin(),
+                scores.begin() + std::ptrdiff_t(top_k), scores.end(), better);
+            scores.resize(top_k);
+        }
+        else
+        {
+            std::sort(scores.begin(), scores.end(), better);
+        }
+        return scores;
+    }
+
+    /*! Run `query` for every seed, in parallel.
+
+        Parameters
+        ----------
+        pool : ThreadPool
+        seeds : nodes
+        workspaces : a PushWorkspace sized for G for each thread of the
+            pool, kept by the caller across batches
+        top_k : keep only the k best nodes per seed; 0 keeps all
+
+        Returns
+        -------
+        The result of `query` for every seed, in the order of `seeds`.
+
+        Raises
+        ------
+        NodeNotFound
+            If a seed is not a node of the graph; no query is run then.
+        XNetworkError
+            If there are fewer workspaces than threads in the pool, or
+            one is not sized for the graph; no query is run then.
+    */
+    auto query(ThreadPool& pool, const std::vector<node_t>& seeds,
+        std::vector<PushWorkspace>& workspaces, std::size_t top_k = 0) const
+        -> std::vector<scores_t>
+    {
+        if (workspaces.size() < pool.size())
+        {
+            throw XNetworkError("fewer workspaces than threads");
+        }
+        for (const auto& ws : workspaces)
+        {
+            this->_check_workspace(ws);
+        }
+        for (auto seed : seeds)
+        {
+            this->_check_seed(seed);
+        }
+        auto results = std::vector<scores_t>(seeds.size());
+        parallel_for(pool, 0, seeds.size(), 16,
+            [&](unsigned tid, std::size_t i) {
+                results[i] = this->query(seeds[i], workspaces[tid], top_k);
+            });
+        return results;
+    }
+
+    void _check_seed(node_t seed) const
+    {
+        if (seed >= this->_G.number_of_nodes())
+        {
+            throw NodeNotFound(
+                "node " + std::to_string(seed) + " is not in the graph");
+        }
+    }
+
+    void _check_workspace(const PushWorkspace& ws) const
+    {
+        if (ws._p.size() != this->_G.number_of_nodes())
+        {
+            throw XNetworkError("workspace is not sized for the graph");
+        }
+    }
+};
+
+} // namespace xn
@@ -0,0 +1,464 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native A* search and ALT (A*, landmarks, triangle inequality) heuristics.
+
+`astar_path_length` runs on a `CSRGraph` with any admissible heuristic.
+`Landmarks` precomputes shortest path distances from and to a few
+landmark nodes once per graph; `L.heuristic(target)` then gives every
+query a lower bound on the remaining distance by the triangle inequality,
+so repeated queries on the same graph settle far fewer nodes than
+Dijkstra.
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include <xnetwork/algorithms/shortest_paths/weighted.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/heaps.hpp>
+#include <xnetwork/utils/random.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Per-query state of A*.
+
+    A DijkstraWorkspace whose heap is keyed by `dist + h`; the heuristic
+    value of every labeled node is cached so that it is evaluated once
+    per node and query.
+*/
+template <typename Dist, typename Heap = DaryHeap<Dist, std::uint32_t, 4>>
+class AStarWorkspace : public DijkstraWorkspace<Dist, Heap>
+{
+    using _Base = DijkstraWorkspace<Dist, Heap>;
+
+  public:
+    using node_t = typename _Base::node_t;
+
+    std::vector<Dist> _h;
+
+    explicit AStarWorkspace(std::size_t num_nodes)
+        : _Base {num_nodes}
+        , _h(num_nodes, Dist(0))
+    {
+    }
+};
+
+/*! Return the length of the shortest path from source to target by A*.
+
+    Parameters
+    ----------
+    G : CSRGraph with non-negative weights
+    source, target : nodes
+    heuristic : callable `heuristic(v)` returning a lower bound on the
+        distance from v to target, or `infinity()` if v cannot reach
+        target.  It must be admissible; a consistent heuristic (such as
+        `Landmarks::heuristic`) settles every node at most once.
+    ws : AStarWorkspace sized for G; reset first
+
+    Returns
+    -------
+    The distance.  `ws.settled()` lists the expanded nodes and
+    `ws.path_to(target)` gives the path.
+
+    Raises
+    ------
+    XNetworkNoPath
+        If no path exists between source and target.
+
+    Examples
+    --------
+    >>> auto ws = xn::AStarWorkspace<int> {C.number_of_nodes()};
+    >>> auto zero = [](std::uint32_t) { return 0; };  // Dijkstra
+    >>> xn::astar_path_length(C, 0U, 5U, zero, ws);
+*/
+template <typename CSR, typename Heuristic, typename Workspace>
+auto astar_path_length(const CSR& G, typename Workspace::node_t source,
+    typename Workspace::node_t target, Heuristic&& heuristic,
+    Workspace& ws) -> typename Workspace::dist_t
+{
+    using Dist = typename Workspace::dist_t;
+
+    assert(ws.number_of_nodes() == G.number_of_nodes());
+    ws.reset();
+    const auto hs = Dist(heuristic(source));
+    if (hs != Workspace::infinity())
+    {
+        ws._label(source, Dist(0), Workspace::none);
+        ws._h[source] = hs;
+        ws._heap.push(hs, source);
+    }
+    while (!ws._heap.empty())
+    {
+        const auto [f, u] = ws._heap.pop();
+        const auto d = ws._dist[u];
+        if (Dist(d + ws._h[u]) < f)
+        {
+            continue; // stale entry
+        }
+        ws._settled.push_back(u);
+        if (u == target)
+        {
+            return d;
+        }
+        for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+        {
+            const auto v = G.target(e);
+            const auto nd = Dist(d + G.weight(e));
+            if (!(nd < ws._dist[v]))
+            {
+                continue;
+            }
+            if (!ws.reached(v))
+            {
+                const auto hv = Dist(heuristic(v));
+                if (hv == Workspace::infinity())
+                {
+                    continue; // v cannot reach target
+                }
+                ws._h[v] = hv;
+            }
+            ws._label(v, nd, u);
+            ws._heap.push(Dist(nd + ws._h[v]), v);
+        }
+    }
+    throw XNetworkNoPath("Node " + std::to_string(target)
+        + " not reachable from " + std::to_string(source));
+}
+
+/*! Return the nodes of a shortest path from source to target by A*.
+
+    See `astar_path_length`.
+*/
+template <typename CSR, typename Heuristic, typename Workspace>
+auto astar_path(const CSR& G, typename Workspace::node_t source,
+    typename Workspace::node_t target, Heuristic&& heuristic,
+    Workspace& ws) -> std::vector<typename Workspace::node_t>
+{
+    astar_path_length(G, source, target, heuristic, ws);
+    return ws.path_to(target);
+}
+
+/*! How `Landmarks` chooses its landmark nodes. */
+enum class LandmarkSelection
+{
+    random,   // uniformly at random; all tables are built in parallel
+    farthest, // each landmark farthest from those chosen so far
+    avoid     // Goldberg and Werneck's avoid heuristic
+};
+
+/*! Landmark distance tables for ALT lower bounds.
+
+    For every landmark L the table holds `d(L, v)` and, on a directed
+    graph, `d(v, L)`, for every node v.  The entries of a node are stored
+    next to each other (node-major), so a bound reads one short run of
+    memory per node.  With `d(., .)` satisfying the triangle inequality,
+
+        d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L)
+
+    and the heuristic is the largest of these bounds over all landmarks.
+
+    Parameters
+    ----------
+    G : CSRGraph with non-negative weights
+    GT : its transpose (omit for a symmetric graph such as the snapshot
+        of an undirected `Graph`)
+    num_landmarks : number of landmarks k; the tables take 2 k n
+        distances (k n for a symmetric graph)
+    pool : ThreadPool for building the tables
+    method : LandmarkSelection (default: farthest)
+    seed : seed of the random choices
+
+    Notes
+    -----
+    Farthest and avoid selection need the distances from the landmarks
+    chosen so far, so these tables are built one landmark at a time; the
+    tables to the landmarks, and all tables of random selection, are
+    built in parallel, one landmark per thread.
+
+    Examples
+    --------
+    >>> auto L = xn::Landmarks<int> {C, C.transpose(), 8, pool};
+    >>> auto ws = xn::AStarWorkspace<int> {C.number_of_nodes()};
+    >>> xn::astar_path_length(C, s, t, L.heuristic(t), ws);
+*/
+template <typename Dist>
+class Landmarks
+{
+  public:
+    using node_t = std::uint32_t;
+    using dist_t = Dist;
+
+    static constexpr auto infinity() -> Dist
+    {
+        return ShortestPathTree<Dist>::infinity();
+    }
+
+  private:
+    std::size_t _k;
+    std::vector<node_t> _landmarks;
+    std::vector<Dist> _from; // _from[v * k + i] == d(L_i, v)
+    std::vector<Dist> _to;   // _to[v * k + i] == d(v, L_i), empty if
+                             // symmetric
+
+  public:
+    template <typename CSR>
+    Landmarks(const CSR& G, const CSR& GT, std::size_t num_landmarks,
+        ThreadPool& pool,
+        LandmarkSelection method = LandmarkSelection::farthest,
+        std::uint32_t seed = 0)
+        : _k {std::min(num_landmarks, std::size_t(G.number_of_nodes()))}
+        , _from(this->_k * G.number_of_nodes(), infinity())
+        , _to(this->_k * G.number_of_nodes(), infinity())
+    {
+        assert(GT.number_of_nodes() == G.number_of_nodes());
+        this->_build(G, pool, method, seed);
+        this->_fill(GT, this->_to, 0, pool);
+    }
+
+    template <typename CSR>
+    Landmarks(const CSR& G, std::size_t num_landmarks, ThreadPool& pool,
+        LandmarkSelection method = LandmarkSelection::farthest,
+        std::uint32_t seed = 0)
+        : _k {std::min(num_landmarks, std::size_t(G.number_of_nodes()))}
+        , _from(this->_k * G.number_of_nodes(), infinity())
+    {
+        this->_build(G, pool, method, seed);
+    }
+
+    [[nodiscard]] auto landmarks() const -> const std::vector<node_t>&
+    {
+        return this->_landmarks;
+    }
+
+    [[nodiscard]] auto is_symmetric() const -> bool
+    {
+        return this->_to.empty();
+    }
+
+    /*! Return d(L_i, v). */
+    [[nodiscard]] auto dist_from(std::size_t i, node_t v) const -> Dist
+    {
+        return this->_from[v * this->_k + i];
+    }
+
+    /*! Return d(v, L_i). */
+    [[nodiscard]] auto dist_to(std::size_t i, node_t v) const -> Dist
+    {
+        return this->is_symmetric() ? this->dist_from(i, v)
+                                    : this->_to[v * this->_k + i];
+    }
+
+    /*! Return a lower bound on d(v, t), or `infinity()` if the tables
+        show that v cannot reach t. */
+    [[nodiscard]] auto lower_bound(node_t v, node_t t) const -> Dist
+    {
+        const auto k = this->_k;
+        const auto* from_v = this->_from.data() + v * k;
+        const auto* from_t = this->_from.data() + t * k;
+        const auto* to_v = this->is_symmetric() ? from_v : &this->_to[v * k];
+        const auto* to_t = this->is_symmetric() ? from_t : &this->_to[t * k];
+        auto bound = Dist(0);
+        for (auto i = std::size_t(0); i != k; ++i)
+        {
+            if (from_v[i] != infinity())
+            {
+                if (from_t[i] == infinity())
+                {
+                    return infinity(); // L_i reaches v but not t
+                }
+                if (from_v[i] < from_t[i])
+                {
+                    bound = std::max(bound, Dist(from_t[i] - from_v[i]));
+                }
+            }
+            if (to_t[i] != infinity())
+            {
+                if (to_v[i] == infinity())
+                {
+                    return infinity(); // t reaches L_i but v does not
+                }
+                if (to_t[i] < to_v[i])
+                {
+                    bound = std::max(bound, Dist(to_v[i] - to_t[i]));
+                }
+            }
+        }
+        return bound;
+    }
+
+    /*! Return the ALT heuristic for queries to target t. */
+    [[nodiscard]] auto heuristic(node_t t) const
+    {
+        return [this, t](node_t v) { return this->lower_bound(v, t); };
+    }
+
+  private:
+    /*! Choose the landmarks and fill the tables from them. */
+    template <typename CSR>
+    void _build(const CSR& G, ThreadPool& pool, LandmarkSelection method,
+        std::uint32_t seed)
+    {
+        const auto n = node_t(G.number_of_nodes());
+        if (this->_k == 0)
+        {
+            return;
+        }
+        auto rng = SplitMix64 {seed};
+        if (method == LandmarkSelection::random)
+        {
+            auto nodes = std::vector<node_t>(n);
+            for (auto v = node_t(0); v != n; ++v)
+            {
+                nodes[v] = v;
+            }
+            for (auto i = std::size_t(0); i != this->_k; ++i)
+            {
+                std::swap(nodes[i], nodes[i + rng.below(n - i)]);
+            }
+            this->_landmarks.assign(nodes.begin(), nodes.begin() + this->_k);
+            this->_fill(G, this->_from, 0, pool);
+            return;
+        }
+
+        auto ws = DijkstraWorkspace<Dist> {n};
+        auto mind = std::vector<Dist>(n, infinity());
+        // the first landmark is the node farthest from a random node
+        single_source_dijkstra(G, node_t(rng.below(n)), ws);
+        auto landmark = ws.settled().back();
+        for (auto i = std::size_t(0); i != this->_k; ++i)
+        {
+            this->_landmarks.push_back(landmark);
+            single_source_dijkstra(G, landmark, ws);
+            for (auto v : ws.touched())
+            {
+                this->_from[v * this->_k + i] = ws.dist(v);
+                mind[v] = std::min(mind[v], ws.dist(v));
+            }
+            if (i + 1 == this->_k)
+            {
+                break;
+            }
+            landmark = method == LandmarkSelection::avoid
+                ? this->_avoid(G, i + 1, node_t(rng.below(n)), ws)
+                : _farthest(mind);
+            if (landmark == ws.none)
+            {
+                landmark = _farthest(mind);
+            }
+        }
+    }
+
+    /*! Return a node not reached from any landmark, or else the one
+        farthest from its nearest landmark. */
+    static auto _farthest(const std::vector<Dist>& mind) -> node_t
+    {
+        auto best = node_t(0);
+        for (auto v = node_t(0); v != node_t(mind.size()); ++v)
+        {
+            if (mind[v] == infinity())
+            {
+                return v;
+            }
+            if (mind[best] < mind[v])
+            {
+                best = v;
+            }
+        }
+        return best;
+    }
+
+    /*! Goldberg and Werneck's avoid heuristic: grow a shortest path tree
+        from root, weight each node by how poorly the current landmarks
+        bound its distance from root, and descend from root towards the
+        heaviest subtree that holds no landmark.  The leaf reached is the
+        next landmark (none if every subtree holds a landmark). */
+    template <typename CSR>
+    auto _avoid(const CSR& G, std::size_t chosen, node_t root,
+        DijkstraWorkspace<Dist>& ws) const -> node_t
+    {
+        const auto n = G.number_of_nodes();
+        single_source_dijkstra(G, root, ws);
+        auto size = std::vector<Dist>(n, Dist(0));
+        auto covered = std::vector<char>(n, 0);
+        for (auto i = std::size_t(0); i != chosen; ++i)
+        {
+            covered[this->_landmarks[i]] = 1;
+        }
+        const auto& order = ws.settled();
+        for (auto it = order.rbegin(); it != order.rend(); ++it)
+        {
+            const auto v = *it;
+            auto bound = Dist(0);
+            for (auto i = std::size_t(0); i != chosen; ++i)
+            {
+                const auto lr = this->dist_from(i, root);
+                const auto lv = this->dist_from(i, v);
+                if (lr != infinity() && lv != infinity() && lr < lv)
+                {
+                    bound = std::max(bound, Dist(lv - lr));
+                }
+            }
+            size[v] = covered[v] ? Dist(0)
+                                 : Dist(size[v] + (ws.dist(v) - bound));
+            const auto p = ws.pred(v);
+            if (p != ws.none)
+            {
+                covered[p] = char(covered[p] | covered[v]);
+                size[p] = Dist(size[p] + size[v]);
+            }
+        }
+        auto best = std::vector<node_t>(n, ws.none); // heaviest child
+        for (auto v : order)
+        {
+            const auto p = ws.pred(v);
+            if (p != ws.none && Dist(0) < size[v]
+                && (best[p] == ws.none || size[best[p]] < size[v]))
+            {
+                best[p] = v;
+            }
+        }
+        if (!(Dist(0) < size[root]))
+        {
+            return ws.none;
+        }
+        auto v = root;
+        while (best[v] != ws.none)
+        {
+            v = best[v];
+        }
+        return v;
+    }
+
+    /*! Fill the table of landmarks `[first, k)` on G in parallel. */
+    template <typename CSR>
+    void _fill(const CSR& G, std::vector<Dist>& table, std::size_t first,
+        ThreadPool& pool)
+    {
+        const auto n = G.number_of_nodes();
+        auto workspaces = std::vector<DijkstraWorkspace<Dist>> {};
+        workspaces.reserve(pool.size());
+        for (auto t = 0U; t != pool.size(); ++t)
+        {
+            workspaces.emplace_back(n);
+        }
+        parallel_for(pool, first, this->_k, 1,
+            [&](unsigned tid, std::size_t i) {
+                auto& ws = workspaces[tid];
+                single_source_dijkstra(G, this->_landmarks[i], ws);
+                for (auto v : ws.touched())
+                {
+                    table[v * this->_k + i] = ws.dist(v);
+                }
+            });
+    }
+};
+
+} // namespace xn
@@ -0,0 +1,834 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Contraction hierarchies for point-to-point and table shortest path queries.
+
+Preprocessing contracts the nodes one by one in the order of their
+importance.  Contracting v removes it from the remaining graph and, for
+every pair of arcs (u, v), (v, w) whose path u-v-w is the only shortest
+one (no witness path avoids v), inserts a shortcut (u, w).  Every shortest
+path of the original graph then has a counterpart that first climbs and
+then descends in the order, so a query only searches upward from both
+ends (Geisberger, Sanders, Schultes and Delling, 2008).
+*/
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/shortest_paths/dense.hpp>
+#include <xnetwork/algorithms/shortest_paths/weighted.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/heaps.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! A contraction hierarchy of a directed graph with non-negative weights.
+
+    The hierarchy consists of the rank of every node and two search
+    graphs in CSR form: the upward graph holds the arcs (u, v), original
+    or shortcut, with `rank(u) < rank(v)`, and the downward graph holds,
+    in row v, the tails u of the arcs (u, v) with `rank(u) > rank(v)`.
+    A forward search from s runs on the upward graph, a backward search
+    from t on the downward graph, and both only ever climb.  For every
+    shortcut the contracted middle node is kept to unpack paths.
+
+    Parameters
+    ----------
+    G : CSRGraph with non-negative weights (both directions of every edge
+        for an undirected graph)
+    witness_limit : maximum number of nodes a witness search may settle
+        (default: 500).  A smaller limit speeds up preprocessing at the
+        price of superfluous shortcuts, never of wrong distances.
+
+    Notes
+    -----
+    Preprocessing pays off on road networks, whose small separators keep
+    the number of shortcuts close to the number of arcs; on grids with
+    random weights it grows like n log n.
+
+    Examples
+    --------
+    >>> auto CH = xn::ContractionHierarchy<int> {C};
+    >>> auto ws = xn::BidirectionalDijkstraWorkspace<int> {n};
+    >>> CH.path_length(s, t, ws);
+    >>> auto D = CH.table(sources, targets, pool);
+    >>> auto file = std::ofstream {"graph.ch", std::ios::binary};
+    >>> CH.save(file);
+*/
+template <typename Dist>
+class ContractionHierarchy
+{
+  public:
+    using node_t = std::uint32_t;
+    using dist_t = Dist;
+    using graph_t = CSRGraph<Dist>;
+
+    static constexpr node_t none = std::numeric_limits<node_t>::max();
+
+    static constexpr auto infinity() -> Dist
+    {
+        return ShortestPathTree<Dist>::infinity();
+    }
+
+  private:
+    std::vector<node_t> _rank;
+    graph_t _up;
+    graph_t _down;
+    std::vector<node_t> _up_middle; // per arc of _up, none if original
+    std::vector<node_t> _down_middle;
+
+    struct Arc
+    {
+        node_t node;
+        Dist weight;
+        node_t middle;
+    };
+
+    struct Shortcut
+    {
+        node_t tail;
+        node_t head;
+        Dist weight;
+    };
+
+    /*! The remaining graph during preprocessing. */
+    struct Builder
+    {
+        std::vector<std::vector<Arc>> _out;
+        std::vector<std::vector<Arc>> _in;
+        std::vector<std::uint32_t> _deleted_neighbors;
+        std::vector<std::uint8_t> _target;
+        DijkstraWorkspace<Dist> _ws;
+        std::vector<Shortcut> _shortcuts;
+        std::size_t _witness_limit;
+
+        Builder(std::size_t n, std::size_t witness_limit)
+            : _out(n)
+            , _in(n)
+            , _deleted_neighbors(n, 0)
+            , _target(n, 0)
+            , _ws {n}
+            , _witness_limit {witness_limit}
+        {
+        }
+
+        /*! Add arc (u, w) or lower its weight. */
+        void add_arc(node_t u, node_t w, Dist weight, node_t middle)
+        {
+            for (auto& a : this->_out[u])
+            {
+                if (a.node == w)
+                {
+                    if (weight < a.weight)
+                    {
+                        a = Arc {w, weight, middle};
+                        for (auto& b : this->_in[w])
+                        {
+                            if (b.node == u)
+                            {
+                                b = Arc {u, weight, middle};
+                            }
+                        }
+                    }
+                    return;
+                }
+            }
+            this->_out[u].push_back(Arc {w, weight, middle});
+            this->_in[w].push_back(Arc {u, weight, middle});
+        }
+
+        /*! Dijkstra from u in the remaining graph without v, stopped
+            once `targets` marked nodes are settled, beyond max_dist or
+            after witness_limit settled nodes. */
+        void witness_search(
+            node_t u, node_t v, Dist max_dist, std::size_t targets)
+        {
+            auto& ws = this->_ws;
+            ws.reset();
+            ws._label(u, Dist(0), ws.none);
+            ws._heap.push(Dist(0), u);
+            while (!ws._heap.empty())
+            {
+                const auto [d, x] = ws._heap.pop();
+                if (ws._dist[x] < d)
+                {
+                    continue;
+                }
+                if (max_dist < d
+                    || ws._settled.size() == this->_witness_limit)
+                {
+                    break;
+                }
+                ws._settled.push_back(x);
+                if (this->_target[x] != 0 && --targets == 0)
+                {
+                    break;
+                }
+                for (const auto& a : this->_out[x])
+                {
+                    const auto nd = Dist(d + a.weight);
+                    if (a.node != v && nd < ws._dist[a.node])
+                    {
+                        ws._label(a.node, nd, x);
+                        ws._heap.push(nd, a.node);
+                    }
+                }
+            }
+        }
+
+        /*! Collect in `_shortcuts` the shortcuts contracting v needs. */
+        void find_shortcuts(node_t v)
+        {
+            this->_shortcuts.clear();
+            for (const auto& in : this->_in[v])
+            {
+                auto max_dist = Dist(0);
+                auto targets = std::size_t(0);
+                for (const auto& out : this->_out[v])
+                {
+                    if (out.node != in.node)
+                    {
+                        max_dist = std::max(
+                            max_dist, Dist(in.weight + out.weight));
+                        this->_target[out.node] = 1;
+                        ++targets;
+                    }
+                }
+                if (targets == 0)
+                {
+                    continue;
+                }
+                this->witness_search(in.node, v, max_dist, targets);
+                for (const auto& out : this->_out[v])
+                {
+                    this->_target[out.node] = 0;
+                }
+                for (const auto& out : this->_out[v])
+                {
+                    const auto d = Dist(in.weight + out.weight);
+                    if (out.node != in.node && d < this->_ws.dist(out.node))
+                    {
+                        this->_shortcuts.push_back(
+                            Shortcut {in.node, out.node, d});
+                    }
+                }
+            }
+        }
+
+        /*! Edge difference plus the number of contracted neighbors. */
+        auto priority(node_t v) -> std::int64_t
+        {
+            this->find_shortcuts(v);
+            return std::int64_t(this->_shortcuts.size())
+                - std::int64_t(this->_in[v].size() + this->_out[v].size())
+                + std::int64_t(this->_deleted_neighbors[v]);
+        }
+
+        /*! Remove v from the remaining graph, inserting the shortcuts
+            left by `priority(v)`; its arcs stay in _out[v] and _in[v]. */
+        void contract(node_t v)
+        {
+            for (const auto& s : this->_shortcuts)
+            {
+                this->add_arc(s.tail, s.head, s.weight, v);
+            }
+            const auto drop = [v](std::vector<Arc>& arcs) {
+                arcs.erase(std::remove_if(arcs.begin(), arcs.end(),
+                               [v](const Arc& a) { return a.node == v; }),
+                    arcs.end());
+            };
+            for (const auto& a : this->_out[v])
+            {
+                drop(this->_in[a.node]);
+                ++this->_deleted_neighbors[a.node];
+            }
+            for (const auto& a : this->_in[v])
+            {
+                drop(this->_out[a.node]);
+                ++this->_deleted_neighbors[a.node];
+            }
+        }
+    };
+
+    /*! Store arcs as a CSRGraph plus the middle node of every arc. */
+    static auto _to_search_graph(std::vector<std::vector<Arc>>& rows,
+        std::vector<node_t>& middle) -> graph_t
+    {
+        auto offsets = std::vector<std::size_t> {0};
+        auto targets = std::vector<node_t> {};
+        auto weights = std::vector<Dist> {};
+        middle.clear();
+        for (auto& row : rows)
+        {
+            for (const auto& a : row)
+            {
+                targets.push_back(a.node);
+                weights.push_back(a.weight);
+                middle.push_back(a.middle);
+            }
+            offsets.push_back(targets.size());
+            std::vector<Arc> {}.swap(row);
+        }
+        return graph_t {
+            std::move(offsets), std::move(targets), std::move(weights)};
+    }
+
+  public:
+    ContractionHierarchy() = default;
+
+    template <typename CSR>
+    explicit ContractionHierarchy(
+        const CSR& G, std::size_t witness_limit = 500)
+        : _rank(G.number_of_nodes(), none)
+    {
+        const auto n = node_t(G.number_of_nodes());
+        auto builder = Builder {n, witness_limit};
+        for (auto u = node_t(0); u != n; ++u)
+        {
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                const auto w = Dist(G.weight(e));
+                assert(!(w < Dist(0)));
+                if (G.target(e) != u)
+                {
+                    builder.add_arc(u, G.target(e), w, none);
+                }
+            }
+        }
+
+        // lazy updates: a node is contracted only if its recomputed
+        // priority is still the smallest; entries whose key is no longer
+        // the node's current one are stale
+        auto queue = DaryHeap<std::int64_t, node_t> {};
+        auto keys = std::vector<std::int64_t>(n);
+        for (auto v = node_t(0); v != n; ++v)
+        {
+            keys[v] = builder.priority(v);
+            queue.push(keys[v], v);
+        }
+        auto order = node_t(0);
+        auto neighbors = std::vector<node_t> {};
+        while (!queue.empty())
+        {
+            const auto [key, v] = queue.pop();
+            if (this->_rank[v] != none || key != keys[v])
+            {
+                continue;
+            }
+            keys[v] = builder.priority(v);
+            if (!queue.empty() && queue.top().first < keys[v])
+            {
+                queue.push(keys[v], v);
+                continue;
+            }
+            builder.contract(v);
+            this->_rank[v] = order++;
+            neighbors.clear();
+            for (const auto& a : builder._out[v])
+            {
+                neighbors.push_back(a.node);
+            }
+            for (const auto& a : builder._in[v])
+            {
+                neighbors.push_back(a.node);
+            }
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                neighbors.end());
+            for (auto x : neighbors)
+            {
+                const auto p = builder.priority(x);
+                if (p != keys[x])
+                {
+                    keys[x] = p;
+                    queue.push(p, x);
+                }
+            }
+        }
+        this->_up = _to_search_graph(builder._out, this->_up_middle);
+        this->_down = _to_search_graph(builder._in, this->_down_middle);
+    }
+
+    [[nodiscard]] auto number_of_nodes() const -> std::size_t
+    {
+        return this->_rank.size();
+    }
+
+    /*! Return the position of v in the contraction order. */
+    [[nodiscard]] auto rank(node_t v) const -> node_t
+    {
+        return this->_rank[v];
+    }
+
+    [[nodiscard]] auto upward_graph() const -> const graph_t&
+    {
+        return this->_up;
+    }
+
+    [[nodiscard]] auto downward_graph() const -> const graph_t&
+    {
+        return this->_down;
+    }
+
+    /*! Return the number of shortcut arcs. */
+    [[nodiscard]] auto number_of_shortcuts() const -> std::size_t
+    {
+        const auto is_shortcut = [](node_t m) { return m != none; };
+        return std::size_t(std::count_if(this->_up_middle.begin(),
+                   this->_up_middle.end(), is_shortcut))
+            + std::size_t(std::count_if(this->_down_middle.begin(),
+                this->_down_middle.end(), is_shortcut));
+    }
+
+    /*! Return the length of the shortest path from source to target.
+
+        Both searches climb the hierarchy; each stops once its smallest
+        key reaches the best length found, and the searches meet at the
+        highest node of the shortest path.
+
+        Raises
+        ------
+        XNetworkNoPath
+            If no path exists between source and target.
+    */
+    template <typename Workspace>
+    auto path_length(node_t source, node_t target, Workspace& ws) const
+        -> Dist
+    {
+        assert(ws.number_of_nodes() == this->number_of_nodes());
+        auto& fwd = ws._forward;
+        auto& bwd = ws._backward;
+        fwd.reset();
+        bwd.reset();
+        ws._path.clear();
+        fwd._label(source, Dist(0), fwd.none);
+        fwd._heap.push(Dist(0), source);
+        bwd._label(target, Dist(0), bwd.none);
+        bwd._heap.push(Dist(0), target);
+
+        auto best = infinity();
+        auto meet = none;
+        auto forward = true;
+        while (true)
+        {
+            const auto live = [&](const auto& side) {
+                return !side._heap.empty() && side._heap.top().first < best;
+            };
+            if (!live(fwd) && !live(bwd))
+            {
+                break;
+            }
+            if (!live(forward ? fwd : bwd))
+            {
+                forward = !forward;
+            }
+            auto& side = forward ? fwd : bwd;
+            const auto& other = forward ? bwd : fwd;
+            const auto& H = forward ? this->_up : this->_down;
+            forward = !forward;
+
+            const auto [d, u] = side._heap.pop();
+            if (side._dist[u] < d)
+            {
+                continue;
+            }
+            side._settled.push_back(u);
+            if (other.reached(u) && Dist(d + other.dist(u)) < best)
+            {
+                best = Dist(d + other.dist(u));
+                meet = u;
+            }
+            for (auto e = H.edge_begin(u); e != H.edge_end(u); ++e)
+            {
+                const auto v = H.target(e);
+                const auto nd = Dist(d + H.weight(e));
+                if (nd < side._dist[v])
+                {
+                    side._label(v, nd, u);
+                    side._heap.push(nd, v);
+                }
+            }
+        }
+        if (meet == none)
+        {
+            throw XNetworkNoPath("Node " + std::to_string(target)
+                + " not reachable from " + std::to_string(source));
+        }
+        // the path in the hierarchy, shortcuts still packed
+        ws._path = fwd.path_to(meet);
+        for (auto v = bwd.pred(meet); v != none; v = bwd.pred(v))
+        {
+            ws._path.push_back(v);
+        }
+        return best;
+    }
+
+    /*! Return the nodes of the shortest path from source to target in
+        the original graph.  `ws.path()` holds the same path.
+
+        Raises
+        ------
+        XNetworkNoPath
+            If no path exists between source and target.
+    */
+    template <typename Workspace>
+    auto path(node_t source, node_t target, Workspace& ws) const
+        -> std::vector<node_t>
+    {
+        this->path_length(source, target, ws);
+        auto packed = std::vector<node_t> {};
+        packed.swap(ws._path);
+        ws._path.push_back(packed.front());
+        auto stack = std::vector<std::pair<node_t, node_t>> {};
+        for (auto k = packed.size() - 1; k != 0; --k)
+        {
+            stack.emplace_back(packed[k - 1], packed[k]);
+        }
+        while (!stack.empty())
+        {
+            const auto [u, v] = stack.back();
+            stack.pop_back();
+            const auto m = this->_middle(u, v);
+            if (m == none)
+            {
+                ws._path.push_back(v);
+            }
+            else
+            {
+                stack.emplace_back(m, v);
+                stack.emplace_back(u, m);
+            }
+        }
+        return ws._path;
+    }
+
+    /*! Return the matrix of distances from sources to targets.
+
+        A backward upward search from every target leaves (target,
+        distance) entries in a bucket at each node it settles; a forward
+        upward search from every source then only scans the buckets of
+        the nodes it settles.  The searches are spread over the pool.
+
+        Parameters
+        ----------
+        sources, targets : containers of nodes (one source gives a
+            one-to-many query)
+        pool : ThreadPool
+
+        Returns
+        -------
+        DistanceMatrix D with `D(i, j)` the distance from the i-th source
+        to the j-th target, `infinity()` if there is no path.
+    */
+    template <typename Sources, typename Targets>
+    auto table(const Sources& sources, const Targets& targets,
+        ThreadPool& pool) const -> DistanceMatrix<Dist>
+    {
+        const auto src = std::vector<node_t>(sources.begin(), sources.end());
+        const auto tgt = std::vector<node_t>(targets.begin(), targets.end());
+        const auto n = this->number_of_nodes();
+        auto D = DistanceMatrix<Dist> {src.size(), tgt.size()};
+
+        struct Entry
+        {
+            node_t node;
+            node_t column;
+            Dist dist;
+        };
+        auto workspaces = std::vector<DijkstraWorkspace<Dist>> {};
+        workspaces.reserve(pool.size());
+        for (auto t = 0U; t != pool.size(); ++t)
+        {
+            workspaces.emplace_back(n);
+        }
+        auto entries = std::vector<std::vector<Entry>>(pool.size());
+        parallel_for(pool, 0, tgt.size(), 1,
+            [&](unsigned tid, std::size_t j) {
+                auto& ws = workspaces[tid];
+                single_source_dijkstra(this->_down, tgt[j], ws);
+                for (auto u : ws.settled())
+                {
+                    entries[tid].push_back(
+                        Entry {u, node_t(j), ws.dist(u)});
+                }
+            });
+
+        // buckets in CSR form, by counting sort on the node
+        auto offsets = std::vector<std::size_t>(n + 1, 0);
+        for (const auto& part : entries)
+        {
+            for (const auto& x : part)
+            {
+                ++offsets[x.node + 1];
+            }
+        }
+        for (auto i = std::size_t(0); i != n; ++i)
+        {
+            offsets[i + 1] += offsets[i];
+        }
+        auto fill
+            = std::vector<std::size_t>(offsets.begin(), offsets.end() - 1);
+        auto buckets = std::vector<std::pair<node_t, Dist>>(offsets.back());
+        for (const auto& part : entries)
+        {
+            for (const auto& x : part)
+            {
+                buckets[fill[x.node]++] = {x.column, x.dist};
+            }
+        }
+        entries.clear();
+
+        parallel_for(pool, 0, src.size(), 1,
+            [&](unsigned tid, std::size_t i) {
+                auto& ws = workspaces[tid];
+                single_source_dijkstra(this->_up, src[i], ws);
+                auto* row = D.row(i);
+                for (auto u : ws.settled())
+                {
+                    const auto du = ws.dist(u);
+                    for (auto b = offsets[u]; b != offsets[u + 1]; ++b)
+                    {
+                        const auto [j, db] = buckets[b];
+                        row[j] = std::min(row[j], Dist(du + db));
+                    }
+                }
+            });
+        return D;
+    }
+
+    /*! Write the hierarchy to a binary stream. */
+    void save(std::ostream& os) const
+    {
+        const auto header = std::array<std::uint32_t, 3> {
+            _magic, _version, std::uint32_t(sizeof(Dist))};
+        os.write(reinterpret_cast<const char*>(header.data()),
+            sizeof(header));
+        _write(os, this->_rank);
+        for (const auto* H : {&this->_up, &this->_down})
+        {
+            _write(os, H->_offsets);
+            _write(os, H->_targets);
+            _write(os, H->_weights);
+        }
+        _write(os, this->_up_middle);
+        _write(os, this->_down_middle);
+        if (!os)
+        {
+            throw XNetworkError("Failed to write the contraction hierarchy");
+        }
+    }
+
+    /*! Read a hierarchy written by `save`.
+
+        Raises
+        ------
+        XNetworkError
+            If the stream does not hold a hierarchy with this Dist type,
+            or the hierarchy is truncated or inconsistent.
+    */
+    static auto load(std::istream& is) -> ContractionHierarchy
+    {
+        auto header = std::array<std::uint32_t, 3> {};
+        is.read(reinterpret_cast<char*>(header.data()), sizeof(header));
+        if (!is || header[0] != _magic || header[1] != _version
+            || header[2] != sizeof(Dist))
+        {
+            throw XNetworkError("Not a contraction hierarchy file");
+        }
+        auto left = _remaining(is);
+        auto CH = ContractionHierarchy {};
+        _read(is, CH._rank, left);
+        for (auto* H : {&CH._up, &CH._down})
+        {
+            _read(is, H->_offsets, left);
+            _read(is, H->_targets, left);
+            _read(is, H->_weights, left);
+        }
+        _read(is, CH._up_middle, left);
+        _read(is, CH._down_middle, left);
+        if (!is || !CH._consistent())
+        {
+            throw XNetworkError("Corrupt contraction hierarchy file");
+        }
+        return CH;
+    }
+
+  private:
+    static constexpr std::uint32_t _magic = 0x48434e58; // "XNCH"
+    static constexpr std::uint32_t _version = 1;
+
+    /*! Return the middle node of arc (u, v) of the hierarchy, or
+        nullptr if there is no such arc. */
+    [[nodiscard]] auto _find(node_t u, node_t v) const -> const node_t*
+    {
+        const auto up = this->_rank[u] < this->_rank[v];
+        const auto& H = up ? this->_up : this->_down;
+        const auto& middle = up ? this->_up_middle : this->_down_middle;
+        const auto row = up ? u : v;
+        const auto other = up ? v : u;
+        for (auto e = H.edge_begin(row); e != H.edge_end(row); ++e)
+        {
+            if (H.target(e) == other)
+            {
+                return &middle[e];
+            }
+        }
+        return nullptr;
+    }
+
+    /*! Return the middle node of arc (u, v) of the hierarchy. */
+    [[nodiscard]] auto _middle(node_t u, node_t v) const -> node_t
+    {
+        const auto* m = this->_find(u, v);
+        if (m == nullptr)
+        {
+            throw XNetworkError("Arc is not in the contraction hierarchy");
+        }
+        return *m;
+    }
+
+    template <typename T>
+    static void _write(std::ostream& os, const std::vector<T>& v)
+    {
+        const auto size = std::uint64_t(v.size());
+        os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        os.write(reinterpret_cast<const char*>(v.data()),
+            std::streamsize(v.size() * sizeof(T)));
+    }
+
+    /*! Return whether the ranks form a permutation, the search graphs
+        are well-formed CSR graphs over the same nodes and the arcs form
+        a hierarchy, so that queries on a loaded hierarchy stay in bounds
+        and its shortcuts unpack into paths.
+
+        Every arc of both search graphs leads to a higher rank and has a
+        non-negative weight, and every shortcut (u, v) has a middle node
+        m of rank below u and v with arcs (u, m) and (m, v).  The ranks
+        of the arcs thus drop as a shortcut is unpacked. */
+    [[nodiscard]] auto _consistent() const -> bool
+    {
+        const auto n = this->_rank.size();
+        auto seen = std::vector<std::uint8_t>(n, 0);
+        for (auto r : this->_rank)
+        {
+            if (r >= n || seen[r] != 0)
+            {
+                return false;
+            }
+            seen[r] = 1;
+        }
+        const auto valid = [n](const graph_t& H,
+                               const std::vector<node_t>& middle) {
+            const auto& offsets = H._offsets;
+            const auto m = H._targets.size();
+            if (offsets.size() != n + 1 || offsets.front() != 0
+                || offsets.back() != m || H._weights.size() != m
+                || middle.size() != m
+                || !std::is_sorted(offsets.begin(), offsets.end()))
+            {
+                return false;
+            }
+            const auto in_range = [n](node_t v) { return v < n; };
+            return std::all_of(H._targets.begin(), H._targets.end(), in_range)
+                && std::all_of(middle.begin(), middle.end(),
+                    [n](node_t v) { return v < n || v == none; });
+        };
+        if (!valid(this->_up, this->_up_middle)
+            || !valid(this->_down, this->_down_middle))
+        {
+            return false;
+        }
+        const auto& rank = this->_rank;
+        for (const auto up : {true, false})
+        {
+            const auto& H = up ? this->_up : this->_down;
+            const auto& middle = up ? this->_up_middle : this->_down_middle;
+            for (auto r = node_t(0); r != n; ++r)
+            {
+                for (auto e = H.edge_begin(r); e != H.edge_end(r); ++e)
+                {
+                    const auto t = H.target(e);
+                    const auto m = middle[e];
+                    if (!(rank[r] < rank[t]) || !(H.weight(e) >= Dist(0)))
+                    {
+                        return false;
+                    }
+                    if (m == none)
+                    {
+                        continue;
+                    }
+                    const auto u = up ? r : t;
+                    const auto v = up ? t : r;
+                    if (!(rank[m] < rank[r]) || this->_find(u, m) == nullptr
+                        || this->_find(m, v) == nullptr)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    /*! Return the number of bytes left in the stream, or the maximum if
+        it cannot seek. */
+    static auto _remaining(std::istream& is) -> std::uint64_t
+    {
+        const auto unknown = std::numeric_limits<std::uint64_t>::max();
+        const auto pos = is.tellg();
+        if (pos == std::istream::pos_type(-1))
+        {
+            is.clear();
+            return unknown;
+        }
+        is.seekg(0, std::ios::end);
+        const auto end = is.tellg();
+        is.clear();
+        is.seekg(pos);
+        return end < pos ? unknown : std::uint64_t(end - pos);
+    }
+
+    /*! Read a vector written by `_write`.  A size beyond the `left` bytes
+        of the stream throws rather than allocates, and the elements are
+        read in bounded chunks so that a stream which cannot tell its
+        length fails at its end instead. */
+    template <typename T>
+    static void _read(std::istream& is, std::vector<T>& v, std::uint64_t& left)
+    {
+        auto size = std::uint64_t(0);
+        is.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if (!is)
+        {
+            return;
+        }
+        left -= std::min(left, std::uint64_t(sizeof(size)));
+        if (size > left / sizeof(T))
+        {
+            throw XNetworkError("Corrupt contraction hierarchy file");
+        }
+        left -= size * sizeof(T);
+        constexpr auto chunk = std::uint64_t(1) << 16U;
+        v.clear();
+        while (v.size() != size && is)
+        {
+            const auto done = v.size();
+            v.resize(done + std::size_t(std::min(chunk, size - done)));
+            is.read(reinterpret_cast<char*>(v.data() + done),
+                std::streamsize((v.size() - done) * sizeof(T)));
+        }
+    }
+};
+
+} // namespace xn
@@ -0,0 +1,481 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Parallel single-source shortest paths by delta-stepping.
+
+Delta-stepping (Meyer and Sanders, 2003) replaces Dijkstra's priority
+queue by buckets of width delta.  All nodes of the lowest nonempty bucket
+are relaxed at once, which gives a thread pool plenty of independent work
+per round while settling nodes in almost the same order as Dijkstra.
+Arcs of weight at most delta (light) may reinsert nodes into the current
+bucket and are relaxed until the bucket stays empty; heavier arcs cannot
+and are relaxed only once per bucket, after it is settled.  The rows of
+the graph are split into their light and heavy arcs by `prepare`, once
+per graph and delta, so neither phase scans the arcs of the other.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Per-query state of delta-stepping.
+
+    Distances are atomic so that the threads of a round can relax arcs
+    into the same node.  Every thread owns its bucket array, so inserting
+    a node into a bucket never takes a lock.  The buckets form a cyclic
+    window of `num_buckets` buckets beyond the current one; nodes farther
+    away wait in a per-thread overflow list until the window reaches
+    them.  Epoch markers keep a node from entering the frontier of a round
+    or the settled set of a bucket twice.
+
+    Parameters
+    ----------
+    num_nodes : number of nodes of the graph
+    num_threads : threads of the pool that will run the queries
+*/
+template <typename Dist>
+class DeltaSteppingWorkspace
+{
+  public:
+    using node_t = std::uint32_t;
+    using dist_t = Dist;
+
+    static constexpr std::size_t num_buckets = 128;
+    static constexpr std::size_t no_bucket =
+        std::numeric_limits<std::size_t>::max();
+
+    static constexpr auto infinity() -> Dist
+    {
+        return std::numeric_limits<Dist>::has_infinity
+            ? std::numeric_limits<Dist>::infinity()
+            : std::numeric_limits<Dist>::max();
+    }
+
+    struct alignas(64) PerThread
+    {
+        std::vector<std::vector<node_t>> _buckets;
+        std::vector<node_t> _overflow;
+        std::size_t _overflow_min = no_bucket; // bound on the buckets
+        std::vector<node_t> _settled; // in the current bucket
+        std::vector<node_t> _touched;
+    };
+
+    std::vector<std::atomic<Dist>> _dist;
+    std::vector<PerThread> _threads;
+    std::vector<node_t> _frontier;
+    Dist _delta {1};
+
+    // The rows of the prepared graph with the light arcs first; the light
+    // arcs of u end at _light_end[u].
+    std::vector<std::size_t> _light_end;
+    std::vector<node_t> _heads;
+    std::vector<Dist> _lengths;
+
+    // Epoch at which a node last entered the frontier / the settled set.
+    std::vector<std::uint32_t> _frontier_mark;
+    std::vector<std::uint32_t> _settled_mark;
+    std::uint32_t _epoch = 0;
+
+    DeltaSteppingWorkspace(std::size_t num_nodes, unsigned num_threads)
+        : _dist(num_nodes)
+        , _threads(num_threads)
+        , _frontier_mark(num_nodes, 0)
+        , _settled_mark(num_nodes, 0)
+    {
+        for (auto& d : this->_dist)
+        {
+            d.store(infinity(), std::memory_order_relaxed);
+        }
+        for (auto& t : this->_threads)
+        {
+            t._buckets.resize(num_buckets);
+        }
+    }
+
+    [[nodiscard]] auto number_of_nodes() const -> std::size_t
+    {
+        return this->_dist.size();
+    }
+
+    [[nodiscard]] auto dist(node_t v) const -> Dist
+    {
+        return this->_dist[v].load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto reached(node_t v) const -> bool
+    {
+        return this->dist(v) != infinity();
+    }
+
+    [[nodiscard]] auto number_of_touched() const -> std::size_t
+    {
+        auto count = std::size_t(0);
+        for (const auto& t : this->_threads)
+        {
+            count += t._touched.size();
+        }
+        return count;
+    }
+
+    /*! Forget the last query in O(number of touched nodes). */
+    void reset()
+    {
+        for (auto& t : this->_threads)
+        {
+            for (auto v : t._touched)
+            {
+                this->_dist[v].store(infinity(), std::memory_order_relaxed);
+            }
+            t._touched.clear();
+            for (auto& bucket : t._buckets)
+            {
+                bucket.clear();
+            }
+            t._overflow.clear();
+            t._overflow_min = no_bucket;
+            t._settled.clear();
+        }
+    }
+
+    [[nodiscard]] auto _bucket(Dist d) const -> std::size_t
+    {
+        return static_cast<std::size_t>(d / this->_delta);
+    }
+
+    /*! Prepare the workspace for queries on G with bucket width delta.
+
+        Copies every row of G with its light arcs (weight at most delta)
+        first, in parallel.  The copy is what `delta_stepping(G, source,
+        pool, ws)` searches, so call `prepare` again for every new or
+        modified graph.
+
+        Raises
+        ------
+        XNetworkError
+            If G does not have the number of nodes of the workspace, or
+            delta is not positive.
+    */
+    template <typename CSR>
+    void prepare(const CSR& G, Dist delta, ThreadPool& pool)
+    {
+        const auto n = G.number_of_nodes();
+        const auto m = G.number_of_edges();
+        if (n != this->number_of_nodes())
+        {
+            throw XNetworkError("workspace and graph differ in size");
+        }
+        if (!(Dist(0) < delta))
+        {
+            throw XNetworkError("delta must be positive");
+        }
+        this->_delta = delta;
+        this->_light_end.resize(n);
+        this->_heads.resize(m);
+        this->_lengths.resize(m);
+        parallel_for(pool, 0, n, 256, [&](unsigned, std::size_t u) {
+            auto light = G.edge_begin(node_t(u));
+            auto heavy = G.edge_end(node_t(u));
+            for (auto e = light; e != G.edge_end(node_t(u)); ++e)
+            {
+                const auto w = Dist(G.weight(e));
+                const auto k = delta < w ? --heavy : light++;
+                this->_heads[k] = node_t(G.target(e));
+                this->_lengths[k] = w;
+            }
+            this->_light_end[u] = light;
+        });
+    }
+
+    /*! Start a new epoch for the frontier and settled markers. */
+    auto _next_epoch() -> std::uint32_t
+    {
+        if (++this->_epoch == 0)
+        {
+            std::fill(
+                this->_frontier_mark.begin(), this->_frontier_mark.end(), 0);
+            std::fill(
+                this->_settled_mark.begin(), this->_settled_mark.end(), 0);
+            this->_epoch = 1;
+        }
+        return this->_epoch;
+    }
+
+    /*! Lower the distance of v to d; return false if it was not lower.
+        Called concurrently by thread tid while bucket cur is processed. */
+    auto _relax(unsigned tid, std::size_t cur, node_t v, Dist d) -> bool
+    {
+        auto old = this->_dist[v].load(std::memory_order_relaxed);
+        do
+        {
+            if (!(d < old))
+            {
+                return false;
+            }
+        } while (!this->_dist[v].compare_exchange_weak(
+            old, d, std::memory_order_relaxed));
+        auto& t = this->_threads[tid];
+        if (old == infinity())
+        {
+            t._touched.push_back(v);
+        }
+        const auto b = this->_bucket(d);
+        if (b - cur < num_buckets)
+        {
+            t._buckets[b % num_buckets].push_back(v);
+        }
+        else
+        {
+            t._overflow.push_back(v);
+            t._overflow_min = std::min(t._overflow_min, b);
+        }
+        return true;
+    }
+
+    /*! Move bucket cur of all threads into the frontier, dropping stale
+        and duplicate entries. */
+    auto _gather(std::size_t cur) -> bool
+    {
+        const auto epoch = this->_next_epoch();
+        this->_frontier.clear();
+        for (auto& t : this->_threads)
+        {
+            auto& bucket = t._buckets[cur % num_buckets];
+            for (auto v : bucket)
+            {
+                if (this->_frontier_mark[v] != epoch
+                    && this->_bucket(this->dist(v)) == cur)
+                {
+                    this->_frontier_mark[v] = epoch;
+                    this->_frontier.push_back(v);
+                }
+            }
+            bucket.clear();
+        }
+        return !this->_frontier.empty();
+    }
+
+    /*! Move the settled nodes of all threads into the frontier, each node
+        once although it may have been settled in several rounds. */
+    void _gather_settled()
+    {
+        const auto epoch = this->_next_epoch();
+        this->_frontier.clear();
+        for (auto& t : this->_threads)
+        {
+            for (auto v : t._settled)
+            {
+                if (this->_settled_mark[v] != epoch)
+                {
+                    this->_settled_mark[v] = epoch;
+                    this->_frontier.push_back(v);
+                }
+            }
+            t._settled.clear();
+        }
+    }
+
+    /*! Move the overflow entries that fall into the window starting at
+        bucket cur into their buckets.  Entries below cur are stale: the
+        node improved since and has been settled. */
+    void _flush_overflow(std::size_t cur)
+    {
+        for (auto& t : this->_threads)
+        {
+            auto kept = std::size_t(0);
+            t._overflow_min = no_bucket;
+            for (auto v : t._overflow)
+            {
+                const auto b = this->_bucket(this->dist(v));
+                if (b < cur)
+                {
+                    continue;
+                }
+                if (b - cur < num_buckets)
+                {
+                    t._buckets[b % num_buckets].push_back(v);
+                    continue;
+                }
+                t._overflow[kept++] = v;
+                t._overflow_min = std::min(t._overflow_min, b);
+            }
+            t._overflow.resize(kept);
+        }
+    }
+
+    [[nodiscard]] auto _overflow_min() const -> std::size_t
+    {
+        auto lowest = no_bucket;
+        for (const auto& t : this->_threads)
+        {
+            lowest = std::min(lowest, t._overflow_min);
+        }
+        return lowest;
+    }
+
+    /*! Advance cur to the lowest nonempty bucket; return false if there
+        is none. */
+    auto _next_bucket(std::size_t& cur) -> bool
+    {
+        while (true)
+        {
+            if (this->_overflow_min() < cur + num_buckets)
+            {
+                this->_flush_overflow(cur);
+            }
+            for (auto b = cur; b != cur + num_buckets; ++b)
+            {
+                for (const auto& t : this->_threads)
+                {
+                    if (!t._buckets[b % num_buckets].empty())
+                    {
+                        cur = b;
+                        return true;
+                    }
+                }
+            }
+            cur = this->_overflow_min(); // the window has run empty
+            if (cur == no_bucket)
+            {
+                return false;
+            }
+        }
+    }
+};
+
+/*! Compute shortest path lengths from a source by parallel
+    delta-stepping.
+
+    Parameters
+    ----------
+    G : CSRGraph with non-negative weights
+    source : starting node
+    delta : bucket width, see `default_delta`
+    pool : ThreadPool
+    ws : DeltaSteppingWorkspace sized for G and for the pool; reset first.
+        Without delta, ws must have been prepared for G (see
+        `DeltaSteppingWorkspace::prepare`), which saves splitting the rows
+        of G on every query.
+
+    Returns
+    -------
+    The workspace holds the results: `ws.dist(v)` equals the distance
+    Dijkstra computes.
+
+    Notes
+    -----
+    A small delta settles nodes nearly in Dijkstra order but leaves little
+    work per round; a large delta gives more parallelism but relaxes arcs
+    into nodes that improve again later.  Rounds with few nodes run on
+    the calling thread alone.
+
+    Raises
+    ------
+    XNetworkError
+        If delta is not positive, or ws is not sized for G or, without
+        delta, was not prepared for a graph of the size of G.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {8};
+    >>> auto ws = xn::DeltaSteppingWorkspace<int> {C.number_of_nodes(), 8};
+    >>> xn::delta_stepping(C, 0U, xn::default_delta(C), pool, ws);
+    >>> ws.prepare(C, xn::default_delta(C), pool);  // many queries
+    >>> xn::delta_stepping(C, 7U, pool, ws);
+*/
+template <typename CSR, typename Dist>
+void delta_stepping(const CSR& G,
+    typename DeltaSteppingWorkspace<Dist>::node_t source, ThreadPool& pool,
+    DeltaSteppingWorkspace<Dist>& ws)
+{
+    if (ws.number_of_nodes() != G.number_of_nodes()
+        || ws._light_end.size() != G.number_of_nodes()
+        || ws._heads.size() != G.number_of_edges())
+    {
+        throw XNetworkError("workspace is not prepared for the graph");
+    }
+    assert(ws._threads.size() >= pool.size());
+    constexpr auto grain = std::size_t(64);
+
+    ws.reset();
+    auto cur = std::size_t(0);
+    ws._relax(0, cur, source, Dist(0));
+    while (ws._next_bucket(cur))
+    {
+        while (ws._gather(cur))
+        {
+            parallel_for(pool, 0, ws._frontier.size(), grain,
+                [&](unsigned tid, std::size_t i) {
+                    const auto u = ws._frontier[i];
+                    const auto du = ws.dist(u);
+                    ws._threads[tid]._settled.push_back(u);
+                    for (auto k = G.edge_begin(u); k != ws._light_end[u]; ++k)
+                    {
+                        ws._relax(tid, cur, ws._heads[k],
+                            Dist(du + ws._lengths[k]));
+                    }
+                });
+        }
+        ws._gather_settled();
+        parallel_for(pool, 0, ws._frontier.size(), grain,
+            [&](unsigned tid, std::size_t i) {
+                const auto u = ws._frontier[i];
+                const auto du = ws.dist(u);
+                for (auto k = ws._light_end[u]; k != G.edge_end(u); ++k)
+                {
+                    ws._relax(
+                        tid, cur, ws._heads[k], Dist(du + ws._lengths[k]));
+                }
+            });
+    }
+}
+
+template <typename CSR, typename Dist>
+void delta_stepping(const CSR& G,
+    typename DeltaSteppingWorkspace<Dist>::node_t source, Dist delta,
+    ThreadPool& pool, DeltaSteppingWorkspace<Dist>& ws)
+{
+    ws.prepare(G, delta, pool);
+    delta_stepping(G, source, pool, ws);
+}
+
+/*! Return a bucket width suited to G: the maximum weight divided by the
+    average degree, the choice Meyer and Sanders suggest for random
+    weights.  Integer widths are at least 1. */
+template <typename CSR>
+auto default_delta(const CSR& G) -> typename CSR::weight_t
+{
+    using Weight = typename CSR::weight_t;
+    auto max_weight = Weight(0);
+    for (auto e = std::size_t(0); e != G.number_of_edges(); ++e)
+    {
+        max_weight = std::max(max_weight, Weight(G.weight(e)));
+    }
+    if (!(Weight(0) < max_weight))
+    {
+        return Weight(1);
+    }
+    const auto degree =
+        double(G.number_of_edges()) / double(G.number_of_nodes());
+    const auto delta = Weight(double(max_weight) / std::max(degree, 1.0));
+    if constexpr (std::is_integral_v<Weight>)
+    {
+        return std::max(delta, Weight(1));
+    }
+    else
+    {
+        return delta;
+    }
+}
+
+} // namespace xn
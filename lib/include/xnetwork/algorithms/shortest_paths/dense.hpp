@@ -0,0 +1,358 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Dense distance matrices for the native all-pairs shortest path algorithms,
+and a blocked, parallel Floyd-Warshall on them.
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! A row-major matrix of distances.
+
+    Row `i` holds the distances from the i-th source of a block of sources
+    (`first_source() + i`) to every node, so the distances of a graph too
+    large for a full n x n matrix can be computed one block of rows at a
+    time.  Unreachable entries hold `infinity()`.
+
+    Parameters
+    ----------
+    rows : number of sources in the block
+    cols : number of nodes
+    first_source : node of row 0 (default: 0)
+*/
+template <typename Dist>
+class DistanceMatrix
+{
+  public:
+    using dist_t = Dist;
+
+    static constexpr auto infinity() -> Dist
+    {
+        return std::numeric_limits<Dist>::has_infinity
+            ? std::numeric_limits<Dist>::infinity()
+            : std::numeric_limits<Dist>::max();
+    }
+
+  private:
+    std::size_t _rows;
+    std::size_t _cols;
+    std::size_t _first_source;
+    std::vector<Dist> _data;
+
+  public:
+    DistanceMatrix(
+        std::size_t rows, std::size_t cols, std::size_t first_source = 0)
+        : _rows {rows}
+        , _cols {cols}
+        , _first_source {first_source}
+        , _data(rows * cols, infinity())
+    {
+    }
+
+    [[nodiscard]] auto rows() const -> std::size_t
+    {
+        return this->_rows;
+    }
+
+    [[nodiscard]] auto cols() const -> std::size_t
+    {
+        return this->_cols;
+    }
+
+    [[nodiscard]] auto first_source() const -> std::size_t
+    {
+        return this->_first_source;
+    }
+
+    /*! Return the distance from source `first_source() + i` to node j. */
+    auto operator()(std::size_t i, std::size_t j) const -> const Dist&
+    {
+        assert(i < this->_rows && j < this->_cols);
+        return this->_data[i * this->_cols + j];
+    }
+
+    auto operator()(std::size_t i, std::size_t j) -> Dist&
+    {
+        assert(i < this->_rows && j < this->_cols);
+        return this->_data[i * this->_cols + j];
+    }
+
+    [[nodiscard]] auto row(std::size_t i) const -> const Dist*
+    {
+        return this->_data.data() + i * this->_cols;
+    }
+
+    [[nodiscard]] auto row(std::size_t i) -> Dist*
+    {
+        return this->_data.data() + i * this->_cols;
+    }
+
+    [[nodiscard]] auto data() -> Dist*
+    {
+        return this->_data.data();
+    }
+
+    [[nodiscard]] auto data() const -> const Dist*
+    {
+        return this->_data.data();
+    }
+};
+
+/*! Matrix of shortest path predecessors: entry (i, j) is the node
+    before j on a shortest path from i, or `infinity()` (no predecessor)
+    if j == i or j is not reachable from i. */
+using PredecessorMatrix = DistanceMatrix<std::uint32_t>;
+
+/*! Return the n x n matrix of arc weights of G.
+
+    Diagonal entries are 0, entries without an arc `infinity()`; of
+    parallel arcs the lightest one is kept.
+
+    Parameters
+    ----------
+    G : CSRGraph
+*/
+template <typename Dist, typename CSR>
+auto to_distance_matrix(const CSR& G) -> DistanceMatrix<Dist>
+{
+    const auto n = std::size_t(G.number_of_nodes());
+    auto D = DistanceMatrix<Dist> {n, n};
+    for (auto u = std::size_t(0); u != n; ++u)
+    {
+        D(u, u) = Dist(0);
+        for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+        {
+            auto& d = D(u, G.target(e));
+            d = std::min(d, Dist(G.weight(e)));
+        }
+    }
+    return D;
+}
+
+/*! Relax row i of a tile through node k: di[j] = min(di[j], dik + dk[j]).
+
+    Written as straight-line selects so that the compiler turns the loop
+    into SIMD min/blend instructions. */
+template <typename Dist>
+void _min_plus_row(
+    Dist* di, const Dist* dk, Dist dik, std::size_t len)
+{
+    constexpr auto inf = DistanceMatrix<Dist>::infinity();
+    for (auto j = std::size_t(0); j != len; ++j)
+    {
+        const auto dkj = dk[j];
+        const auto nd = std::numeric_limits<Dist>::has_infinity
+            ? Dist(dik + dkj)
+            : (dkj == inf ? inf : Dist(dik + dkj));
+        di[j] = nd < di[j] ? nd : di[j];
+    }
+}
+
+template <typename Dist, typename Pred>
+void _min_plus_row(Dist* di, Pred* pi, const Dist* dk, const Pred* pk,
+    Dist dik, std::size_t len)
+{
+    constexpr auto inf = DistanceMatrix<Dist>::infinity();
+    for (auto j = std::size_t(0); j != len; ++j)
+    {
+        const auto dkj = dk[j];
+        const auto nd = std::numeric_limits<Dist>::has_infinity
+            ? Dist(dik + dkj)
+            : (dkj == inf ? inf : Dist(dik + dkj));
+        const auto better = nd < di[j];
+        di[j] = better ? nd : di[j];
+        pi[j] = better ? pk[j] : pi[j];
+    }
+}
+
+/*! Run the pivots `[k0, k1)` over the tile `[i0, i1) x [j0, j1)`. */
+template <typename Dist>
+void _floyd_warshall_tile(DistanceMatrix<Dist>& D, PredecessorMatrix* P,
+    std::size_t i0, std::size_t i1, std::size_t j0, std::size_t j1,
+    std::size_t k0, std::size_t k1)
+{
+    for (auto k = k0; k != k1; ++k)
+    {
+        const auto* dk = D.row(k) + j0;
+        for (auto i = i0; i != i1; ++i)
+        {
+            const auto dik = D(i, k);
+            if (dik == D.infinity())
+            {
+                continue;
+            }
+            if (P == nullptr)
+            {
+                _min_plus_row(D.row(i) + j0, dk, dik, j1 - j0);
+            }
+            else
+            {
+                _min_plus_row(D.row(i) + j0, P->row(i) + j0, dk,
+                    P->row(k) + j0, dik, j1 - j0);
+            }
+        }
+    }
+}
+
+template <typename Dist>
+void _floyd_warshall(DistanceMatrix<Dist>& D, PredecessorMatrix* P,
+    ThreadPool& pool, std::size_t block_size)
+{
+    const auto n = D.rows();
+    assert(D.cols() == n && D.first_source() == 0);
+    const auto b = std::max(block_size, std::size_t(1));
+    const auto num_blocks = (n + b - 1) / b;
+    const auto lo = [&](std::size_t t) { return t * b; };
+    const auto hi = [&](std::size_t t) { return std::min(n, t * b + b); };
+
+    for (auto kb = std::size_t(0); kb != num_blocks; ++kb)
+    {
+        const auto k0 = lo(kb);
+        const auto k1 = hi(kb);
+        // phase 1: the diagonal tile depends only on itself.  A negative
+        // cycle whose largest node is k shows as D(k, k) < 0 before pivot
+        // k runs; until then every entry is the length of a simple path,
+        // so the cycle is reported before the entries can overflow.
+        for (auto k = k0; k != k1; ++k)
+        {
+            if (D(k, k) < Dist(0))
+            {
+                throw XNetworkUnbounded("Negative cost cycle detected.");
+            }
+            _floyd_warshall_tile(D, P, k0, k1, k0, k1, k, k + 1);
+        }
+        // phase 2: the tiles in row and column kb
+        parallel_for(pool, 0, 2 * num_blocks, 1,
+            [&](unsigned, std::size_t t) {
+                const auto other = t / 2;
+                if (other == kb)
+                {
+                    return;
+                }
+                if (t % 2 == 0)
+                {
+                    _floyd_warshall_tile(
+                        D, P, k0, k1, lo(other), hi(other), k0, k1);
+                }
+                else
+                {
+                    _floyd_warshall_tile(
+                        D, P, lo(other), hi(other), k0, k1, k0, k1);
+                }
+            });
+        // phase 3: all remaining tiles are independent of each other
+        parallel_for(pool, 0, num_blocks * num_blocks, 1,
+            [&](unsigned, std::size_t t) {
+                const auto ib = t / num_blocks;
+                const auto jb = t % num_blocks;
+                if (ib == kb || jb == kb)
+                {
+                    return;
+                }
+                _floyd_warshall_tile(
+                    D, P, lo(ib), hi(ib), lo(jb), hi(jb), k0, k1);
+            });
+    }
+    for (auto i = std::size_t(0); i != n; ++i)
+    {
+        if (D(i, i) < Dist(0))
+        {
+            throw XNetworkUnbounded("Negative cost cycle detected.");
+        }
+    }
+}
+
+/*! Compute all-pairs shortest path lengths in place by Floyd-Warshall.
+
+    The matrix is processed in square tiles of `block_size` rows, small
+    enough that the three tiles a step works on stay in cache.  For each
+    diagonal tile the algorithm updates the tile itself, then its row and
+    column of tiles, then all other tiles; the tiles of the last two
+    steps are spread over the pool.
+
+    Parameters
+    ----------
+    D : n x n DistanceMatrix holding the arc weights on entry (see
+        `to_distance_matrix`) and the distances on return
+    pool : ThreadPool
+    block_size : tile side (default: 64)
+
+    Raises
+    ------
+    XNetworkUnbounded
+        If the graph has a negative cycle.
+
+    Notes
+    -----
+    Floyd's algorithm is appropriate for finding shortest paths in dense
+    graphs or graphs with negative weights when Dijkstra's algorithm
+    fails.  It has running time $O(n^3)$ with running space of $O(n^2)$.
+
+    Examples
+    --------
+    >>> auto D = xn::to_distance_matrix<int>(C);
+    >>> auto pool = xn::ThreadPool {};
+    >>> xn::floyd_warshall(D, pool);
+*/
+template <typename Dist>
+void floyd_warshall(
+    DistanceMatrix<Dist>& D, ThreadPool& pool, std::size_t block_size = 64)
+{
+    _floyd_warshall(D, static_cast<PredecessorMatrix*>(nullptr), pool,
+        block_size);
+}
+
+/*! Compute all-pairs shortest path lengths and predecessors in place.
+
+    As `floyd_warshall`, and P, an n x n PredecessorMatrix, receives the
+    predecessors (see `reconstruct_path`).
+*/
+template <typename Dist>
+void floyd_warshall_predecessor_and_distance(DistanceMatrix<Dist>& D,
+    PredecessorMatrix& P, ThreadPool& pool, std::size_t block_size = 64)
+{
+    const auto n = D.rows();
+    assert(P.rows() == n && P.cols() == n);
+    for (auto i = std::size_t(0); i != n; ++i)
+    {
+        for (auto j = std::size_t(0); j != n; ++j)
+        {
+            P(i, j) = i != j && D(i, j) != D.infinity()
+                ? std::uint32_t(i)
+                : P.infinity();
+        }
+    }
+    _floyd_warshall(D, &P, pool, block_size);
+}
+
+/*! Return the nodes of the shortest path from source to target, or an
+    empty list if there is none. */
+inline auto reconstruct_path(std::uint32_t source, std::uint32_t target,
+    const PredecessorMatrix& P) -> std::vector<std::uint32_t>
+{
+    auto path = std::vector<std::uint32_t> {};
+    if (source != target && P(source, target) == P.infinity())
+    {
+        return path;
+    }
+    for (auto v = target; v != source; v = P(source, v))
+    {
+        path.push_back(v);
+    }
+    path.push_back(source);
+    return {path.rbegin(), path.rend()};
+}
+
+} // namespace xn
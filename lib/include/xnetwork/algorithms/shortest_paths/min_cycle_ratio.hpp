@@ -0,0 +1,726 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native minimum cycle ratio and minimum mean cycle solvers on `DiGraphS`.
+
+The ratio of a cycle C is `cost(C) / time(C)`, the sums of the costs and
+of the (positive) times of its edges; with all times 1 it is the mean
+cost of C.  Like `negCycleFinder`, a solver indexes the nodes and edges
+of a graph once and reads the costs and times through callables on every
+call, so it can be run again after the weights change.
+
+The ratio type may be `double` or an exact type such as
+`fun::Fraction<int>`; integer costs and times are converted to it.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <py2cpp/py2cpp.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/heaps.hpp>
+
+namespace xn
+{
+
+/*! Find cycles of minimum ratio of a weighted directed graph.
+
+    Three algorithms are provided:
+
+    - `howard`: policy iteration (Cochet-Terrasson et al., 1998), the
+      fastest in practice (Dasdan, 2004).  The policy found by a call is
+      kept and is the starting point of the next call (a warm start), so
+      re-solving after a small change of the weights needs few rounds.
+    - `karp`: Karp's O(n m) dynamic program for the minimum mean cycle,
+      with O(n^2) memory.
+    - `young_tarjan_orlin`: parametric shortest paths (Young, Tarjan and
+      Orlin, 1991), which pivots one arc at a time into a shortest path
+      tree while the ratio rises.
+
+    Parameters
+    ----------
+    G : DiGraphS (or any graph with `G[u]` iterating the successors of u)
+    Ratio : type of the ratios and potentials (default: double)
+
+    Returns
+    -------
+    Every method returns a pair `(ratio, cycle)`: the minimum ratio and
+    the edges of a cycle attaining it, in path order.
+
+    Raises
+    ------
+    XNetworkNoCycle
+        If the graph is acyclic.
+
+    Examples
+    --------
+    >>> auto get_cost = [&](const auto& e) { return G[e.first][e.second]; };
+    >>> auto get_time = [](const auto&) { return 1; };
+    >>> auto S = xn::MinCycleRatioSolver<decltype(G), Fraction<int>>(G);
+    >>> auto [ratio, cycle] = S.howard(get_cost, get_time);
+*/
+template <typename Graph, typename Ratio = double>
+class MinCycleRatioSolver
+{
+  public:
+    using Node = typename Graph::Node;
+    using edge_t = typename Graph::edge_t;
+    using Cycle = std::vector<edge_t>;
+    using Result = std::pair<Ratio, Cycle>;
+
+  private:
+    using index_t = std::uint32_t;
+
+    static constexpr index_t none = std::numeric_limits<index_t>::max();
+
+    std::vector<Node> _nodes;
+    std::vector<std::size_t> _offsets; // out-arcs of node i
+    std::vector<index_t> _sources;     // per arc
+    std::vector<index_t> _targets;     // per arc
+    std::vector<edge_t> _edges;        // per arc, handed to the callables
+    std::vector<std::size_t> _in_offsets;
+    std::vector<index_t> _in_arcs; // arcs sorted by target
+    std::vector<Ratio> _cost;      // per arc, reloaded on every call
+    std::vector<Ratio> _time;
+    std::vector<index_t> _mark;
+    std::vector<char> _alive; // lies on or reaches a cycle
+
+    // Howard: the out-arc chosen by every node, the ratio of the policy
+    // cycle it reaches and its potential
+    std::vector<index_t> _policy;
+    std::vector<Ratio> _value;
+    std::vector<Ratio> _dist;
+    std::vector<std::size_t> _policy_offsets; // policy arcs by target
+    std::vector<index_t> _policy_sources;
+
+  public:
+    explicit MinCycleRatioSolver(const Graph& G)
+    {
+        auto index = py::dict<Node, index_t> {};
+        for (auto&& v : G)
+        {
+            index[v] = index_t(this->_nodes.size());
+            this->_nodes.push_back(v);
+        }
+        const auto n = this->_nodes.size();
+        this->_offsets.reserve(n + 1);
+        this->_offsets.push_back(0);
+        for (auto i = 0U; i != n; ++i)
+        {
+            const auto& u = this->_nodes[i];
+            for (auto&& v : G[u])
+            {
+                this->_sources.push_back(i);
+                this->_targets.push_back(index[v]);
+                this->_edges.emplace_back(u, v);
+            }
+            this->_offsets.push_back(this->_targets.size());
+        }
+        const auto m = this->_targets.size();
+        this->_in_offsets.assign(n + 1, 0);
+        for (auto v : this->_targets)
+        {
+            ++this->_in_offsets[v + 1];
+        }
+        for (auto i = std::size_t(0); i != n; ++i)
+        {
+            this->_in_offsets[i + 1] += this->_in_offsets[i];
+        }
+        this->_in_arcs.resize(m);
+        auto fill = std::vector<std::size_t>(
+            this->_in_offsets.begin(), this->_in_offsets.end() - 1);
+        for (auto e = index_t(0); e != m; ++e)
+        {
+            this->_in_arcs[fill[this->_targets[e]]++] = e;
+        }
+        this->_cost.assign(m, Ratio(0));
+        this->_time.assign(m, Ratio(0));
+        this->_mark.resize(n);
+        this->_alive.resize(n);
+        this->_policy.assign(n, none);
+        this->_value.assign(n, Ratio(0));
+        this->_dist.assign(n, Ratio(0));
+        this->_policy_offsets.resize(n + 1);
+        this->_policy_sources.resize(n);
+    }
+
+    /*! Find a minimum ratio cycle by Howard's policy iteration.
+
+        Every node follows one out-arc, its policy; the policy graph then
+        consists of cycles with trees hanging off them.  Each round gives
+        every node the ratio of the cycle it reaches and a potential
+        relative to that cycle, then switches nodes to arcs that reach a
+        smaller ratio or, failing that, a smaller potential.  When no
+        node switches, the smallest policy cycle is optimal.
+
+        Parameters
+        ----------
+        get_cost : callable mapping an edge `(u, v)` to its cost
+        get_time : callable mapping an edge to its time; every cycle must
+            have a positive total time
+
+        Notes
+        -----
+        The first call starts every node on its cheapest out-arc; later
+        calls start from the policy left by the previous one.
+    */
+    template <typename CostFn, typename TimeFn>
+    auto howard(CostFn&& get_cost, TimeFn&& get_time) -> Result
+    {
+        this->_load(get_cost, get_time);
+        if (!this->_prune())
+        {
+            throw XNetworkNoCycle("No cycle found.");
+        }
+        const auto n = index_t(this->_nodes.size());
+        for (auto u = index_t(0); u != n; ++u)
+        {
+            const auto p = this->_policy[u];
+            if (!this->_alive[u]
+                || (p != none && this->_alive[this->_targets[p]]))
+            {
+                continue; // warm start
+            }
+            this->_policy[u] = none;
+            for (auto e = this->_offsets[u]; e != this->_offsets[u + 1]; ++e)
+            {
+                if (this->_alive[this->_targets[e]]
+                    && (this->_policy[u] == none
+                        || this->_cost[e] < this->_cost[this->_policy[u]]))
+                {
+                    this->_policy[u] = index_t(e);
+                }
+            }
+        }
+
+        auto handles = std::vector<index_t> {};
+        do
+        {
+            this->_evaluate(handles);
+        } while (this->_improve_value() || this->_improve_dist());
+
+        auto best = handles.front();
+        for (auto h : handles)
+        {
+            if (this->_value[h] < this->_value[best])
+            {
+                best = h;
+            }
+        }
+        auto cycle = Cycle {};
+        auto u = best;
+        do
+        {
+            const auto e = this->_policy[u];
+            cycle.push_back(this->_edges[e]);
+            u = this->_targets[e];
+        } while (u != best);
+        return {this->_value[best], std::move(cycle)};
+    }
+
+    /*! Find a minimum mean cycle by Karp's algorithm.
+
+        `D[k][v]`, the least cost of a walk of exactly k arcs ending at v,
+        is computed for k = 0 .. n; the minimum mean is then
+        `min_v max_k (D[n][v] - D[k][v]) / (n - k)`, and a cycle on the
+        n-arc walk to the minimizing node attains it (Karp, 1978).
+
+        Parameters
+        ----------
+        get_cost : callable mapping an edge `(u, v)` to its cost
+    */
+    template <typename CostFn>
+    auto karp(CostFn&& get_cost) -> Result
+    {
+        const auto unit = [](const edge_t&) { return 1; };
+        this->_load(get_cost, unit);
+        const auto n = this->_nodes.size();
+        const auto m = this->_targets.size();
+        // row k holds D[k]; pred[k][v] is the last arc of that walk
+        auto D = std::vector<Ratio>((n + 1) * n, Ratio(0));
+        auto pred = std::vector<index_t>((n + 1) * n, none);
+        auto reached = std::vector<char>((n + 1) * n, 0);
+        std::fill(reached.begin(), reached.begin() + std::ptrdiff_t(n), 1);
+        for (auto k = std::size_t(1); k <= n; ++k)
+        {
+            const auto prev = (k - 1) * n;
+            const auto cur = k * n;
+            for (auto e = std::size_t(0); e != m; ++e)
+            {
+                const auto u = this->_sources[e];
+                const auto v = this->_targets[e];
+                if (!reached[prev + u])
+                {
+                    continue;
+                }
+                const auto d = Ratio(D[prev + u] + this->_cost[e]);
+                if (!reached[cur + v] || d < D[cur + v])
+                {
+                    D[cur + v] = d;
+                    pred[cur + v] = index_t(e);
+                    reached[cur + v] = 1;
+                }
+            }
+        }
+
+        auto best = none;
+        auto lambda = Ratio(0);
+        for (auto v = index_t(0); v != n; ++v)
+        {
+            if (!reached[n * n + v])
+            {
+                continue;
+            }
+            auto worst = Ratio(0);
+            auto first = true;
+            for (auto k = std::size_t(0); k != n; ++k)
+            {
+                if (!reached[k * n + v])
+                {
+                    continue;
+                }
+                const auto mean = Ratio(
+                    (D[n * n + v] - D[k * n + v]) / Ratio(int(n - k)));
+                if (first || worst < mean)
+                {
+                    worst = mean;
+                    first = false;
+                }
+            }
+            if (best == none || worst < lambda)
+            {
+                best = v;
+                lambda = worst;
+            }
+        }
+        if (best == none)
+        {
+            throw XNetworkNoCycle("No cycle found.");
+        }
+
+        // walk back from level n; the first node met twice closes a cycle
+        auto walk = std::vector<index_t>(n + 1);
+        std::fill(this->_mark.begin(), this->_mark.end(), none);
+        auto v = best;
+        auto k = n;
+        while (this->_mark[v] == none)
+        {
+            this->_mark[v] = index_t(k);
+            walk[k] = v;
+            v = this->_sources[pred[k * n + v]];
+            --k;
+        }
+        auto cycle = Cycle {};
+        for (auto j = k + 1; j <= this->_mark[v]; ++j)
+        {
+            cycle.push_back(this->_edges[pred[j * n + walk[j]]]);
+        }
+        return {lambda, std::move(cycle)};
+    }
+
+    /*! Find a minimum ratio cycle by the parametric shortest path
+        algorithm of Young, Tarjan and Orlin.
+
+        With arc weights `cost - lambda * time`, the star from a virtual
+        source is a shortest path tree for lambda small enough.  As
+        lambda rises, the arc whose reduced cost reaches zero first
+        enters the tree, moving the subtree of its head; the first arc
+        whose head is an ancestor of its tail closes a cycle of ratio
+        lambda, which is the minimum.
+
+        Parameters
+        ----------
+        get_cost : callable mapping an edge `(u, v)` to its cost
+        get_time : callable mapping an edge to its time; all times must
+            be positive
+    */
+    template <typename CostFn, typename TimeFn>
+    auto young_tarjan_orlin(CostFn&& get_cost, TimeFn&& get_time) -> Result
+    {
+        this->_load(get_cost, get_time);
+        const auto n = index_t(this->_nodes.size());
+        const auto root = n;
+        // tree over the nodes and the virtual root; C and T are the cost
+        // and time of the tree path to each node
+        auto parent = std::vector<index_t>(n + 1, root);
+        auto parent_arc = std::vector<index_t>(n, none);
+        auto first_child = std::vector<index_t>(n + 1, none);
+        auto next_sibling = std::vector<index_t>(n + 1, none);
+        auto prev_sibling = std::vector<index_t>(n + 1, none);
+        auto C = std::vector<Ratio>(n + 1, Ratio(0));
+        auto T = std::vector<Ratio>(n + 1, Ratio(0));
+        for (auto v = index_t(0); v != n; ++v)
+        {
+            next_sibling[v] = v + 1 == n ? none : v + 1;
+            prev_sibling[v] = v == 0 ? none : v - 1;
+        }
+        first_child[root] = n == 0 ? none : 0;
+
+        const auto key = [&](index_t e, Ratio& lambda) -> bool {
+            const auto u = this->_sources[e];
+            const auto v = this->_targets[e];
+            const auto den = Ratio(T[u] + this->_time[e] - T[v]);
+            if (!(Ratio(0) < den))
+            {
+                return false; // never becomes tight
+            }
+            lambda = Ratio((C[u] + this->_cost[e] - C[v]) / den);
+            return true;
+        };
+        auto heap = DaryHeap<Ratio, index_t> {};
+        auto lambda = Ratio(0);
+        for (auto e = index_t(0); e != this->_targets.size(); ++e)
+        {
+            if (key(e, lambda))
+            {
+                heap.push(lambda, e);
+            }
+        }
+
+        auto subtree = std::vector<index_t> {};
+        while (!heap.empty())
+        {
+            const auto [k, e] = heap.pop();
+            const auto u = this->_sources[e];
+            const auto v = this->_targets[e];
+            if (parent_arc[v] == e || !key(e, lambda) || lambda != k)
+            {
+                continue; // stale entry
+            }
+            auto x = u;
+            while (x != root && x != v)
+            {
+                x = parent[x];
+            }
+            if (x == v)
+            {
+                auto cycle = Cycle {this->_edges[e]};
+                for (auto y = u; y != v; y = parent[y])
+                {
+                    cycle.push_back(this->_edges[parent_arc[y]]);
+                }
+                std::reverse(cycle.begin(), cycle.end());
+                return {k, std::move(cycle)};
+            }
+
+            // move the subtree of v below u
+            const auto p = parent[v];
+            if (prev_sibling[v] != none)
+            {
+                next_sibling[prev_sibling[v]] = next_sibling[v];
+            }
+            else
+            {
+                first_child[p] = next_sibling[v];
+            }
+            if (next_sibling[v] != none)
+            {
+                prev_sibling[next_sibling[v]] = prev_sibling[v];
+            }
+            parent[v] = u;
+            parent_arc[v] = e;
+            prev_sibling[v] = none;
+            next_sibling[v] = first_child[u];
+            if (first_child[u] != none)
+            {
+                prev_sibling[first_child[u]] = v;
+            }
+            first_child[u] = v;
+
+            const auto dC = Ratio(C[u] + this->_cost[e] - C[v]);
+            const auto dT = Ratio(T[u] + this->_time[e] - T[v]);
+            subtree.assign(1, v);
+            for (auto i = std::size_t(0); i != subtree.size(); ++i)
+            {
+                const auto y = subtree[i];
+                C[y] = Ratio(C[y] + dC);
+                T[y] = Ratio(T[y] + dT);
+                this->_mark[y] = v;
+                for (auto c = first_child[y]; c != none; c = next_sibling[c])
+                {
+                    subtree.push_back(c);
+                }
+            }
+            // only arcs with one end in the subtree change their keys
+            for (auto y : subtree)
+            {
+                for (auto a = this->_offsets[y]; a != this->_offsets[y + 1];
+                     ++a)
+                {
+                    if (this->_mark[this->_targets[a]] != v
+                        && key(index_t(a), lambda))
+                    {
+                        heap.push(lambda, index_t(a));
+                    }
+                }
+                for (auto i = this->_in_offsets[y];
+                     i != this->_in_offsets[y + 1]; ++i)
+                {
+                    const auto a = this->_in_arcs[i];
+                    if (this->_mark[this->_sources[a]] != v && key(a, lambda))
+                    {
+                        heap.push(lambda, a);
+                    }
+                }
+            }
+            for (auto y : subtree)
+            {
+                this->_mark[y] = none;
+            }
+        }
+        throw XNetworkNoCycle("No cycle found.");
+    }
+
+  private:
+    template <typename CostFn, typename TimeFn>
+    void _load(CostFn& get_cost, TimeFn& get_time)
+    {
+        for (auto e = std::size_t(0); e != this->_edges.size(); ++e)
+        {
+            this->_cost[e] = Ratio(get_cost(this->_edges[e]));
+            this->_time[e] = Ratio(get_time(this->_edges[e]));
+        }
+        std::fill(this->_mark.begin(), this->_mark.end(), none);
+    }
+
+    /*! Drop the nodes that reach no cycle; return false if none is
+        left.  `_mark` counts the live out-arcs. */
+    auto _prune() -> bool
+    {
+        const auto n = index_t(this->_nodes.size());
+        auto queue = std::vector<index_t> {};
+        for (auto u = index_t(0); u != n; ++u)
+        {
+            this->_alive[u] = 1;
+            this->_mark[u] = index_t(this->_offsets[u + 1] - this->_offsets[u]);
+            if (this->_mark[u] == 0)
+            {
+                queue.push_back(u);
+            }
+        }
+        for (auto i = std::size_t(0); i != queue.size(); ++i)
+        {
+            const auto v = queue[i];
+            this->_alive[v] = 0;
+            for (auto j = this->_in_offsets[v]; j != this->_in_offsets[v + 1];
+                 ++j)
+            {
+                const auto u = this->_sources[this->_in_arcs[j]];
+                if (--this->_mark[u] == 0)
+                {
+                    queue.push_back(u);
+                }
+            }
+        }
+        return queue.size() != n;
+    }
+
+    /*! Compute the ratio and potential of every live node under the
+        current policy; `handles` receives one node per policy cycle. */
+    void _evaluate(std::vector<index_t>& handles)
+    {
+        const auto n = index_t(this->_nodes.size());
+        // policy arcs by target, to walk the trees away from the cycles
+        std::fill(
+            this->_policy_offsets.begin(), this->_policy_offsets.end(), 0);
+        for (auto u = index_t(0); u != n; ++u)
+        {
+            if (this->_alive[u])
+            {
+                ++this->_policy_offsets[this->_targets[this->_policy[u]] + 1];
+            }
+        }
+        for (auto i = index_t(0); i != n; ++i)
+        {
+            this->_policy_offsets[i + 1] += this->_policy_offsets[i];
+        }
+        auto fill = std::vector<std::size_t>(
+            this->_policy_offsets.begin(), this->_policy_offsets.end() - 1);
+        for (auto u = index_t(0); u != n; ++u)
+        {
+            if (this->_alive[u])
+            {
+                this->_policy_sources[fill[this->_targets[this->_policy[u]]]++]
+                    = u;
+            }
+        }
+
+        handles.clear();
+        std::fill(this->_mark.begin(), this->_mark.end(), none);
+        for (auto s = index_t(0); s != n; ++s)
+        {
+            auto v = s;
+            while (this->_alive[v] && this->_mark[v] == none)
+            {
+                this->_mark[v] = s;
+                v = this->_targets[this->_policy[v]];
+            }
+            if (this->_alive[v] && this->_mark[v] == s)
+            {
+                handles.push_back(v);
+            }
+        }
+
+        auto queue = std::vector<index_t> {};
+        for (auto h : handles)
+        {
+            auto cost = Ratio(0);
+            auto time = Ratio(0);
+            auto u = h;
+            do
+            {
+                const auto e = this->_policy[u];
+                cost = Ratio(cost + this->_cost[e]);
+                time = Ratio(time + this->_time[e]);
+                u = this->_targets[e];
+            } while (u != h);
+            if (!(Ratio(0) < time))
+            {
+                throw XNetworkError("Cycle with non-positive total time.");
+            }
+            const auto lambda = Ratio(cost / time);
+            this->_value[h] = lambda;
+            this->_dist[h] = Ratio(0);
+            queue.assign(1, h);
+            for (auto i = std::size_t(0); i != queue.size(); ++i)
+            {
+                const auto v = queue[i];
+                for (auto j = this->_policy_offsets[v];
+                     j != this->_policy_offsets[v + 1]; ++j)
+                {
+                    const auto w = this->_policy_sources[j];
+                    if (w == h)
+                    {
+                        continue;
+                    }
+                    const auto e = this->_policy[w];
+                    this->_value[w] = lambda;
+                    this->_dist[w] = Ratio(this->_cost[e]
+                        - lambda * this->_time[e] + this->_dist[v]);
+                    queue.push_back(w);
+                }
+            }
+        }
+    }
+
+    /*! Switch nodes to arcs that reach a smaller ratio. */
+    auto _improve_value() -> bool
+    {
+        auto changed = false;
+        for (auto u = index_t(0); u != this->_nodes.size(); ++u)
+        {
+            if (!this->_alive[u])
+            {
+                continue;
+            }
+            auto best = this->_policy[u];
+            for (auto e = this->_offsets[u]; e != this->_offsets[u + 1]; ++e)
+            {
+                const auto v = this->_targets[e];
+                if (this->_alive[v]
+                    && _less(
+                        this->_value[v], this->_value[this->_targets[best]]))
+                {
+                    best = index_t(e);
+                }
+            }
+            if (best != this->_policy[u])
+            {
+                this->_policy[u] = best;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    /*! Switch nodes to arcs that lower their potential within the same
+        ratio. */
+    auto _improve_dist() -> bool
+    {
+        auto changed = false;
+        for (auto u = index_t(0); u != this->_nodes.size(); ++u)
+        {
+            if (!this->_alive[u])
+            {
+                continue;
+            }
+            const auto lambda = this->_value[u];
+            auto best = this->_policy[u];
+            auto best_dist = this->_dist[u];
+            for (auto e = this->_offsets[u]; e != this->_offsets[u + 1]; ++e)
+            {
+                const auto v = this->_targets[e];
+                if (!this->_alive[v] || _less(this->_value[v], lambda)
+                    || _less(lambda, this->_value[v]))
+                {
+                    continue;
+                }
+                const auto d = Ratio(this->_cost[e]
+                    - lambda * this->_time[e] + this->_dist[v]);
+                if (_less(d, best_dist))
+                {
+                    best = index_t(e);
+                    best_dist = d;
+                }
+            }
+            if (best != this->_policy[u])
+            {
+                this->_policy[u] = best;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    /*! a < b, ignoring rounding errors of floating-point potentials. */
+    static auto _less(const Ratio& a, const Ratio& b) -> bool
+    {
+        if constexpr (std::is_floating_point<Ratio>::value)
+        {
+            const auto eps = 64 * std::numeric_limits<Ratio>::epsilon();
+            return a < b - eps * (1 + std::abs(b));
+        }
+        else
+        {
+            return a < b;
+        }
+    }
+};
+
+/*! Return the minimum cycle ratio of G and a cycle attaining it.
+
+    Runs `MinCycleRatioSolver::howard`; see there.
+
+    Examples
+    --------
+    >>> auto [ratio, cycle] = xn::min_cycle_ratio<double>(G, cost, time);
+*/
+template <typename Ratio = double, typename Graph, typename CostFn,
+    typename TimeFn>
+auto min_cycle_ratio(const Graph& G, CostFn&& get_cost, TimeFn&& get_time)
+    -> typename MinCycleRatioSolver<Graph, Ratio>::Result
+{
+    auto S = MinCycleRatioSolver<Graph, Ratio>(G);
+    return S.howard(get_cost, get_time);
+}
+
+/*! Return the minimum mean cost of a cycle of G and a cycle attaining
+    it.
+
+    Runs `MinCycleRatioSolver::howard` with unit times; see there.
+*/
+template <typename Ratio = double, typename Graph, typename CostFn>
+auto min_mean_cycle(const Graph& G, CostFn&& get_cost) ->
+    typename MinCycleRatioSolver<Graph, Ratio>::Result
+{
+    auto S = MinCycleRatioSolver<Graph, Ratio>(G);
+    return S.howard(get_cost, [](const auto&) { return 1; });
+}
+
+} // namespace xn
@@ -0,0 +1,408 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native negative cycle detection on `DiGraphS`.
+
+`negCycleFinder` indexes the nodes and edges of a graph once and can then
+be asked for a negative cycle any number of times.  The edge weights are
+read through a `get_weight(edge)` callable on every call, and the distance
+labels are passed in and handed back, so a caller that modifies a few
+weights between calls can start each search from the potentials found by
+the previous one.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <py2cpp/py2cpp.hpp>
+
+namespace xn
+{
+
+/*! Find negative cycles of a weighted directed graph.
+
+    Both methods treat the graph as if a virtual source were connected to
+    every node `v` by an arc of weight `dist[v]`: starting from all zeros
+    finds a negative cycle anywhere in the graph, and starting from the
+    labels left by a previous call (a warm start) usually needs only a few
+    relaxations after a small change of the weights.
+
+    Parameters
+    ----------
+    G : DiGraphS (or any graph with `G[u]` iterating the successors of u)
+    Dist : type of the distance labels (default: int)
+
+    Notes
+    -----
+    The node and edge sets are copied at construction; a finder must be
+    rebuilt when nodes or edges are added or removed, but not when only
+    weights change.
+
+    Examples
+    --------
+    >>> auto G = xn::DiGraphS {nodes};
+    >>> G.add_edges_from(edges, weights);
+    >>> auto get_weight = [&](const auto& e) { return G[e.first][e.second]; };
+    >>> auto dist = py::dict<std::string, int> {};  // all zeros
+    >>> auto N = xn::negCycleFinder<decltype(G)>(G);
+    >>> auto cycle = N.find_neg_cycle(dist, get_weight);
+*/
+template <typename Graph, typename Dist = int>
+class negCycleFinder
+{
+  public:
+    using Node = typename Graph::Node;
+    using edge_t = typename Graph::edge_t;
+    using Cycle = std::vector<edge_t>;
+
+  private:
+    using index_t = std::uint32_t;
+
+    static constexpr index_t none = std::numeric_limits<index_t>::max();
+
+    std::vector<Node> _nodes;
+    std::vector<std::size_t> _offsets; // out-arcs of node i
+    std::vector<index_t> _sources;     // per arc
+    std::vector<index_t> _targets;     // per arc
+    std::vector<edge_t> _edges;        // per arc, handed to get_weight
+    std::vector<Dist> _weight;         // per arc, reloaded on every call
+    std::vector<Dist> _dist;
+    std::vector<index_t> _pred; // arc into each node, or none
+    std::vector<index_t> _mark;
+
+    // queue-based Bellman-Ford: preorder thread of the shortest path
+    // tree, rooted at the virtual source n
+    std::vector<index_t> _next;
+    std::vector<index_t> _prev;
+    std::vector<index_t> _depth;
+    std::vector<char> _in_tree;
+    std::vector<char> _in_queue;
+    std::vector<index_t> _queue; // ring buffer
+
+  public:
+    explicit negCycleFinder(const Graph& G)
+    {
+        auto index = py::dict<Node, index_t> {};
+        for (auto&& v : G)
+        {
+            index[v] = index_t(this->_nodes.size());
+            this->_nodes.push_back(v);
+        }
+        const auto n = this->_nodes.size();
+        this->_offsets.reserve(n + 1);
+        this->_offsets.push_back(0);
+        for (auto i = 0U; i != n; ++i)
+        {
+            const auto& u = this->_nodes[i];
+            for (auto&& v : G[u])
+            {
+                this->_sources.push_back(i);
+                this->_targets.push_back(index[v]);
+                this->_edges.emplace_back(u, v);
+            }
+            this->_offsets.push_back(this->_targets.size());
+        }
+        this->_weight.resize(this->_targets.size());
+        this->_dist.resize(n);
+        this->_pred.resize(n);
+        this->_mark.resize(n);
+        this->_next.resize(n + 1);
+        this->_prev.resize(n + 1);
+        this->_depth.resize(n + 1);
+        this->_in_tree.resize(n + 1);
+        this->_in_queue.resize(n);
+        this->_queue.resize(n);
+    }
+
+    /*! Find a negative cycle by Howard's policy iteration.
+
+        Every round relaxes all arcs and then looks for a cycle in the
+        policy graph, the graph formed by the arc that last improved each
+        node.  A cycle there is negative, so it is reported as soon as it
+        appears, usually well before Bellman-Ford would need its n-th
+        round.
+
+        Parameters
+        ----------
+        dist : mapping from node to distance label, e.g.
+            `py::dict<Node, Dist>`; read as the starting labels and
+            updated in place
+        get_weight : callable mapping an edge `(u, v)` to its weight
+
+        Returns
+        -------
+        The arcs of a negative cycle in path order, or an empty list if
+        there is none.  In the latter case `dist` holds feasible
+        potentials: `dist[v] <= dist[u] + w(u, v)` for every arc.
+    */
+    template <typename Mapping, typename Callable>
+    auto find_neg_cycle(Mapping& dist, Callable&& get_weight) -> Cycle
+    {
+        this->_load(dist, get_weight);
+        std::fill(this->_pred.begin(), this->_pred.end(), none);
+        auto cycle = Cycle {};
+        while (this->_relax_all())
+        {
+            const auto v = this->_find_policy_cycle();
+            if (v != none)
+            {
+                cycle = this->_policy_cycle(v);
+                break;
+            }
+        }
+        this->_store(dist);
+        return cycle;
+    }
+
+    /*! Find a negative cycle by queue-based Bellman-Ford with subtree
+        disassembly.
+
+        The shortest path tree is kept as a preorder thread.  When a node
+        v improves, its subtree is removed from the tree and the removed
+        nodes are dropped from the queue, since their labels are about to
+        improve anyway.  Meeting the tail of the improving arc inside
+        that subtree closes a negative cycle, which is detected at once
+        instead of after n passes (Tarjan, 1981).
+
+        Parameters and return value are as for `find_neg_cycle`.
+    */
+    template <typename Mapping, typename Callable>
+    auto find_neg_cycle_spfa(Mapping& dist, Callable&& get_weight) -> Cycle
+    {
+        this->_load(dist, get_weight);
+        auto cycle = this->_spfa();
+        this->_store(dist);
+        return cycle;
+    }
+
+  private:
+    template <typename Mapping, typename Callable>
+    void _load(Mapping& dist, Callable& get_weight)
+    {
+        for (auto i = std::size_t(0); i != this->_nodes.size(); ++i)
+        {
+            this->_dist[i] = Dist(dist[this->_nodes[i]]);
+        }
+        for (auto e = std::size_t(0); e != this->_edges.size(); ++e)
+        {
+            this->_weight[e] = Dist(get_weight(this->_edges[e]));
+        }
+    }
+
+    template <typename Mapping>
+    void _store(Mapping& dist) const
+    {
+        for (auto i = std::size_t(0); i != this->_nodes.size(); ++i)
+        {
+            dist[this->_nodes[i]] = this->_dist[i];
+        }
+    }
+
+    /*! One Gauss-Seidel round over all arcs; return true if any label
+        improved. */
+    auto _relax_all() -> bool
+    {
+        auto changed = false;
+        for (auto e = std::size_t(0); e != this->_targets.size(); ++e)
+        {
+            const auto v = this->_targets[e];
+            const auto nd = Dist(this->_dist[this->_sources[e]]
+                + this->_weight[e]);
+            if (nd < this->_dist[v])
+            {
+                this->_dist[v] = nd;
+                this->_pred[v] = index_t(e);
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    /*! Return a node on a cycle of the policy graph, or none. */
+    auto _find_policy_cycle() -> index_t
+    {
+        std::fill(this->_mark.begin(), this->_mark.end(), none);
+        for (auto s = index_t(0); s != index_t(this->_nodes.size()); ++s)
+        {
+            auto v = s;
+            while (v != none && this->_mark[v] == none)
+            {
+                this->_mark[v] = s;
+                const auto e = this->_pred[v];
+                v = e == none ? none : this->_sources[e];
+            }
+            if (v != none && this->_mark[v] == s && this->_is_negative(v))
+            {
+                return v;
+            }
+        }
+        return none;
+    }
+
+    /*! Policy cycles are negative in exact arithmetic; check anyway so
+        that rounding cannot report a zero cycle. */
+    auto _is_negative(index_t v) const -> bool
+    {
+        auto total = Dist(0);
+        auto u = v;
+        do
+        {
+            const auto e = this->_pred[u];
+            total = Dist(total + this->_weight[e]);
+            u = this->_sources[e];
+        } while (u != v);
+        return total < Dist(0);
+    }
+
+    auto _policy_cycle(index_t v) const -> Cycle
+    {
+        auto cycle = Cycle {};
+        auto u = v;
+        do
+        {
+            const auto e = this->_pred[u];
+            cycle.push_back(this->_edges[e]);
+            u = this->_sources[e];
+        } while (u != v);
+        std::reverse(cycle.begin(), cycle.end());
+        return cycle;
+    }
+
+    auto _spfa() -> Cycle
+    {
+        const auto n = index_t(this->_nodes.size());
+        const auto root = n;
+        // every node starts as a child of the virtual source
+        for (auto v = index_t(0); v != n; ++v)
+        {
+            this->_prev[v] = v == 0 ? root : v - 1;
+            this->_next[v] = v + 1;
+            this->_depth[v] = 1;
+            this->_in_tree[v] = 1;
+            this->_in_queue[v] = 1;
+            this->_queue[v] = v;
+            this->_pred[v] = none;
+        }
+        this->_next[root] = n == 0 ? root : 0;
+        this->_prev[root] = n == 0 ? root : n - 1;
+        this->_depth[root] = 0;
+        this->_in_tree[root] = 1;
+
+        auto head = index_t(0);
+        auto count = n;
+        while (count != 0)
+        {
+            const auto u = this->_queue[head];
+            head = head + 1 == n ? 0 : head + 1;
+            --count;
+            this->_in_queue[u] = 0;
+            if (!this->_in_tree[u])
+            {
+                continue; // an ancestor improved; u will improve too
+            }
+            for (auto e = this->_offsets[u]; e != this->_offsets[u + 1]; ++e)
+            {
+                const auto v = this->_targets[e];
+                const auto nd = Dist(this->_dist[u] + this->_weight[e]);
+                if (!(nd < this->_dist[v]))
+                {
+                    continue;
+                }
+                this->_dist[v] = nd;
+                if (v == u || !this->_disassemble(v, u))
+                {
+                    return this->_tree_cycle(index_t(e));
+                }
+                this->_pred[v] = index_t(e);
+                this->_next[v] = this->_next[u];
+                this->_prev[v] = u;
+                this->_prev[this->_next[u]] = v;
+                this->_next[u] = v;
+                this->_depth[v] = this->_depth[u] + 1;
+                this->_in_tree[v] = 1;
+                if (!this->_in_queue[v])
+                {
+                    this->_in_queue[v] = 1;
+                    this->_queue[(head + count) % n] = v;
+                    ++count;
+                }
+            }
+        }
+        return Cycle {};
+    }
+
+    /*! Cut v and its subtree out of the tree; return false if u is in
+        that subtree, i.e. if the arc (u, v) closes a cycle. */
+    auto _disassemble(index_t v, index_t u) -> bool
+    {
+        if (!this->_in_tree[v])
+        {
+            return true;
+        }
+        auto x = this->_next[v];
+        while (this->_depth[v] < this->_depth[x])
+        {
+            if (x == u)
+            {
+                return false;
+            }
+            this->_in_tree[x] = 0;
+            x = this->_next[x];
+        }
+        this->_next[this->_prev[v]] = x;
+        this->_prev[x] = this->_prev[v];
+        this->_in_tree[v] = 0;
+        return true;
+    }
+
+    /*! Return the cycle closed by arc e = (u, v), v an ancestor of u. */
+    auto _tree_cycle(index_t e) const -> Cycle
+    {
+        const auto v = this->_targets[e];
+        auto cycle = Cycle {this->_edges[e]};
+        for (auto u = this->_sources[e]; u != v;)
+        {
+            const auto f = this->_pred[u];
+            cycle.push_back(this->_edges[f]);
+            u = this->_sources[f];
+        }
+        std::reverse(cycle.begin(), cycle.end());
+        return cycle;
+    }
+};
+
+/*! Return true if there exists a negative edge cycle anywhere in G.
+
+    Parameters
+    ----------
+    G : DiGraphS
+    get_weight : callable mapping an edge `(u, v)` to its weight
+
+    Examples
+    --------
+    >>> auto G = xn::SimpleDiGraphS {5};
+    >>> for (auto i = 0; i != 5; ++i) G.add_edge(i, (i + 1) % 5, 1);
+    >>> auto get_weight = [&](const auto& e) { return G[e.first][e.second]; };
+    >>> xn::negative_edge_cycle(G, get_weight);
+    false
+*/
+template <typename Graph, typename Callable>
+auto negative_edge_cycle(const Graph& G, Callable&& get_weight) -> bool
+{
+    using Dist = std::decay_t<decltype(get_weight(
+        std::declval<const typename Graph::edge_t&>()))>;
+    auto dist = py::dict<typename Graph::Node, Dist> {};
+    for (auto&& v : G)
+    {
+        dist[v] = Dist(0);
+    }
+    auto N = negCycleFinder<Graph, Dist>(G);
+    return !N.find_neg_cycle_spfa(dist, get_weight).empty();
+}
+
+} // namespace xn
@@ -0,0 +1,137 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native shortest path algorithms for unweighted graphs.
+
+Like the weighted algorithms, these run on a `CSRGraph` and keep their
+per-node state in a caller-owned workspace.
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include <xnetwork/algorithms/shortest_paths/dense.hpp>
+#include <xnetwork/algorithms/shortest_paths/weighted.hpp>
+#include <xnetwork/algorithms/traversal/breadth_first_search.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Per-query state of breadth-first search.
+
+    Distances are hop counts.  Nodes are labeled in BFS order, so
+    `touched()` doubles as the BFS queue and, on return, lists the reached
+    nodes in nondecreasing order of distance.
+*/
+using BFSWorkspace = ShortestPathTree<std::uint32_t>;
+
+/*! Compute the shortest path lengths from source to all reachable nodes.
+
+    Parameters
+    ----------
+    G : CSRGraph (weights are ignored)
+    source : starting node
+    ws : BFSWorkspace sized for G
+    cutoff : depth to stop the search; only paths of length <= cutoff are
+        found
+
+    Returns
+    -------
+    The workspace holds the results: `ws.dist(v)` is the number of arcs
+    on a shortest path, `ws.touched()` the reached nodes in BFS order.
+*/
+template <typename CSR>
+void single_source_shortest_path_length(const CSR& G,
+    BFSWorkspace::node_t source, BFSWorkspace& ws,
+    std::uint32_t cutoff = BFSWorkspace::infinity())
+{
+    assert(ws.number_of_nodes() == G.number_of_nodes());
+    ws.reset();
+    ws._label(source, 0, BFSWorkspace::none);
+    for (auto head = std::size_t(0); head != ws._touched.size(); ++head)
+    {
+        const auto u = ws._touched[head];
+        const auto nd = ws._dist[u] + 1;
+        if (cutoff < nd)
+        {
+            break;
+        }
+        for (auto v : G.neighbors(u))
+        {
+            if (!ws.reached(v))
+            {
+                ws._label(v, nd, u);
+            }
+        }
+    }
+}
+
+/*! Compute the shortest path lengths between all nodes in parallel.
+
+    See `all_pairs_dijkstra_path_length` for the sink protocol.
+
+    Parameters
+    ----------
+    G : CSRGraph (weights are ignored)
+    pool : ThreadPool
+    sink : callable `sink(source, ws)`, called concurrently for different
+        sources
+    cutoff : depth to stop the search
+*/
+template <typename CSR, typename Sink>
+void all_pairs_shortest_path_length(const CSR& G, ThreadPool& pool,
+    Sink&& sink, std::uint32_t cutoff = BFSWorkspace::infinity())
+{
+    _all_pairs<BFSWorkspace>(
+        G.number_of_nodes(), pool,
+        [&](auto s, BFSWorkspace& ws) {
+            single_source_shortest_path_length(G, s, ws, cutoff);
+        },
+        sink);
+}
+
+/*! Fill a block of rows of a hop-count matrix in parallel.
+
+    Row i of D receives the distances from node `D.first_source() + i`.
+    The rows are filled 64 at a time by `multi_source_bfs`, one batch per
+    task of the pool.
+*/
+template <typename CSR, typename Dist>
+void all_pairs_shortest_path_length(
+    const CSR& G, ThreadPool& pool, DistanceMatrix<Dist>& D)
+{
+    using WS = MultiSourceBFSWorkspace<64>;
+    using node_t = WS::node_t;
+
+    assert(D.cols() == G.number_of_nodes());
+    auto workspaces = std::vector<WS> {};
+    workspaces.reserve(pool.size());
+    for (auto t = 0U; t != pool.size(); ++t)
+    {
+        workspaces.emplace_back(G.number_of_nodes());
+    }
+    const auto num_batches = (D.rows() + WS::width - 1) / WS::width;
+    parallel_for(pool, 0, num_batches, 1, [&](unsigned tid, std::size_t b) {
+        const auto first = b * WS::width;
+        const auto last = std::min(D.rows(), first + WS::width);
+        auto sources = std::vector<node_t> {};
+        for (auto i = first; i != last; ++i)
+        {
+            sources.push_back(node_t(D.first_source() + i));
+        }
+        multi_source_bfs(G, sources, workspaces[tid],
+            [&](node_t v, std::uint32_t level, const WS::mask_t& mask) {
+                mask.for_each(
+                    [&](std::size_t i) { D(first + i, v) = Dist(level); });
+            });
+    });
+}
+
+} // namespace xn
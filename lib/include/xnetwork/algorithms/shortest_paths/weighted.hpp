@@ -0,0 +1,925 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native shortest path algorithms for weighted graphs.
+
+The algorithms here run on a `CSRGraph` snapshot of a graph with nodes
+`0 .. n-1` (see `to_csr_graph`) and keep all of their per-node state in a
+caller-owned workspace.  A workspace is sized once for the graph and is
+reset between queries in time proportional to the number of nodes the
+previous query touched, so answering many point-to-point queries does not
+allocate.
+*/
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <xnetwork/algorithms/shortest_paths/dense.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/heaps.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Distances and shortest path tree of a single-source query.
+
+    All arrays are sized for the graph once.  The nodes labeled by the last
+    query are remembered, so `reset()` runs in time proportional to their
+    number rather than to the size of the graph.
+*/
+template <typename Dist>
+class ShortestPathTree
+{
+  public:
+    using node_t = std::uint32_t;
+    using dist_t = Dist;
+
+    static constexpr node_t none = std::numeric_limits<node_t>::max();
+
+    static constexpr auto infinity() -> Dist
+    {
+        return std::numeric_limits<Dist>::has_infinity
+            ? std::numeric_limits<Dist>::infinity()
+            : std::numeric_limits<Dist>::max();
+    }
+
+    std::vector<Dist> _dist;
+    std::vector<node_t> _pred;
+    std::vector<node_t> _touched; // reached by the last query
+
+    explicit ShortestPathTree(std::size_t num_nodes)
+        : _dist(num_nodes, infinity())
+        , _pred(num_nodes, none)
+    {
+    }
+
+    [[nodiscard]] auto number_of_nodes() const -> std::size_t
+    {
+        return this->_dist.size();
+    }
+
+    /*! Return the distance found for v, or `infinity()` if v was not
+        reached. */
+    [[nodiscard]] auto dist(node_t v) const -> Dist
+    {
+        return this->_dist[v];
+    }
+
+    [[nodiscard]] auto reached(node_t v) const -> bool
+    {
+        return this->_dist[v] != infinity();
+    }
+
+    /*! Return the predecessor of v in the shortest path tree, or `none`
+        for a source or an unreached node. */
+    [[nodiscard]] auto pred(node_t v) const -> node_t
+    {
+        return this->_pred[v];
+    }
+
+    [[nodiscard]] auto touched() const -> const std::vector<node_t>&
+    {
+        return this->_touched;
+    }
+
+    /*! Return the tree path from a source to v (empty if unreached). */
+    [[nodiscard]] auto path_to(node_t v) const -> std::vector<node_t>
+    {
+        auto path = std::vector<node_t> {};
+        if (!this->reached(v))
+        {
+            return path;
+        }
+        for (; v != none; v = this->_pred[v])
+        {
+            path.push_back(v);
+        }
+        return {path.rbegin(), path.rend()};
+    }
+
+    /*! Mark v as reached with distance d through u. */
+    void _label(node_t v, Dist d, node_t u)
+    {
+        if (this->_dist[v] == infinity())
+        {
+            this->_touched.push_back(v);
+        }
+        this->_dist[v] = d;
+        this->_pred[v] = u;
+    }
+
+    /*! Forget the last query in O(number of touched nodes). */
+    void reset()
+    {
+        for (auto v : this->_touched)
+        {
+            this->_dist[v] = infinity();
+            this->_pred[v] = none;
+        }
+        this->_touched.clear();
+    }
+};
+
+/*! Per-query state of the Dijkstra family.
+
+    A ShortestPathTree plus the priority queue and the order in which
+    nodes were settled.
+
+    Parameters
+    ----------
+    Dist : distance type
+    Heap : priority queue of (Dist, node) pairs, e.g. `DaryHeap` (default)
+        or `RadixHeap` for non-negative integer weights
+
+    Examples
+    --------
+    >>> auto ws = xn::DijkstraWorkspace<int> {C.number_of_nodes()};
+    >>> auto ws2 = xn::DijkstraWorkspace<int, xn::RadixHeap<int>> {n};
+*/
+template <typename Dist, typename Heap = DaryHeap<Dist, std::uint32_t, 4>>
+class DijkstraWorkspace : public ShortestPathTree<Dist>
+{
+    using _Base = ShortestPathTree<Dist>;
+
+  public:
+    using node_t = typename _Base::node_t;
+    using heap_t = Heap;
+
+    std::vector<node_t> _settled; // in order of settlement
+    Heap _heap;
+
+    explicit DijkstraWorkspace(std::size_t num_nodes)
+        : _Base {num_nodes}
+    {
+    }
+
+    [[nodiscard]] auto settled() const -> const std::vector<node_t>&
+    {
+        return this->_settled;
+    }
+
+    void reset()
+    {
+        _Base::reset();
+        this->_settled.clear();
+        this->_heap.clear();
+    }
+};
+
+/*! Run Dijkstra from several sources at once.
+
+    The workspace is reset first.  On return `ws.dist(v)` is the distance
+    from the nearest source to v, `ws.pred(v)` the predecessor of v on one
+    shortest path, and `ws.settled()` lists the nodes whose distances are
+    final, in nondecreasing order of distance.
+
+    Parameters
+    ----------
+    G : CSRGraph with non-negative weights
+    sources : container of source nodes
+    ws : DijkstraWorkspace sized for G
+    cutoff : nodes farther than cutoff are not reached
+    target : stop as soon as this node is settled (default: none)
+
+    Returns
+    -------
+    found : bool
+        true if target was settled (always false without a target).
+
+    Notes
+    -----
+    The priority queue uses lazy deletion: improved nodes are pushed again
+    and stale entries are skipped when popped.
+*/
+template <typename CSR, typename Sources, typename Workspace>
+auto multi_source_dijkstra(const CSR& G, const Sources& sources,
+    Workspace& ws, typename Workspace::dist_t cutoff = Workspace::infinity(),
+    typename Workspace::node_t target = Workspace::none) -> bool
+{
+    using Dist = typename Workspace::dist_t;
+    using node_t = typename Workspace::node_t;
+
+    assert(ws.number_of_nodes() == G.number_of_nodes());
+    ws.reset();
+    for (auto&& s : sources)
+    {
+        const auto u = node_t(s);
+        if (!ws.reached(u))
+        {
+            ws._label(u, Dist(0), Workspace::none);
+            ws._heap.push(Dist(0), u);
+        }
+    }
+    while (!ws._heap.empty())
+    {
+        const auto [d, u] = ws._heap.pop();
+        if (ws._dist[u] < d)
+        {
+            continue; // stale entry
+        }
+        ws._settled.push_back(u);
+        if (u == target)
+        {
+            return true;
+        }
+        for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+        {
+            const auto v = G.target(e);
+            const auto w = G.weight(e);
+            assert(!(w < decltype(w)(0)));
+            const auto nd = Dist(d + w);
+            if (cutoff < nd || !(nd < ws._dist[v]))
+            {
+                continue;
+            }
+            ws._label(v, nd, u);
+            ws._heap.push(nd, v);
+        }
+    }
+    return false;
+}
+
+/*! Run Dijkstra from a single source.
+
+    See `multi_source_dijkstra` for the meaning of the arguments and the
+    results left in the workspace.
+*/
+template <typename CSR, typename Workspace>
+auto single_source_dijkstra(const CSR& G, typename Workspace::node_t source,
+    Workspace& ws, typename Workspace::dist_t cutoff = Workspace::infinity(),
+    typename Workspace::node_t target = Workspace::none) -> bool
+{
+    const auto sources = std::array<typename Workspace::node_t, 1> {source};
+    return multi_source_dijkstra(G, sources, ws, cutoff, target);
+}
+
+/*! Compute the shortest path tree of a source.
+
+    XNetwork's version returns a dict of predecessor lists.  Here the
+    results stay in the workspace: `ws.pred(v)` is one predecessor of v,
+    and every u with `ws.dist(u) + w(u, v) == ws.dist(v)` is another.
+*/
+template <typename CSR, typename Workspace>
+void dijkstra_predecessor_and_distance(const CSR& G,
+    typename Workspace::node_t source, Workspace& ws,
+    typename Workspace::dist_t cutoff = Workspace::infinity())
+{
+    single_source_dijkstra(G, source, ws, cutoff);
+}
+
+/*! Return the length of the shortest path from source to target.
+
+    Raises
+    ------
+    XNetworkNoPath
+        If no path exists between source and target.
+*/
+template <typename CSR, typename Workspace>
+auto dijkstra_path_length(const CSR& G, typename Workspace::node_t source,
+    typename Workspace::node_t target, Workspace& ws) ->
+    typename Workspace::dist_t
+{
+    if (!single_source_dijkstra(
+            G, source, ws, Workspace::infinity(), target))
+    {
+        throw XNetworkNoPath("Node " + std::to_string(target)
+            + " not reachable from " + std::to_string(source));
+    }
+    return ws.dist(target);
+}
+
+/*! Return the nodes of a shortest path from source to target.
+
+    Raises
+    ------
+    XNetworkNoPath
+        If no path exists between source and target.
+*/
+template <typename CSR, typename Workspace>
+auto dijkstra_path(const CSR& G, typename Workspace::node_t source,
+    typename Workspace::node_t target, Workspace& ws)
+    -> std::vector<typename Workspace::node_t>
+{
+    dijkstra_path_length(G, source, target, ws);
+    return ws.path_to(target);
+}
+
+/*! Search state of `bidirectional_dijkstra`.
+
+    Holds one DijkstraWorkspace per search direction and a buffer for the
+    resulting path, so repeated point-to-point queries reuse the same
+    memory.
+*/
+template <typename Dist, typename Heap = DaryHeap<Dist, std::uint32_t, 4>>
+class BidirectionalDijkstraWorkspace
+{
+  public:
+    using node_t = std::uint32_t;
+    using dist_t = Dist;
+    using workspace_t = DijkstraWorkspace<Dist, Heap>;
+
+    static constexpr node_t none = workspace_t::none;
+
+    static constexpr auto infinity() -> Dist
+    {
+        return workspace_t::infinity();
+    }
+
+    workspace_t _forward;
+    workspace_t _backward;
+    std::vector<node_t> _path;
+
+    explicit BidirectionalDijkstraWorkspace(std::size_t num_nodes)
+        : _forward {num_nodes}
+        , _backward {num_nodes}
+    {
+    }
+
+    [[nodiscard]] auto number_of_nodes() const -> std::size_t
+    {
+        return this->_forward.number_of_nodes();
+    }
+
+    [[nodiscard]] auto forward() const -> const workspace_t&
+    {
+        return this->_forward;
+    }
+
+    [[nodiscard]] auto backward() const -> const workspace_t&
+    {
+        return this->_backward;
+    }
+
+    /*! Return the path found by the last query. */
+    [[nodiscard]] auto path() const -> const std::vector<node_t>&
+    {
+        return this->_path;
+    }
+
+    /*! Return the number of nodes reached by both searches together. */
+    [[nodiscard]] auto number_of_touched() const -> std::size_t
+    {
+        return this->_forward.touched().size()
+            + this->_backward.touched().size();
+    }
+};
+
+/*! Dijkstra's algorithm for shortest paths using bidirectional search.
+
+    A forward search from the source over `G` and a backward search from
+    the target over the predecessor lists `GT` run alternately, always
+    expanding the side with the smaller queue.  Every arc relaxed into a
+    node reached by the other side gives a candidate length mu; the search
+    stops once the key popped on one side plus the last key settled on the
+    other side is at least mu.  That sum is a lower bound on any path not
+    yet seen, though a looser one than the two queue tops would give; it
+    needs no peek at the queue, which a RadixHeap does not offer.
+
+    Parameters
+    ----------
+    G : CSRGraph with non-negative weights
+    GT : predecessor lists of G, i.e. `G.transpose()` (for an undirected
+        graph pass G itself)
+    source : starting node
+    target : ending node
+    ws : BidirectionalDijkstraWorkspace sized for G
+
+    Returns
+    -------
+    length : distance from source to target.  The nodes of a shortest path
+        are left in `ws.path()`.
+
+    Raises
+    ------
+    XNetworkNoPath
+        If no path exists between source and target.
+
+    Notes
+    -----
+    Ordinary Dijkstra expands a ball of radius d(source, target) around the
+    source; the two searches here expand two balls of about half that
+    radius, which on road-like graphs holds far fewer nodes.
+*/
+template <typename CSR, typename Workspace>
+auto bidirectional_dijkstra(const CSR& G, const CSR& GT,
+    typename Workspace::node_t source, typename Workspace::node_t target,
+    Workspace& ws) -> typename Workspace::dist_t
+{
+    using Dist = typename Workspace::dist_t;
+    using node_t = typename Workspace::node_t;
+
+    assert(ws.number_of_nodes() == G.number_of_nodes());
+    assert(GT.number_of_nodes() == G.number_of_nodes());
+    auto& fwd = ws._forward;
+    auto& bwd = ws._backward;
+    fwd.reset();
+    bwd.reset();
+    ws._path.clear();
+
+    fwd._label(source, Dist(0), Workspace::none);
+    fwd._heap.push(Dist(0), source);
+    bwd._label(target, Dist(0), Workspace::none);
+    bwd._heap.push(Dist(0), target);
+
+    auto mu = Workspace::infinity();
+    auto meet = source == target ? source : Workspace::none;
+    if (source == target)
+    {
+        mu = Dist(0);
+    }
+    auto last_fwd = Dist(0); // last key settled by each side
+    auto last_bwd = Dist(0);
+
+    // Settle one node on one side; return false when that side is done.
+    auto step = [&](const CSR& H, auto& self, const auto& other,
+                    Dist& last, Dist other_last) -> bool {
+        while (!self._heap.empty())
+        {
+            const auto [d, u] = self._heap.pop();
+            if (self._dist[u] < d)
+            {
+                continue; // stale entry
+            }
+            last = d;
+            if (!(Dist(d + other_last) < mu))
+            {
+                return false;
+            }
+            self._settled.push_back(u);
+            for (auto e = H.edge_begin(u); e != H.edge_end(u); ++e)
+            {
+                const auto v = H.target(e);
+                const auto nd = Dist(d + H.weight(e));
+                if (nd < self._dist[v])
+                {
+                    self._label(v, nd, u);
+                    self._heap.push(nd, v);
+                }
+                if (other.reached(v) && nd == self._dist[v])
+                {
+                    const auto total = Dist(nd + other._dist[v]);
+                    if (total < mu)
+                    {
+                        mu = total;
+                        meet = v;
+                    }
+                }
+            }
+            return true;
+        }
+        return false;
+    };
+
+    while (true)
+    {
+        const auto forward_side = fwd._heap.size() <= bwd._heap.size();
+        const auto more = forward_side
+            ? step(G, fwd, bwd, last_fwd, last_bwd)
+            : step(GT, bwd, fwd, last_bwd, last_fwd);
+        if (!more)
+        {
+            break;
+        }
+    }
+
+    if (meet == Workspace::none)
+    {
+        throw XNetworkNoPath("No path between " + std::to_string(source)
+            + " and " + std::to_string(target) + ".");
+    }
+    for (auto v = meet; v != Workspace::none; v = fwd._pred[v])
+    {
+        ws._path.push_back(v);
+    }
+    std::reverse(ws._path.begin(), ws._path.end());
+    for (auto v = bwd._pred[meet]; v != Workspace::none; v = bwd._pred[v])
+    {
+        ws._path.push_back(node_t(v));
+    }
+    return mu;
+}
+
+/*! Per-query state of the queue-based Bellman-Ford algorithm.
+
+    A ShortestPathTree plus a FIFO queue of at most one entry per node and
+    the number of arcs on each tree path, which exposes negative cycles.
+*/
+template <typename Dist>
+class BellmanFordWorkspace : public ShortestPathTree<Dist>
+{
+    using _Base = ShortestPathTree<Dist>;
+
+  public:
+    using node_t = typename _Base::node_t;
+
+    std::vector<node_t> _length; // arcs on the tree path
+    std::vector<char> _in_queue;
+    std::vector<node_t> _queue; // ring buffer
+
+    explicit BellmanFordWorkspace(std::size_t num_nodes)
+        : _Base {num_nodes}
+        , _length(num_nodes, 0)
+        , _in_queue(num_nodes, 0)
+        , _queue(num_nodes)
+    {
+    }
+};
+
+/*! Compute shortest path lengths from several sources with
+    Bellman-Ford.
+
+    This is the queue-based variant (SPFA): only nodes whose distance
+    dropped in the previous round are scanned again.  The workspace is
+    reset first and holds the results on return; `ws.dist(v)` is the
+    distance from the nearest source.
+
+    Parameters
+    ----------
+    G : CSRGraph, weights may be negative
+    sources : container of source nodes
+    ws : BellmanFordWorkspace sized for G
+
+    Raises
+    ------
+    XNetworkUnbounded
+        If a source reaches a negative cost cycle.
+
+    Notes
+    -----
+    Every label corresponds to a walk from a source whose labels decrease
+    strictly along the way, so a walk repeats a node only around a
+    negative cycle.  The check is therefore a tree path with n arcs.
+*/
+template <typename CSR, typename Sources, typename Workspace>
+void multi_source_bellman_ford(
+    const CSR& G, const Sources& sources, Workspace& ws)
+{
+    using Dist = typename Workspace::dist_t;
+    using node_t = typename Workspace::node_t;
+
+    const auto n = G.number_of_nodes();
+    assert(ws.number_of_nodes() == n);
+    ws.reset();
+    auto head = std::size_t(0);
+    auto count = std::size_t(0);
+    for (auto&& s : sources)
+    {
+        const auto u = node_t(s);
+        if (!ws._in_queue[u])
+        {
+            ws._label(u, Dist(0), Workspace::none);
+            ws._length[u] = 0;
+            ws._queue[count++] = u;
+            ws._in_queue[u] = 1;
+        }
+    }
+    while (count != 0)
+    {
+        const auto u = ws._queue[head];
+        head = head + 1 == n ? 0 : head + 1;
+        --count;
+        ws._in_queue[u] = 0;
+        const auto du = ws._dist[u];
+        for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+        {
+            const auto v = G.target(e);
+            const auto nd = Dist(du + G.weight(e));
+            if (!(nd < ws._dist[v]))
+            {
+                continue;
+            }
+            ws._label(v, nd, u);
+            ws._length[v] = node_t(ws._length[u] + 1);
+            if (ws._length[v] >= n)
+            {
+                while (count != 0) // leave the workspace resettable
+                {
+                    ws._in_queue[ws._queue[head]] = 0;
+                    head = head + 1 == n ? 0 : head + 1;
+                    --count;
+                }
+                throw XNetworkUnbounded("Negative cost cycle detected.");
+            }
+            if (!ws._in_queue[v])
+            {
+                ws._in_queue[v] = 1;
+                ws._queue[(head + count) % n] = v;
+                ++count;
+            }
+        }
+    }
+}
+
+/*! Compute shortest path lengths from a source with Bellman-Ford.
+
+    See `multi_source_bellman_ford` for the results left in the
+    workspace.
+
+    Raises
+    ------
+    XNetworkUnbounded
+        If the source reaches a negative cost cycle.
+*/
+template <typename CSR, typename Workspace>
+void single_source_bellman_ford(
+    const CSR& G, typename Workspace::node_t source, Workspace& ws)
+{
+    const auto sources = std::array<typename Workspace::node_t, 1> {source};
+    multi_source_bellman_ford(G, sources, ws);
+}
+
+/*! Return the length of the shortest path from source to target,
+    allowing negative weights.
+
+    Raises
+    ------
+    XNetworkNoPath
+        If no path exists between source and target.
+    XNetworkUnbounded
+        If the source reaches a negative cost cycle.
+*/
+template <typename CSR, typename Workspace>
+auto bellman_ford_path_length(const CSR& G, typename Workspace::node_t source,
+    typename Workspace::node_t target, Workspace& ws) ->
+    typename Workspace::dist_t
+{
+    single_source_bellman_ford(G, source, ws);
+    if (!ws.reached(target))
+    {
+        throw XNetworkNoPath("Node " + std::to_string(target)
+            + " not reachable from " + std::to_string(source));
+    }
+    return ws.dist(target);
+}
+
+/*! Run `solve(source, ws)` from every node on a thread pool and pass each
+    finished workspace to `sink(source, ws)`. */
+template <typename Workspace, typename Solve, typename Sink>
+void _all_pairs(std::size_t num_nodes, ThreadPool& pool, Solve&& solve,
+    Sink&& sink, std::size_t first = 0,
+    std::size_t last = std::numeric_limits<std::size_t>::max())
+{
+    using node_t = typename Workspace::node_t;
+
+    auto workspaces = std::vector<Workspace> {};
+    workspaces.reserve(pool.size());
+    for (auto t = 0U; t != pool.size(); ++t)
+    {
+        workspaces.emplace_back(num_nodes);
+    }
+    parallel_for(pool, first, std::min(last, num_nodes), 1,
+        [&](unsigned tid, std::size_t s) {
+            auto& ws = workspaces[tid];
+            solve(node_t(s), ws);
+            sink(node_t(s), static_cast<const Workspace&>(ws));
+        });
+}
+
+/*! Copy the distances of a finished query into its row of D. */
+template <typename Dist, typename Tree>
+void _store_row(DistanceMatrix<Dist>& D, std::size_t source, const Tree& ws)
+{
+    auto* row = D.row(source - D.first_source());
+    for (auto v : ws.touched())
+    {
+        row[v] = Dist(ws.dist(v));
+    }
+}
+
+/*! Compute shortest path lengths between all nodes in parallel.
+
+    Sources are spread over the pool; every thread keeps one workspace.
+    For each source, `sink(source, ws)` is called on the thread that ran
+    the query, with the finished workspace (`ws.touched()` lists the
+    reached nodes and `ws.dist(v)` their distances).
+
+    Parameters
+    ----------
+    G : CSRGraph with non-negative weights
+    pool : ThreadPool
+    sink : callable, called concurrently for different sources
+    cutoff : only paths of length at most cutoff are reported
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto ecc = std::vector<int>(C.number_of_nodes());
+    >>> auto sink = [&](auto s, const auto& ws) {
+    ...     ecc[s] = ws.dist(ws.settled().back());
+    ... };
+    >>> xn::all_pairs_dijkstra_path_length(C, pool, sink);
+*/
+template <typename Workspace = void, typename CSR, typename Sink>
+void all_pairs_dijkstra_path_length(const CSR& G, ThreadPool& pool,
+    Sink&& sink,
+    typename CSR::weight_t cutoff = ShortestPathTree<
+        typename CSR::weight_t>::infinity())
+{
+    using WS = std::conditional_t<std::is_void<Workspace>::value,
+        DijkstraWorkspace<typename CSR::weight_t>, Workspace>;
+    _all_pairs<WS>(
+        G.number_of_nodes(), pool,
+        [&](auto s, WS& ws) { single_source_dijkstra(G, s, ws, cutoff); },
+        sink);
+}
+
+/*! Fill a block of rows of a distance matrix with Dijkstra, in parallel.
+
+    Row i of D receives the distances from node `D.first_source() + i`;
+    unreachable entries keep `D.infinity()`.  Computing a large graph one
+    block of rows at a time bounds the memory to `D.rows() * n` entries.
+*/
+template <typename Workspace = void, typename CSR, typename Dist>
+void all_pairs_dijkstra_path_length(
+    const CSR& G, ThreadPool& pool, DistanceMatrix<Dist>& D)
+{
+    using WS = std::conditional_t<std::is_void<Workspace>::value,
+        DijkstraWorkspace<typename CSR::weight_t>, Workspace>;
+    assert(D.cols() == G.number_of_nodes());
+    _all_pairs<WS>(
+        G.number_of_nodes(), pool,
+        [&](auto s, WS& ws) { single_source_dijkstra(G, s, ws); },
+        [&](auto s, const WS& ws) { _store_row(D, s, ws); },
+        D.first_source(), D.first_source() + D.rows());
+}
+
+/*! Compute shortest path lengths between all nodes in parallel, allowing
+    negative weights.
+
+    See `all_pairs_dijkstra_path_length` for the sink protocol.
+
+    Raises
+    ------
+    XNetworkUnbounded
+        If the graph contains a negative cost cycle.
+*/
+template <typename CSR, typename Sink>
+void all_pairs_bellman_ford_path_length(
+    const CSR& G, ThreadPool& pool, Sink&& sink)
+{
+    using WS = BellmanFordWorkspace<typename CSR::weight_t>;
+    _all_pairs<WS>(
+        G.number_of_nodes(), pool,
+        [&](auto s, WS& ws) { single_source_bellman_ford(G, s, ws); },
+        sink);
+}
+
+/*! Fill a block of rows of a distance matrix with Bellman-Ford, in
+    parallel.  See the DistanceMatrix overload of
+    `all_pairs_dijkstra_path_length`. */
+template <typename CSR, typename Dist>
+void all_pairs_bellman_ford_path_length(
+    const CSR& G, ThreadPool& pool, DistanceMatrix<Dist>& D)
+{
+    using WS = BellmanFordWorkspace<typename CSR::weight_t>;
+    assert(D.cols() == G.number_of_nodes());
+    _all_pairs<WS>(
+        G.number_of_nodes(), pool,
+        [&](auto s, WS& ws) { single_source_bellman_ford(G, s, ws); },
+        [&](auto s, const WS& ws) { _store_row(D, s, ws); },
+        D.first_source(), D.first_source() + D.rows());
+}
+
+/*! Return node potentials that make every reduced cost
+    `w(u, v) + h[u] - h[v]` non-negative.
+
+    h[v] is the length of the shortest path ending at v, found by one
+    Bellman-Ford pass from all nodes at once (the virtual source of
+    Johnson's algorithm).
+
+    Raises
+    ------
+    XNetworkUnbounded
+        If the graph contains a negative cost cycle.
+*/
+template <typename CSR>
+auto johnson_potential(const CSR& G) -> std::vector<typename CSR::weight_t>
+{
+    using Dist = typename CSR::weight_t;
+    using node_t = typename BellmanFordWorkspace<Dist>::node_t;
+
+    const auto n = G.number_of_nodes();
+    auto ws = BellmanFordWorkspace<Dist> {n};
+    auto nodes = std::vector<node_t>(n);
+    for (auto v = node_t(0); v != n; ++v)
+    {
+        nodes[v] = v;
+    }
+    multi_source_bellman_ford(G, nodes, ws);
+    return std::move(ws._dist);
+}
+
+/*! Return a copy of G with the reduced costs of the potentials h. */
+template <typename CSR>
+auto _reduced_cost_graph(
+    const CSR& G, const std::vector<typename CSR::weight_t>& h) -> CSR
+{
+    using Dist = typename CSR::weight_t;
+
+    auto weights = std::vector<Dist>(G.number_of_edges());
+    for (auto u = typename CSR::node_t(0); u != G.number_of_nodes(); ++u)
+    {
+        for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+        {
+            // rounding may leave floating-point costs slightly negative
+            weights[e] = std::max(
+                Dist(0), Dist(G.weight(e) + h[u] - h[G.target(e)]));
+        }
+    }
+    return CSR {G._offsets, G._targets, std::move(weights)};
+}
+
+/*! Compute shortest path lengths between all nodes with Johnson's
+    algorithm, in parallel.
+
+    One Bellman-Ford pass computes node potentials h (see
+    `johnson_potential`); Dijkstra then runs from every source on the
+    reduced costs `w(u, v) + h[u] - h[v] >= 0`, spread over the pool.
+    Before `sink(source, ws)` is called, the distances in the workspace
+    are shifted back to the original weights, so the sink protocol is the
+    one of `all_pairs_dijkstra_path_length` except that `ws.settled()` is
+    ordered by reduced distance.
+
+    XNetwork's version returns a dict of paths; here `ws.path_to(v)`
+    gives them.
+
+    Parameters
+    ----------
+    G : CSRGraph, weights may be negative
+    pool : ThreadPool
+    sink : callable, called concurrently for different sources
+
+    Raises
+    ------
+    XNetworkUnbounded
+        If the graph contains a negative cost cycle.
+
+    Notes
+    -----
+    On a sparse graph this takes O(n m log n) time against the O(n m) of
+    every Bellman-Ford pass of `all_pairs_bellman_ford_path_length`.
+
+    Examples
+    --------
+    >>> auto pool = xn::ThreadPool {};
+    >>> auto sink = [&](auto s, const auto& ws) {
+    ...     for (auto v : ws.touched()) { slack(s, v) = ws.dist(v); }
+    ... };
+    >>> xn::johnson(C, pool, sink);
+*/
+template <typename Workspace = void, typename CSR, typename Sink>
+void johnson(const CSR& G, ThreadPool& pool, Sink&& sink)
+{
+    using WS = std::conditional_t<std::is_void<Workspace>::value,
+        DijkstraWorkspace<typename CSR::weight_t>, Workspace>;
+    using Dist = typename CSR::weight_t;
+
+    const auto h = johnson_potential(G);
+    const auto R = _reduced_cost_graph(G, h);
+    _all_pairs<WS>(
+        G.number_of_nodes(), pool,
+        [&](auto s, WS& ws) {
+            single_source_dijkstra(R, s, ws);
+            for (auto v : ws.touched())
+            {
+                ws._dist[v] = Dist(ws._dist[v] - h[s] + h[v]);
+            }
+        },
+        sink);
+}
+
+/*! Fill a block of rows of a distance matrix with Johnson's algorithm,
+    in parallel.  See the DistanceMatrix overload of
+    `all_pairs_dijkstra_path_length`. */
+template <typename Workspace = void, typename CSR, typename Dist>
+void johnson(const CSR& G, ThreadPool& pool, DistanceMatrix<Dist>& D)
+{
+    using WS = std::conditional_t<std::is_void<Workspace>::value,
+        DijkstraWorkspace<typename CSR::weight_t>, Workspace>;
+    using W = typename CSR::weight_t;
+
+    assert(D.cols() == G.number_of_nodes());
+    const auto h = johnson_potential(G);
+    const auto R = _reduced_cost_graph(G, h);
+    _all_pairs<WS>(
+        G.number_of_nodes(), pool,
+        [&](auto s, WS& ws) { single_source_dijkstra(R, s, ws); },
+        [&](auto s, const WS& ws) {
+            auto* row = D.row(s - D.first_source());
+            for (auto v : ws.touched())
+            {
+                row[v] = Dist(W(ws.dist(v) - h[s] + h[v]));
+            }
+        },
+        D.first_source(), D.first_source() + D.rows());
+}
+
+} // namespace xn
@@ -0,0 +1,541 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native breadth-first search kernels.
+
+Direction-optimizing BFS: a top-down step scans the arcs out of the
+frontier.  Once the frontier is large, a bottom-up step is cheaper: every
+unvisited node looks for a parent among its in-neighbors and stops at the
+first one found in the frontier (Beamer, Asanovic and Patterson, 2012).
+On low-diameter graphs most arcs are never examined.
+
+Multi-source BFS: up to 512 searches run together, with one bit per
+search in the masks kept for every node, so an arc is scanned once per
+level for the whole batch instead of once per search (Then et al.,
+2014).
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <xnetwork/utils/bitmap.hpp>
+#include <xnetwork/utils/bits.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Per-query state of `direction_optimizing_bfs`.
+
+    On return `ws.level(v)` is the hop distance of v from the source and
+    `ws.parent(v)` its parent in the BFS tree (`none` for the source and
+    for unreached nodes).  `levels()` and `parents()` expose both as flat
+    arrays.
+
+    Parameters
+    ----------
+    num_nodes : number of nodes of the graph
+    num_threads : threads of the pool that will run the queries
+        (default: 1)
+
+    Attributes
+    ----------
+    alpha : switch to bottom-up when the arcs out of the frontier exceed
+        1 / alpha of the unexplored arcs (default: 15)
+    beta : switch back to top-down when the frontier holds fewer than
+        1 / beta of the nodes (default: 18)
+*/
+class BFSTreeWorkspace
+{
+  public:
+    using node_t = std::uint32_t;
+
+    static constexpr node_t none = std::numeric_limits<node_t>::max();
+
+    std::size_t alpha = 15;
+    std::size_t beta = 18;
+
+    std::vector<node_t> _level;
+    std::vector<std::atomic<node_t>> _parent; // claimed by top-down steps
+    std::vector<node_t> _queue; // sparse frontier
+    Bitmap _front;
+    Bitmap _next;
+
+    struct alignas(64) PerThread
+    {
+        std::vector<node_t> _queue;
+        std::size_t _count = 0;
+    };
+
+    std::vector<PerThread> _threads;
+
+    explicit BFSTreeWorkspace(std::size_t num_nodes, unsigned num_threads = 1)
+        : _level(num_nodes, none)
+        , _parent(num_nodes)
+        , _front(num_nodes)
+        , _next(num_nodes)
+        , _threads(num_threads)
+    {
+        this->_clear_parents();
+    }
+
+    [[nodiscard]] auto number_of_nodes() const -> std::size_t
+    {
+        return this->_level.size();
+    }
+
+    [[nodiscard]] auto level(node_t v) const -> node_t
+    {
+        return this->_level[v];
+    }
+
+    [[nodiscard]] auto parent(node_t v) const -> node_t
+    {
+        return this->_parent[v].load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto reached(node_t v) const -> bool
+    {
+        return this->_level[v] != none;
+    }
+
+    [[nodiscard]] auto levels() const -> const std::vector<node_t>&
+    {
+        return this->_level;
+    }
+
+    [[nodiscard]] auto parents() const -> std::vector<node_t>
+    {
+        auto result = std::vector<node_t>(this->_parent.size());
+        for (auto v = std::size_t(0); v != result.size(); ++v)
+        {
+            result[v] = this->parent(node_t(v));
+        }
+        return result;
+    }
+
+    void _clear_parents()
+    {
+        for (auto& p : this->_parent)
+        {
+            p.store(none, std::memory_order_relaxed);
+        }
+    }
+};
+
+/*! Call `body(tid, i)` for i in `[first, last)`, on the pool if any. */
+template <typename Body>
+void _for_range(ThreadPool* pool, std::size_t first, std::size_t last,
+    std::size_t grain, Body&& body)
+{
+    if (pool == nullptr)
+    {
+        for (auto i = first; i != last; ++i)
+        {
+            body(0U, i);
+        }
+        return;
+    }
+    parallel_for(*pool, first, last, grain, body);
+}
+
+/*! One top-down step; return the number of arcs out of the new
+    frontier. */
+template <typename CSR>
+auto _bfs_top_down(const CSR& G, BFSTreeWorkspace& ws, std::uint32_t depth,
+    ThreadPool* pool) -> std::size_t
+{
+    const auto concurrent = pool != nullptr && pool->size() > 1;
+    _for_range(pool, 0, ws._queue.size(), 64,
+        [&](unsigned tid, std::size_t i) {
+            const auto u = ws._queue[i];
+            auto& t = ws._threads[tid];
+            for (auto v : G.neighbors(u))
+            {
+                auto& parent = ws._parent[v];
+                auto expected = parent.load(std::memory_order_relaxed);
+                if (expected != ws.none)
+                {
+                    continue;
+                }
+                if (!concurrent)
+                {
+                    parent.store(u, std::memory_order_relaxed);
+                }
+                else if (!parent.compare_exchange_strong(
+                             expected, u, std::memory_order_relaxed))
+                {
+                    continue;
+                }
+                ws._level[v] = depth + 1;
+                t._queue.push_back(v);
+                t._count += G.degree(v);
+            }
+        });
+    ws._queue.clear();
+    auto scout = std::size_t(0);
+    for (auto& t : ws._threads)
+    {
+        ws._queue.insert(ws._queue.end(), t._queue.begin(), t._queue.end());
+        t._queue.clear();
+        scout += t._count;
+        t._count = 0;
+    }
+    return scout;
+}
+
+/*! One bottom-up step from `ws._front` into `ws._next`; return the size
+    of the new frontier.  Each thread owns whole words of the bitmaps. */
+template <typename CSR>
+auto _bfs_bottom_up(const CSR& GT, BFSTreeWorkspace& ws, std::uint32_t depth,
+    ThreadPool* pool) -> std::size_t
+{
+    using node_t = BFSTreeWorkspace::node_t;
+    constexpr auto bits = Bitmap::bits_per_word;
+    const auto n = ws.number_of_nodes();
+    ws._next.clear();
+    _for_range(pool, 0, ws._next.num_words(), 16,
+        [&](unsigned tid, std::size_t w) {
+            const auto last = std::min(n, (w + 1) * bits);
+            auto awake = std::size_t(0);
+            for (auto v = node_t(w * bits); v != last; ++v)
+            {
+                if (ws.parent(v) != ws.none)
+                {
+                    continue;
+                }
+                for (auto u : GT.neighbors(v))
+                {
+                    if (ws._front.test(u))
+                    {
+                        ws._parent[v].store(u, std::memory_order_relaxed);
+                        ws._level[v] = depth + 1;
+                        ws._next.set(v);
+                        ++awake;
+                        break;
+                    }
+                }
+            }
+            ws._threads[tid]._count += awake;
+        });
+    ws._front.swap(ws._next);
+    auto awake = std::size_t(0);
+    for (auto& t : ws._threads)
+    {
+        awake += t._count;
+        t._count = 0;
+    }
+    return awake;
+}
+
+template <typename CSR>
+void _direction_optimizing_bfs(const CSR& G, const CSR& GT,
+    BFSTreeWorkspace::node_t source, BFSTreeWorkspace& ws, ThreadPool* pool)
+{
+    using node_t = BFSTreeWorkspace::node_t;
+    constexpr auto bits = Bitmap::bits_per_word;
+
+    const auto n = G.number_of_nodes();
+    assert(ws.number_of_nodes() == n && GT.number_of_nodes() == n);
+    assert(pool == nullptr || ws._threads.size() >= pool->size());
+    std::fill(ws._level.begin(), ws._level.end(), ws.none);
+    ws._clear_parents();
+    // the source is its own parent while the search runs, so that no
+    // step claims it
+    ws._parent[source].store(source, std::memory_order_relaxed);
+    ws._level[source] = 0;
+    ws._queue.assign(1, source);
+
+    auto depth = node_t(0);
+    auto edges_to_check = G.number_of_edges();
+    auto scout = G.degree(source);
+    while (!ws._queue.empty())
+    {
+        if (scout > edges_to_check / ws.alpha)
+        {
+            ws._front.clear();
+            for (auto v : ws._queue)
+            {
+                ws._front.set(v);
+            }
+            auto awake = ws._queue.size();
+            auto old_awake = awake;
+            do
+            {
+                old_awake = awake;
+                awake = _bfs_bottom_up(GT, ws, depth, pool);
+                ++depth;
+            } while (awake >= old_awake || awake > n / ws.beta);
+            ws._queue.clear();
+            for (auto w = std::size_t(0); w != ws._front.num_words(); ++w)
+            {
+                for (auto word = ws._front.word(w); word != 0;
+                     word &= word - 1)
+                {
+                    ws._queue.push_back(
+                        node_t(w * bits + std::size_t(countr_zero(word))));
+                }
+            }
+            scout = 1;
+        }
+        else
+        {
+            edges_to_check -= std::min(edges_to_check, scout);
+            scout = _bfs_top_down(G, ws, depth, pool);
+            ++depth;
+        }
+    }
+    ws._parent[source].store(ws.none, std::memory_order_relaxed);
+}
+
+/*! Compute the BFS levels and parents of all nodes reachable from a
+    source.
+
+    Parameters
+    ----------
+    G : CSRGraph (weights are ignored)
+    GT : its transpose, used by the bottom-up steps (pass G again for the
+        snapshot of an undirected graph)
+    source : starting node
+    ws : BFSTreeWorkspace sized for G
+    pool : ThreadPool to run each step on (optional); ws must have been
+        created for at least `pool.size()` threads
+
+    Notes
+    -----
+    Every query clears the level and parent arrays, so it takes at least
+    O(n) time; for many small searches use
+    `single_source_shortest_path_length` instead.
+
+    Examples
+    --------
+    >>> auto C = xn::to_csr_graph(G);  // undirected
+    >>> auto ws = xn::BFSTreeWorkspace {C.number_of_nodes()};
+    >>> xn::direction_optimizing_bfs(C, C, 0U, ws);
+    >>> ws.level(5);
+*/
+template <typename CSR>
+void direction_optimizing_bfs(const CSR& G, const CSR& GT,
+    BFSTreeWorkspace::node_t source, BFSTreeWorkspace& ws)
+{
+    _direction_optimizing_bfs(G, GT, source, ws, nullptr);
+}
+
+template <typename CSR>
+void direction_optimizing_bfs(const CSR& G, const CSR& GT,
+    BFSTreeWorkspace::node_t source, BFSTreeWorkspace& ws, ThreadPool& pool)
+{
+    _direction_optimizing_bfs(G, GT, source, ws, &pool);
+}
+
+/*! A set of up to Width sources of a multi-source BFS, one bit each.
+
+    Width is 64, 256 or 512.  The word-wise loops compile to SIMD
+    instructions for the wider masks.
+*/
+template <std::size_t Width>
+class SourceMask
+{
+    static_assert(Width % 64 == 0, "Width must be a multiple of 64");
+
+  public:
+    static constexpr std::size_t num_words = Width / 64;
+
+    std::array<std::uint64_t, num_words> _words {};
+
+    [[nodiscard]] auto test(std::size_t i) const -> bool
+    {
+        return (this->_words[i / 64] >> (i % 64)) & 1U;
+    }
+
+    void set(std::size_t i)
+    {
+        this->_words[i / 64] |= std::uint64_t(1) << (i % 64);
+    }
+
+    [[nodiscard]] auto any() const -> bool
+    {
+        auto bits = std::uint64_t(0);
+        for (auto w : this->_words)
+        {
+            bits |= w;
+        }
+        return bits != 0;
+    }
+
+    [[nodiscard]] auto count() const -> std::size_t
+    {
+        auto total = std::size_t(0);
+        for (auto w : this->_words)
+        {
+            total += std::size_t(popcount(w));
+        }
+        return total;
+    }
+
+    /*! Call `fn(i)` for every bit i set, in increasing order. */
+    template <typename Fn>
+    void for_each(Fn&& fn) const
+    {
+        for (auto k = std::size_t(0); k != num_words; ++k)
+        {
+            for (auto w = this->_words[k]; w != 0; w &= w - 1)
+            {
+                fn(k * 64 + std::size_t(countr_zero(w)));
+            }
+        }
+    }
+
+    auto operator|=(const SourceMask& other) -> SourceMask&
+    {
+        for (auto k = std::size_t(0); k != num_words; ++k)
+        {
+            this->_words[k] |= other._words[k];
+        }
+        return *this;
+    }
+
+    /*! Return the bits of *this that are not in other. */
+    [[nodiscard]] auto without(const SourceMask& other) const -> SourceMask
+    {
+        auto result = SourceMask {};
+        for (auto k = std::size_t(0); k != num_words; ++k)
+        {
+            result._words[k] = this->_words[k] & ~other._words[k];
+        }
+        return result;
+    }
+};
+
+/*! Per-batch state of `multi_source_bfs`: the seen, visit and next masks
+    of every node.  Memory is `3 * Width / 8` bytes per node.
+*/
+template <std::size_t Width>
+class MultiSourceBFSWorkspace
+{
+  public:
+    using node_t = std::uint32_t;
+    using mask_t = SourceMask<Width>;
+
+    static constexpr std::size_t width = Width;
+
+    std::vector<mask_t> _seen;
+    std::vector<mask_t> _visit;
+    std::vector<mask_t> _next;
+
+    explicit MultiSourceBFSWorkspace(std::size_t num_nodes)
+        : _seen(num_nodes)
+        , _visit(num_nodes)
+        , _next(num_nodes)
+    {
+    }
+
+    [[nodiscard]] auto number_of_nodes() const -> std::size_t
+    {
+        return this->_seen.size();
+    }
+
+    /*! Clear all masks, including those left by a batch that threw. */
+    void reset()
+    {
+        std::fill(this->_seen.begin(), this->_seen.end(), mask_t {});
+        std::fill(this->_visit.begin(), this->_visit.end(), mask_t {});
+        std::fill(this->_next.begin(), this->_next.end(), mask_t {});
+    }
+};
+
+/*! Run a breadth-first search from each of up to Width sources at once.
+
+    For every level and every node reached at that level by some of the
+    searches, `visit(v, level, mask)` is called once; bit i of mask is set
+    if the search from `sources[i]` reaches v at that level.  Level 0
+    reports the sources themselves.
+
+    Parameters
+    ----------
+    G : CSRGraph (weights are ignored)
+    sources : container of at most Width nodes (duplicates allowed)
+    ws : MultiSourceBFSWorkspace sized for G
+    visit : callable `visit(node, level, const SourceMask<Width>&)`
+    cutoff : depth to stop the searches
+
+    Notes
+    -----
+    Every level scans all n masks, so the batch pays O(n) per level on
+    top of the arcs out of its frontier; batches of sources that are
+    close together share the most work.
+
+    Examples
+    --------
+    >>> auto ws = xn::MultiSourceBFSWorkspace<64> {C.number_of_nodes()};
+    >>> auto farness = std::vector<std::size_t>(64);
+    >>> xn::multi_source_bfs(C, sources, ws, [&](auto, auto d, auto& m) {
+    ...     m.for_each([&](auto i) { farness[i] += d; });
+    ... });
+*/
+template <typename CSR, typename Sources, std::size_t Width, typename Visit>
+void multi_source_bfs(const CSR& G, const Sources& sources,
+    MultiSourceBFSWorkspace<Width>& ws, Visit&& visit,
+    std::uint32_t cutoff = std::numeric_limits<std::uint32_t>::max())
+{
+    using node_t = typename MultiSourceBFSWorkspace<Width>::node_t;
+    using mask_t = SourceMask<Width>;
+
+    const auto n = G.number_of_nodes();
+    assert(ws.number_of_nodes() == n);
+    ws.reset();
+    auto i = std::size_t(0);
+    for (auto&& s : sources)
+    {
+        assert(i < Width);
+        ws._seen[node_t(s)].set(i);
+        ws._visit[node_t(s)].set(i);
+        ++i;
+    }
+    auto active = false;
+    for (auto v = node_t(0); v != n; ++v)
+    {
+        const auto& mask = ws._visit[v];
+        if (mask.any())
+        {
+            visit(v, std::uint32_t(0), mask);
+            active = true;
+        }
+    }
+
+    for (auto level = std::uint32_t(1); active && level <= cutoff; ++level)
+    {
+        for (auto v = node_t(0); v != n; ++v)
+        {
+            if (!ws._visit[v].any())
+            {
+                continue;
+            }
+            for (auto u : G.neighbors(v))
+            {
+                ws._next[u] |= ws._visit[v];
+            }
+        }
+        active = false;
+        for (auto u = node_t(0); u != n; ++u)
+        {
+            ws._visit[u] = ws._next[u].without(ws._seen[u]);
+            ws._next[u] = mask_t {};
+            const auto& mask = ws._visit[u];
+            if (mask.any())
+            {
+                ws._seen[u] |= mask;
+                visit(u, level, mask);
+                active = true;
+            }
+        }
+    }
+}
+
+} // namespace xn
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace xn
+{
+
+/*! Compressed sparse row (CSR) adjacency of a graph with integer nodes.
+
+    A CSRGraph is an immutable snapshot of a graph whose nodes are the
+    integers `0 .. n-1`.  The arcs leaving node `u` are stored contiguously
+    in `_targets[_offsets[u] .. _offsets[u + 1])`, and their weights (if
+    any) at the same positions of `_weights`.  An arc is identified by its
+    position in `_targets`, so per-edge results can be kept in flat arrays.
+
+    Undirected graphs store every edge twice, once per direction.  An
+    unweighted CSRGraph keeps `_weights` empty and reports unit weights.
+
+    See Also
+    --------
+    to_csr_graph, csr_graph_from_edges
+
+    Examples
+    --------
+    >>> auto G = xn::SimpleGraph {4};
+    >>> G.add_edge(0, 1);
+    >>> G.add_edge(1, 2);
+    >>> auto C = xn::to_csr_graph(G);
+    >>> C.degree(1);
+    2
+*/
+template <typename Weight = int>
+class CSRGraph
+{
+  public:
+    using node_t = std::uint32_t;
+    using edge_id_t = std::size_t;
+    using weight_t = Weight;
+
+    /*! A contiguous read-only range, used for the neighbors of a node. */
+    template <typename T>
+    struct Slice
+    {
+        const T* _first;
+        const T* _last;
+
+        [[nodiscard]] auto begin() const -> const T*
+        {
+            return this->_first;
+        }
+
+        [[nodiscard]] auto end() const -> const T*
+        {
+            return this->_last;
+        }
+
+        [[nodiscard]] auto size() const -> std::size_t
+        {
+            return static_cast<std::size_t>(this->_last - this->_first);
+        }
+
+        [[nodiscard]] auto empty() const -> bool
+        {
+            return this->_first == this->_last;
+        }
+
+        auto operator[](std::size_t i) const -> const T&
+        {
+            return this->_first[i];
+        }
+    };
+
+    std::vector<edge_id_t> _offsets {0}; // number_of_nodes() + 1 entries
+    std::vector<node_t> _targets;
+    std::vector<Weight> _weights; // empty if the graph is unweighted
+
+    CSRGraph() = default;
+
+    /*! Initialize from raw CSR arrays.
+
+        Parameters
+        ----------
+        offsets : row offsets, one more entry than there are nodes
+        targets : arc heads, `offsets.back()` entries
+        weights : arc weights, either empty or parallel to `targets`
+    */
+    CSRGraph(std::vector<edge_id_t> offsets, std::vector<node_t> targets,
+        std::vector<Weight> weights = {})
+        : _offsets {std::move(offsets)}
+        , _targets {std::move(targets)}
+        , _weights {std::move(weights)}
+    {
+        assert(!this->_offsets.empty());
+        assert(this->_offsets.back() == this->_targets.size());
+        assert(this->_weights.empty()
+            || this->_weights.size() == this->_targets.size());
+    }
+
+    [[nodiscard]] auto number_of_nodes() const -> std::size_t
+    {
+        return this->_offsets.size() - 1;
+    }
+
+    /*! Return the number of stored arcs (twice the number of edges for
+        an undirected graph). */
+    [[nodiscard]] auto number_of_edges() const -> std::size_t
+    {
+        return this->_targets.size();
+    }
+
+    [[nodiscard]] auto is_weighted() const -> bool
+    {
+        return !this->_weights.empty();
+    }
+
+    [[nodiscard]] auto degree(node_t u) const -> std::size_t
+    {
+        return this->_offsets[u + 1] - this->_offsets[u];
+    }
+
+    [[nodiscard]] auto edge_begin(node_t u) const -> edge_id_t
+    {
+        return this->_offsets[u];
+    }
+
+    [[nodiscard]] auto edge_end(node_t u) const -> edge_id_t
+    {
+        return this->_offsets[u + 1];
+    }
+
+    [[nodiscard]] auto target(edge_id_t e) const -> node_t
+    {
+        return this->_targets[e];
+    }
+
+    [[nodiscard]] auto weight(edge_id_t e) const -> Weight
+    {
+        return this->_weights.empty() ? Weight(1) : this->_weights[e];
+    }
+
+    [[nodiscard]] auto neighbors(node_t u) const -> Slice<node_t>
+    {
+        const auto* base = this->_targets.data();
+        return Slice<node_t> {
+            base + this->_offsets[u], base + this->_offsets[u + 1]};
+    }
+
+    /*! Return the graph with every arc reversed.
+
+        For a directed graph the rows of the transpose are the predecessor
+        lists.  Arcs keep their relative order, so the rows stay sorted if
+        the rows of this graph were sorted.
+    */
+    [[nodiscard]] auto transpose() const -> CSRGraph
+    {
+        const auto n = this->number_of_nodes();
+        auto offsets = std::vector<edge_id_t>(n + 1, 0);
+        for (auto v : this->_targets)
+        {
+            ++offsets[v + 1];
+        }
+        for (auto i = 0U; i != n; ++i)
+        {
+            offsets[i + 1] += offsets[i];
+        }
+        auto fill = std::vector<edge_id_t>(offsets.begin(), offsets.end() - 1);
+        auto targets = std::vector<node_t>(this->_targets.size());
+        auto weights = std::vector<Weight>(this->_weights.size());
+        for (node_t u = 0; u != n; ++u)
+        {
+            for (auto e = this->edge_begin(u); e != this->edge_end(u); ++e)
+            {
+                const auto pos = fill[this->_targets[e]]++;
+                targets[pos] = u;
+                if (!weights.empty())
+                {
+                    weights[pos] = this->_weights[e];
+                }
+            }
+        }
+        return CSRGraph {
+            std::move(offsets), std::move(targets), std::move(weights)};
+    }
+};
+
+/*! Build a CSRGraph from an arc list.
+
+    Parameters
+    ----------
+    num_nodes : number of nodes
+    edges : container of (u, v) pairs
+    weights : container of arc weights parallel to `edges`, or empty
+
+    Notes
+    -----
+    Arcs are placed with a counting sort, so each row keeps the order in
+    which its arcs appear in `edges`.  Pass every undirected edge in both
+    directions.
+*/
+template <typename Weight = int, typename C1,
+    typename C2 = std::vector<Weight>>
+auto csr_graph_from_edges(
+    std::size_t num_nodes, const C1& edges, const C2& weights = C2 {})
+    -> CSRGraph<Weight>
+{
+    using node_t = typename CSRGraph<Weight>::node_t;
+    using edge_id_t = typename CSRGraph<Weight>::edge_id_t;
+
+    auto offsets = std::vector<edge_id_t>(num_nodes + 1, 0);
+    for (const auto& e : edges)
+    {
+        ++offsets[static_cast<std::size_t>(e.first) + 1];
+    }
+    for (auto i = 0U; i != num_nodes; ++i)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+    auto fill = std::vector<edge_id_t>(offsets.begin(), offsets.end() - 1);
+    auto targets = std::vector<node_t>(offsets.back());
+    const auto weighted = std::size(weights) != 0;
+    auto w = std::vector<Weight>(weighted ? targets.size() : 0);
+    auto it = std::begin(weights);
+    for (const auto& e : edges)
+    {
+        const auto pos = fill[static_cast<std::size_t>(e.first)]++;
+        targets[pos] = node_t(e.second);
+        if (!w.empty())
+        {
+            w[pos] = Weight(*it);
+            ++it;
+        }
+    }
+    return CSRGraph<Weight> {
+        std::move(offsets), std::move(targets), std::move(w)};
+}
+
+/*! Take an unweighted CSR snapshot of a graph with nodes `0 .. n-1`.
+
+    Works with `SimpleGraph`, `SimpleDiGraphS` and any graph whose nodes
+    are consecutive integers and whose `G[u]` iterates over the neighbors
+    of `u`.  Rows are sorted by neighbor.
+*/
+template <typename Graph>
+auto to_csr_graph(const Graph& G) -> CSRGraph<int>
+{
+    using node_t = CSRGraph<int>::node_t;
+
+    const auto n = static_cast<std::size_t>(G.number_of_nodes());
+    auto offsets = std::vector<std::size_t>(n + 1, 0);
+    auto targets = std::vector<node_t> {};
+    for (auto u = 0U; u != n; ++u)
+    {
+        for (auto&& v : G[typename Graph::Node(u)])
+        {
+            targets.push_back(node_t(v));
+        }
+        std::sort(targets.begin() + offsets[u], targets.end());
+        offsets[u + 1] = targets.size();
+    }
+    return CSRGraph<int> {std::move(offsets), std::move(targets)};
+}
+
+/*! Take a weighted CSR snapshot of a graph with nodes `0 .. n-1`.
+
+    Parameters
+    ----------
+    G : graph with consecutive integer nodes
+    get_weight : callable mapping an edge `(u, v)` to its weight
+
+    Examples
+    --------
+    >>> auto G = xn::SimpleDiGraphS {3};
+    >>> G.add_edge(0, 1, 4);
+    >>> auto get_weight = [&](const auto& e) { return G[e.first][e.second]; };
+    >>> auto C = xn::to_csr_graph<int>(G, get_weight);
+*/
+template <typename Weight, typename Graph, typename Callable>
+auto to_csr_graph(const Graph& G, Callable&& get_weight) -> CSRGraph<Weight>
+{
+    using node_t = typename CSRGraph<Weight>::node_t;
+    using Node = typename Graph::Node;
+    using edge_t = typename Graph::edge_t;
+
+    const auto n = static_cast<std::size_t>(G.number_of_nodes());
+    auto offsets = std::vector<std::size_t>(n + 1, 0);
+    auto row = std::vector<std::pair<node_t, Weight>> {};
+    auto targets = std::vector<node_t> {};
+    auto weights = std::vector<Weight> {};
+    for (auto u = 0U; u != n; ++u)
+    {
+        row.clear();
+        for (auto&& v : G[Node(u)])
+        {
+            const auto w = get_weight(edge_t {Node(u), Node(v)});
+            row.emplace_back(node_t(v), Weight(w));
+        }
+        std::sort(row.begin(), row.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (const auto& [v, w] : row)
+        {
+            targets.push_back(v);
+            weights.push_back(w);
+        }
+        offsets[u + 1] = targets.size();
+    }
+    return CSRGraph<Weight> {
+        std::move(offsets), std::move(targets), std::move(weights)};
+}
+
+} // namespace xn
@@ -241,7 +241,7 @@ class DiGraphS : public Graph<nodeview_t, adjlist_t, adjlist_outer_dict_factory>
     }
 
     explicit DiGraphS(int num_nodes)
-        : _Base {num_nodes}
+        : _Base {static_cast<uint32_t>(num_nodes)}
         , _succ {_Base::_adj}
     {
     }
@@ -265,7 +265,7 @@ class Graph : public object
     }
 
     explicit Graph(uint32_t num_nodes)
-        : _node {py::range(num_nodes)}
+        : _node {py::range(Node(num_nodes))}
         , _adj(num_nodes) // std::vector
     {
     }
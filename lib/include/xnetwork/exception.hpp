@@ -1,9 +1,12 @@
 // -*- coding: utf-8 -*-
 #pragma once
 
+#include <cstddef>
 #include <exception>
 // #include <initializer_list>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 
 /*!
 **********
@@ -37,7 +40,7 @@ namespace xn
 struct XNetworkException : std::runtime_error
 {
     explicit XNetworkException(std::string_view msg)
-        : std::runtime_error(msg)
+        : std::runtime_error(std::string(msg))
     {
     }
 };
@@ -178,19 +181,22 @@ struct ExceededMaxIterations : XNetworkException
     }
 };
 
-//     /*! Raised when the power iteration method fails to converge within a
-//     specified iteration limit.
-//
-//     `num_iterations` is the number of iterations that have been
-//     completed when this exception was raised.
-//
-//      */
-// class PowerIterationFailedConvergence : ExceededMaxIterations {
-//     explicit _Self( num_iterations, *args, **kw) {
-//         const auto msg = "power iteration failed to converge within {}
-//         iterations"; exception_message = msg.format(num_iterations);
-//         superinit = super(PowerIterationFailedConvergence, *this).__init__
-//         superinit( exception_message, *args, **kw);
-//     }
-// };
+/*! Raised when the power iteration method fails to converge within a
+specified iteration limit.
+
+`_num_iterations` is the number of iterations that have been
+completed when this exception was raised.
+ */
+struct PowerIterationFailedConvergence : ExceededMaxIterations
+{
+    std::size_t _num_iterations;
+
+    explicit PowerIterationFailedConvergence(std::size_t num_iterations)
+        : ExceededMaxIterations("power iteration failed to converge within "
+              + std::to_string(num_iterations) + " iterations")
+        , _num_iterations {num_iterations}
+    {
+    }
+};
+
 } // namespace xn
@@ -0,0 +1,443 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Preconditioned conjugate gradient solves with grounded graph Laplacians.
+
+The Laplacian L of a connected undirected graph is singular: its kernel
+holds the constant vectors.  Fixing the potential of one node, the
+ground, to zero removes the kernel; the rows and columns of the ground
+then drop out and what is left is symmetric positive definite.  For a
+right-hand side b whose entries sum to zero, the solution x of the
+grounded system is a potential vector with L x = b, up to the constant
+set by the ground, which is all that potential differences, currents and
+effective resistances need.
+
+The grounded matrix is kept in CSR form with the ground row replaced by
+the identity, so vectors keep one entry per node.  The preconditioner is
+either Jacobi (the weighted degrees) or a zero fill-in incomplete
+Cholesky factor; the grounded Laplacian is an M-matrix, so the
+incomplete factorization does not break down.  A single solve runs on
+one thread: callers run independent solves in parallel, each with a
+`CGWorkspace` of its own.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <xnetwork/exception.hpp>
+
+namespace xn
+{
+
+/*! Preconditioner of the conjugate gradient. */
+enum class LaplacianPreconditioner
+{
+    jacobi,
+    incomplete_cholesky
+};
+
+/*! Per-thread vectors of a conjugate gradient solve. */
+class CGWorkspace
+{
+  public:
+    std::vector<double> _r;
+    std::vector<double> _z;
+    std::vector<double> _p;
+    std::vector<double> _q;
+
+    explicit CGWorkspace(std::size_t num_nodes = 0)
+        : _r(num_nodes)
+        , _z(num_nodes)
+        , _p(num_nodes)
+        , _q(num_nodes)
+    {
+    }
+};
+
+/*! The Laplacian of an undirected graph, grounded at one node.
+
+    Parameters
+    ----------
+    G : CSRGraph holding both directions of every edge; the weights (or
+        1) are the conductances.  The arcs u -> v with u < v give the
+        edges; parallel edges add up and self-loops are ignored.
+    preconditioner : LaplacianPreconditioner
+
+    Raises
+    ------
+    XNetworkPointlessConcept
+        If G has no nodes.
+    XNetworkError
+        If G is not connected or a conductance is not positive.
+
+    Examples
+    --------
+    >>> auto L = xn::GroundedLaplacian {C};
+    >>> auto ws = xn::CGWorkspace {L.number_of_nodes()};
+    >>> auto b = std::vector<double>(n);
+    >>> b[s] = 1.0, b[t] = -1.0;  // unit current from s to t
+    >>> auto x = std::vector<double>(n);
+    >>> L.solve(b, x, ws);  // x[s] - x[t] is the effective resistance
+*/
+class GroundedLaplacian
+{
+  public:
+    using node_t = std::uint32_t;
+
+    /*! An edge u < v with its total conductance. */
+    struct Edge
+    {
+        node_t _u;
+        node_t _v;
+        double _conductance;
+    };
+
+    std::vector<Edge> _edges; // sorted by (u, v)
+    node_t _ground = 0;
+    LaplacianPreconditioner _preconditioner;
+    // off-diagonal entries -c(u, v) by rows, with sorted columns; the
+    // rows and columns of the ground are left out
+    std::vector<std::size_t> _offsets;
+    std::vector<node_t> _columns;
+    std::vector<double> _values;
+    std::vector<double> _diag; // weighted degrees; 1 at the ground
+    // incomplete Cholesky factor: row i holds the entries left of the
+    // diagonal at _offsets[i], ..., _offsets[i] + _lower[i] - 1
+    std::vector<std::size_t> _lower;
+    std::vector<double> _factor;
+    std::vector<double> _factor_diag;
+
+    template <typename CSR>
+    explicit GroundedLaplacian(const CSR& G,
+        LaplacianPreconditioner preconditioner =
+            LaplacianPreconditioner::incomplete_cholesky)
+        : _preconditioner {preconditioner}
+    {
+        const auto n = G.number_of_nodes();
+        if (n == 0)
+        {
+            throw XNetworkPointlessConcept("G has no nodes.");
+        }
+        this->_collect_edges(G);
+        this->_check_connected(n);
+        this->_assemble(n);
+        if (preconditioner == LaplacianPreconditioner::incomplete_cholesky)
+        {
+            this->_factorize();
+        }
+    }
+
+    [[nodiscard]] auto number_of_nodes() const -> std::size_t
+    {
+        return this->_diag.size();
+    }
+
+    [[nodiscard]] auto edges() const -> const std::vector<Edge>&
+    {
+        return this->_edges;
+    }
+
+    /*! Set `y = A x`, A the grounded Laplacian (identity at the ground). */
+    void multiply(const double* x, double* y) const
+    {
+        const auto n = this->number_of_nodes();
+        for (auto i = std::size_t(0); i != n; ++i)
+        {
+            auto s = this->_diag[i] * x[i];
+            for (auto e = this->_offsets[i]; e != this->_offsets[i + 1]; ++e)
+            {
+                s += this->_values[e] * x[this->_columns[e]];
+            }
+            y[i] = s;
+        }
+    }
+
+    /*! Set `z = M^-1 r` for the preconditioner M. */
+    void precondition(const double* r, double* z) const
+    {
+        const auto n = this->number_of_nodes();
+        if (this->_preconditioner == LaplacianPreconditioner::jacobi)
+        {
+            for (auto i = std::size_t(0); i != n; ++i)
+            {
+                z[i] = r[i] / this->_diag[i];
+            }
+            return;
+        }
+        // forward: F y = r, row by row
+        for (auto i = std::size_t(0); i != n; ++i)
+        {
+            auto s = r[i];
+            const auto first = this->_offsets[i];
+            for (auto e = first; e != first + this->_lower[i]; ++e)
+            {
+                s -= this->_factor[e] * z[this->_columns[e]];
+            }
+            z[i] = s / this->_factor_diag[i];
+        }
+        // backward: F^T z = y, scattering each solved entry up its column
+        for (auto i = n; i-- != 0;)
+        {
+            z[i] /= this->_factor_diag[i];
+            const auto first = this->_offsets[i];
+            for (auto e = first; e != first + this->_lower[i]; ++e)
+            {
+                z[this->_columns[e]] -= this->_factor[e] * z[i];
+            }
+        }
+    }
+
+    /*! Solve `L x = b` with x zero at the ground.
+
+        Parameters
+        ----------
+        b : right-hand side; the entry of the ground is ignored.  For the
+            potentials of a current, the entries sum to zero.
+        x : the solution, resized to the number of nodes
+        ws : CGWorkspace of this thread
+        tol : stop once the residual norm is at most `tol` times the norm
+            of b
+        max_iter : maximum number of iterations; 0 means the number of
+            nodes, but at least 100
+
+        Returns
+        -------
+        The number of iterations.
+
+        Raises
+        ------
+        ExceededMaxIterations
+            If the residual is still too large after max_iter iterations.
+    */
+    auto solve(const std::vector<double>& b, std::vector<double>& x,
+        CGWorkspace& ws, double tol = 1.0e-8, std::size_t max_iter = 0) const
+        -> std::size_t
+    {
+        const auto n = this->number_of_nodes();
+        if (max_iter == 0)
+        {
+            max_iter = std::max(n, std::size_t(100));
+        }
+        x.assign(n, 0.0);
+        auto& r = ws._r;
+        auto& z = ws._z;
+        auto& p = ws._p;
+        auto& q = ws._q;
+        r.assign(b.begin(), b.end());
+        r[this->_ground] = 0.0;
+        z.resize(n);
+        q.resize(n);
+        const auto bound = tol * std::sqrt(_dot(r, r));
+        if (bound == 0.0)
+        {
+            return 0;
+        }
+        this->precondition(r.data(), z.data());
+        p = z;
+        auto rz = _dot(r, z);
+        for (auto it = std::size_t(1); it <= max_iter; ++it)
+        {
+            this->multiply(p.data(), q.data());
+            const auto alpha = rz / _dot(p, q);
+            auto rr = 0.0;
+            for (auto i = std::size_t(0); i != n; ++i)
+            {
+                x[i] += alpha * p[i];
+                r[i] -= alpha * q[i];
+                rr += r[i] * r[i];
+            }
+            if (std::sqrt(rr) <= bound)
+            {
+                return it;
+            }
+            this->precondition(r.data(), z.data());
+            const auto rz_next = _dot(r, z);
+            const auto beta = rz_next / rz;
+            rz = rz_next;
+            for (auto i = std::size_t(0); i != n; ++i)
+            {
+                p[i] = z[i] + beta * p[i];
+            }
+        }
+        throw ExceededMaxIterations("conjugate gradient failed to converge "
+                                    "within "
+            + std::to_string(max_iter) + " iterations");
+    }
+
+  private:
+    static auto _dot(const std::vector<double>& a,
+        const std::vector<double>& b) -> double
+    {
+        return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
+    }
+
+    template <typename CSR>
+    void _collect_edges(const CSR& G)
+    {
+        const auto n = G.number_of_nodes();
+        for (auto u = node_t(0); u != n; ++u)
+        {
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                const auto v = G.target(e);
+                if (u >= v)
+                {
+                    continue;
+                }
+                const auto c = double(G.weight(e));
+                if (!(c > 0.0))
+                {
+                    throw XNetworkError("conductances must be positive");
+                }
+                this->_edges.push_back(Edge {u, v, c});
+            }
+        }
+        auto& E = this->_edges;
+        std::sort(E.begin(), E.end(), [](const Edge& a, const Edge& b) {
+            return a._u != b._u ? a._u < b._u : a._v < b._v;
+        });
+        // merge parallel edges
+        auto last = std::size_t(0);
+        for (auto i = std::size_t(0); i != E.size(); ++i)
+        {
+            if (last != 0 && E[last - 1]._u == E[i]._u
+                && E[last - 1]._v == E[i]._v)
+            {
+                E[last - 1]._conductance += E[i]._conductance;
+            }
+            else
+            {
+                E[last++] = E[i];
+            }
+        }
+        E.resize(last);
+    }
+
+    void _check_connected(std::size_t n) const
+    {
+        // union-find with path halving over the edges
+        auto parent = std::vector<node_t>(n);
+        std::iota(parent.begin(), parent.end(), node_t(0));
+        auto find = [&](node_t v) {
+            while (parent[v] != v)
+            {
+                v = parent[v] = parent[parent[v]];
+            }
+            return v;
+        };
+        auto components = n;
+        for (const auto& e : this->_edges)
+        {
+            const auto a = find(e._u);
+            const auto b = find(e._v);
+            if (a != b)
+            {
+                parent[std::max(a, b)] = std::min(a, b);
+                --components;
+            }
+        }
+        if (components != 1)
+        {
+            throw XNetworkError("Graph not connected.");
+        }
+    }
+
+    void _assemble(std::size_t n)
+    {
+        this->_diag.assign(n, 0.0);
+        auto degree = std::vector<std::size_t>(n, 0);
+        for (const auto& e : this->_edges)
+        {
+            this->_diag[e._u] += e._conductance;
+            this->_diag[e._v] += e._conductance;
+            ++degree[e._u];
+            ++degree[e._v];
+        }
+        // ground the node of largest degree: it removes the most entries
+        this->_ground = node_t(
+            std::max_element(degree.begin(), degree.end()) - degree.begin());
+        const auto g = this->_ground;
+        this->_diag[g] = 1.0;
+        this->_offsets.assign(n + 1, 0);
+        for (const auto& e : this->_edges)
+        {
+            if (e._u != g && e._v != g)
+            {
+                ++this->_offsets[e._u + 1];
+                ++this->_offsets[e._v + 1];
+            }
+        }
+        std::partial_sum(this->_offsets.begin(), this->_offsets.end(),
+            this->_offsets.begin());
+        const auto nnz = this->_offsets[n];
+        this->_columns.resize(nnz);
+        this->_values.resize(nnz);
+        this->_lower.assign(n, 0);
+        // the edges come sorted by (u, v): row v receives its entries
+        // u < v before the entries w > v, so every row ends up sorted
+        auto fill = std::vector<std::size_t>(
+            this->_offsets.begin(), this->_offsets.end() - 1);
+        for (const auto& e : this->_edges)
+        {
+            if (e._u == g || e._v == g)
+            {
+                continue;
+            }
+            this->_columns[fill[e._u]] = e._v;
+            this->_values[fill[e._u]++] = -e._conductance;
+            this->_columns[fill[e._v]] = e._u;
+            this->_values[fill[e._v]++] = -e._conductance;
+            ++this->_lower[e._v];
+        }
+    }
+
+    /*! Zero fill-in incomplete Cholesky, row by row (left-looking). */
+    void _factorize()
+    {
+        const auto n = this->number_of_nodes();
+        this->_factor.assign(this->_values.size(), 0.0);
+        this->_factor_diag.assign(n, 0.0);
+        for (auto i = std::size_t(0); i != n; ++i)
+        {
+            const auto fi = this->_offsets[i];
+            const auto li = fi + this->_lower[i];
+            auto pivot = this->_diag[i];
+            for (auto e = fi; e != li; ++e)
+            {
+                const auto k = this->_columns[e];
+                // sparse dot of rows i and k left of column k
+                auto s = this->_values[e];
+                auto a = fi;
+                auto b = this->_offsets[k];
+                const auto lk = b + this->_lower[k];
+                while (a != e && b != lk)
+                {
+                    if (this->_columns[a] < this->_columns[b])
+                    {
+                        ++a;
+                    }
+                    else if (this->_columns[b] < this->_columns[a])
+                    {
+                        ++b;
+                    }
+                    else
+                    {
+                        s -= this->_factor[a++] * this->_factor[b++];
+                    }
+                }
+                this->_factor[e] = s / this->_factor_diag[k];
+                pivot -= this->_factor[e] * this->_factor[e];
+            }
+            // positive for an M-matrix; guard against rounding anyway
+            this->_factor_diag[i] =
+                std::sqrt(pivot > 0.0 ? pivot : this->_diag[i]);
+        }
+    }
+};
+
+} // namespace xn
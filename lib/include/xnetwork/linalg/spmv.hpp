@@ -0,0 +1,222 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Sparse matrix-vector products on CSR graphs.
+
+A CSRGraph is read as a sparse matrix whose row i holds the arcs out of
+node i, with the arc weights (or 1) as entries.  `SpMV` multiplies it
+with dense vectors on a thread pool.  The rows are cut into parts of
+about the same number of rows plus nonzeros, so a few high-degree rows
+do not hold up a whole thread, and the parts are handed out by
+`parallel_for`.  The parts depend only on the matrix; reductions are
+summed part by part in order, so the results do not depend on the number
+of threads.
+
+Power iterations such as eigenvector or Katz centrality pull along the
+arcs *into* a node: they multiply with the transpose of the graph.
+*/
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <xnetwork/utils/thread_pool.hpp>
+
+namespace xn
+{
+
+/*! Return the first row of every part of a balanced row partition.
+
+    Parameters
+    ----------
+    offsets : row offsets of a CSR matrix (`n + 1` entries)
+    num_parts : number of parts
+
+    Returns
+    -------
+    `num_parts + 1` row boundaries: part p is `[bounds[p], bounds[p+1])`.
+    Part p ends at the first row where rows plus nonzeros reach p + 1
+    shares of the total.
+*/
+template <typename Offset>
+auto balanced_row_partition(const std::vector<Offset>& offsets,
+    std::size_t num_parts) -> std::vector<std::size_t>
+{
+    const auto n = offsets.size() - 1;
+    const auto total = double(n + std::size_t(offsets[n]));
+    auto bounds = std::vector<std::size_t>(num_parts + 1, n);
+    bounds[0] = 0;
+    auto row = std::size_t(0);
+    for (auto p = std::size_t(1); p < num_parts; ++p)
+    {
+        const auto target = total * double(p) / double(num_parts);
+        // cost(r) = r + offsets[r] is increasing
+        auto lo = row;
+        auto hi = n;
+        while (lo < hi)
+        {
+            const auto mid = lo + (hi - lo) / 2;
+            if (double(mid + std::size_t(offsets[mid])) < target)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        bounds[p] = row = lo;
+    }
+    return bounds;
+}
+
+/*! Multiply a CSR graph, read as a matrix, with dense vectors.
+
+    Parameters
+    ----------
+    A : CSRGraph; it must outlive the SpMV
+    pool : ThreadPool; it must outlive the SpMV
+
+    Examples
+    --------
+    >>> auto AT = C.transpose();  // pull along the arcs into a node
+    >>> auto op = xn::SpMV<decltype(AT)> {AT, pool};
+    >>> auto y = std::vector<double>(n);
+    >>> op.multiply(x, y);  // y = AT x
+*/
+template <typename CSR>
+class SpMV
+{
+  public:
+    /*! Rows plus nonzeros per part; small enough to balance the threads,
+        large enough to amortize a task. */
+    static constexpr std::size_t part_cost = 16384;
+
+    const CSR& _A;
+    ThreadPool& _pool;
+    std::vector<std::size_t> _bounds;
+    std::vector<double> _partial; // one sum per part
+
+    SpMV(const CSR& A, ThreadPool& pool)
+        : _A {A}
+        , _pool {pool}
+    {
+        const auto cost = A.number_of_nodes() + A.number_of_edges();
+        const auto parts = std::max(std::size_t(1), cost / part_cost);
+        this->_bounds = balanced_row_partition(A._offsets, parts);
+        this->_partial.assign(parts, 0.0);
+    }
+
+    [[nodiscard]] auto number_of_parts() const -> std::size_t
+    {
+        return this->_partial.size();
+    }
+
+    /*! Return the dot product of row i with x. */
+    [[nodiscard]] auto row_dot(std::size_t i, const double* x) const -> double
+    {
+        const auto first = this->_A._offsets[i];
+        const auto last = this->_A._offsets[i + 1];
+        const auto* target = this->_A._targets.data();
+        // four independent sums let the loads overlap
+        auto s = std::array<double, 4> {};
+        auto e = first;
+        if (!this->_A.is_weighted())
+        {
+            for (; e + 4 <= last; e += 4)
+            {
+                for (auto k = 0U; k != 4; ++k)
+                {
+                    s[k] += x[target[e + k]];
+                }
+            }
+            for (; e != last; ++e)
+            {
+                s[0] += x[target[e]];
+            }
+        }
+        else
+        {
+            const auto* weight = this->_A._weights.data();
+            for (; e + 4 <= last; e += 4)
+            {
+                for (auto k = 0U; k != 4; ++k)
+                {
+                    s[k] += double(weight[e + k]) * x[target[e + k]];
+                }
+            }
+            for (; e != last; ++e)
+            {
+                s[0] += double(weight[e]) * x[target[e]];
+            }
+        }
+        return (s[0] + s[1]) + (s[2] + s[3]);
+    }
+
+    /*! Call `body(first, last)` on every part in parallel and return the
+        sum of the results, added in part order. */
+    template <typename Body>
+    auto for_each_part(Body&& body) -> double
+    {
+        return this->reduce_parts(std::forward<Body>(body), 0.0,
+            [](double a, double b) { return a + b; });
+    }
+
+    /*! Call `body(first, last)` on every part in parallel and fold the
+        results with `reduce`, from `init` and in part order. */
+    template <typename Body, typename Reduce>
+    auto reduce_parts(Body&& body, double init, Reduce&& reduce) -> double
+    {
+        parallel_for(this->_pool, 0, this->number_of_parts(), 1,
+            [&](unsigned, std::size_t p) {
+                this->_partial[p] =
+                    body(this->_bounds[p], this->_bounds[p + 1]);
+            });
+        auto total = init;
+        for (auto v : this->_partial)
+        {
+            total = reduce(total, v);
+        }
+        return total;
+    }
+
+    /*! Set `y[i] = (A x)_i` for every row. */
+    void multiply(const std::vector<double>& x, std::vector<double>& y)
+    {
+        this->map_rows(x, y, [](std::size_t, double ax) {
+            return std::pair<double, double> {ax, 0.0};
+        });
+    }
+
+    /*! Set `y[i] = fn(i, (A x)_i).first` for every row and return the
+        sum of the `.second` parts, in a single pass over A. */
+    template <typename Fn>
+    auto map_rows(const std::vector<double>& x, std::vector<double>& y,
+        Fn&& fn) -> double
+    {
+        const auto* px = x.data();
+        return this->for_each_part([&](std::size_t first, std::size_t last) {
+            auto sum = 0.0;
+            for (auto i = first; i != last; ++i)
+            {
+                const auto [yi, term] = fn(i, this->row_dot(i, px));
+                y[i] = yi;
+                sum += term;
+            }
+            return sum;
+        });
+    }
+};
+
+/*! Result of a power iteration. */
+struct PowerIterationResult
+{
+    std::vector<double> _x;
+    std::size_t _iterations = 0;
+    double _residual = 0.0; // L1 change of the last iteration
+};
+
+} // namespace xn
@@ -0,0 +1,84 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace xn
+{
+
+/*! A fixed-size set of node ids stored as one bit per node.
+
+    Words are 64 bits wide.  Threads that own disjoint ranges of words
+    may update a bitmap concurrently with `set`; `set_atomic` is for
+    threads that may share a word.  The words are atomics accessed with
+    relaxed ordering, which costs nothing over plain loads and stores.
+*/
+class Bitmap
+{
+    std::vector<std::atomic<std::uint64_t>> _words;
+    std::size_t _size;
+
+  public:
+    static constexpr std::size_t bits_per_word = 64;
+
+    explicit Bitmap(std::size_t size = 0)
+        : _words((size + bits_per_word - 1) / bits_per_word)
+        , _size {size}
+    {
+        this->clear();
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        return this->_size;
+    }
+
+    [[nodiscard]] auto num_words() const -> std::size_t
+    {
+        return this->_words.size();
+    }
+
+    [[nodiscard]] auto word(std::size_t w) const -> std::uint64_t
+    {
+        return this->_words[w].load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto test(std::size_t i) const -> bool
+    {
+        return (this->word(i / bits_per_word) >> (i % bits_per_word)) & 1U;
+    }
+
+    void set(std::size_t i)
+    {
+        auto& w = this->_words[i / bits_per_word];
+        w.store(w.load(std::memory_order_relaxed)
+                | std::uint64_t(1) << (i % bits_per_word),
+            std::memory_order_relaxed);
+    }
+
+    void set_atomic(std::size_t i)
+    {
+        this->_words[i / bits_per_word].fetch_or(
+            std::uint64_t(1) << (i % bits_per_word), std::memory_order_relaxed);
+    }
+
+    void clear()
+    {
+        for (auto& w : this->_words)
+        {
+            w.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void swap(Bitmap& other) noexcept
+    {
+        this->_words.swap(other._words);
+        std::swap(this->_size, other._size);
+    }
+};
+
+} // namespace xn
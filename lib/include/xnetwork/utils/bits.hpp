@@ -0,0 +1,54 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Bit operations on 64-bit words, the C++17 stand-ins for those of <bit>.
+GCC and Clang get their builtins; other compilers get branch-free
+portable code.
+*/
+
+#include <cstdint>
+
+namespace xn
+{
+
+/*! Return the number of one bits of x. */
+inline auto popcount(std::uint64_t x) -> int
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x -= (x >> 1U) & 0x5555555555555555ULL;
+    x = (x & 0x3333333333333333ULL) + ((x >> 2U) & 0x3333333333333333ULL);
+    x = (x + (x >> 4U)) & 0x0f0f0f0f0f0f0f0fULL;
+    return int((x * 0x0101010101010101ULL) >> 56U);
+#endif
+}
+
+/*! Return the number of trailing zero bits of x, 64 if x is 0. */
+inline auto countr_zero(std::uint64_t x) -> int
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return x == 0 ? 64 : __builtin_ctzll(x);
+#else
+    return popcount((x & (~x + 1)) - 1);
+#endif
+}
+
+/*! Return the number of bits needed to represent x, 0 if x is 0. */
+inline auto bit_width(std::uint64_t x) -> int
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return x == 0 ? 0 : 64 - __builtin_clzll(x);
+#else
+    x |= x >> 1U;
+    x |= x >> 2U;
+    x |= x >> 4U;
+    x |= x >> 8U;
+    x |= x >> 16U;
+    x |= x >> 32U;
+    return popcount(x);
+#endif
+}
+
+} // namespace xn
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <xnetwork/utils/bits.hpp>
+
+/*!
+Min-heaps for the native shortest path algorithms.
+
+Both heaps store (key, value) pairs and support `push`, `pop`, `empty`,
+`size` and `clear`.  Neither supports decrease-key: callers push a new
+pair when a key improves and skip stale pairs on `pop` ("lazy deletion").
+`clear()` keeps the allocated storage, so a heap that lives in a reused
+workspace stops allocating once it has grown to its working size.
+*/
+
+namespace xn
+{
+
+/*! An implicit d-ary min-heap.
+
+    A 4-ary heap has half the depth of a binary heap and its children of a
+    node share a cache line, which makes it the usual choice for Dijkstra
+    on sparse graphs.
+
+    Parameters
+    ----------
+    Key : ordered key type
+    Value : payload (usually a node id)
+    D : arity (at least 2)
+*/
+template <typename Key, typename Value = std::uint32_t, unsigned D = 4>
+class DaryHeap
+{
+    static_assert(D >= 2, "arity must be at least 2");
+
+  public:
+    using key_type = Key;
+    using value_type = Value;
+    using item_t = std::pair<Key, Value>;
+
+  private:
+    std::vector<item_t> _heap;
+
+  public:
+    [[nodiscard]] auto empty() const -> bool
+    {
+        return this->_heap.empty();
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        return this->_heap.size();
+    }
+
+    void reserve(std::size_t n)
+    {
+        this->_heap.reserve(n);
+    }
+
+    void clear()
+    {
+        this->_heap.clear();
+    }
+
+    [[nodiscard]] auto top() const -> const item_t&
+    {
+        assert(!this->_heap.empty());
+        return this->_heap.front();
+    }
+
+    void push(const Key& key, const Value& value)
+    {
+        auto i = this->_heap.size();
+        this->_heap.emplace_back(key, value);
+        auto item = this->_heap[i];
+        while (i > 0)
+        {
+            const auto parent = (i - 1) / D;
+            if (!(item.first < this->_heap[parent].first))
+            {
+                break;
+            }
+            this->_heap[i] = this->_heap[parent];
+            i = parent;
+        }
+        this->_heap[i] = item;
+    }
+
+    /*! Remove and return the pair with the minimum key. */
+    auto pop() -> item_t
+    {
+        assert(!this->_heap.empty());
+        auto result = this->_heap.front();
+        auto item = this->_heap.back();
+        this->_heap.pop_back();
+        const auto n = this->_heap.size();
+        if (n == 0)
+        {
+            return result;
+        }
+        auto i = std::size_t(0);
+        while (true)
+        {
+            const auto first = D * i + 1;
+            if (first >= n)
+            {
+                break;
+            }
+            const auto last = first + D < n ? first + D : n;
+            auto best = first;
+            for (auto c = first + 1; c < last; ++c)
+            {
+                if (this->_heap[c].first < this->_heap[best].first)
+                {
+                    best = c;
+                }
+            }
+            if (!(this->_heap[best].first < item.first))
+            {
+                break;
+            }
+            this->_heap[i] = this->_heap[best];
+            i = best;
+        }
+        this->_heap[i] = item;
+        return result;
+    }
+};
+
+/*! A radix heap for non-negative integer keys.
+
+    A radix heap is a monotone priority queue: every pushed key must be at
+    least the last popped key, which always holds for Dijkstra with
+    non-negative integer weights.  Pairs are kept in buckets by the highest
+    bit in which their key differs from the last popped key, so push is
+    O(1) and pop is amortized O(log C) for keys bounded by C.
+
+    Parameters
+    ----------
+    Key : integral key type (values must be non-negative)
+    Value : payload (usually a node id)
+*/
+template <typename Key, typename Value = std::uint32_t>
+class RadixHeap
+{
+    static_assert(std::is_integral<Key>::value, "RadixHeap needs integer keys");
+
+  public:
+    using key_type = Key;
+    using value_type = Value;
+    using item_t = std::pair<Key, Value>;
+
+  private:
+    using ukey_t = std::make_unsigned_t<Key>;
+    static constexpr auto num_bits = std::numeric_limits<ukey_t>::digits;
+
+    std::array<std::vector<item_t>, num_bits + 1> _buckets;
+    ukey_t _last = 0;
+    std::size_t _size = 0;
+
+    /*! Index of the bucket for key k: 0 if k equals the last popped key,
+        otherwise one plus the position of the highest differing bit. */
+    [[nodiscard]] auto _bucket(ukey_t k) const -> std::size_t
+    {
+        return std::size_t(bit_width(std::uint64_t(k ^ this->_last)));
+    }
+
+  public:
+    [[nodiscard]] auto empty() const -> bool
+    {
+        return this->_size == 0;
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        return this->_size;
+    }
+
+    void reserve(std::size_t n)
+    {
+        this->_buckets[0].reserve(n);
+    }
+
+    /*! Remove all pairs and allow keys to start again from zero. */
+    void clear()
+    {
+        for (auto& bucket : this->_buckets)
+        {
+            bucket.clear();
+        }
+        this->_last = 0;
+        this->_size = 0;
+    }
+
+    void push(const Key& key, const Value& value)
+    {
+        assert(!(key < Key(0)) && ukey_t(key) >= this->_last);
+        this->_buckets[this->_bucket(ukey_t(key))].emplace_back(key, value);
+        ++this->_size;
+    }
+
+    /*! Remove and return the pair with the minimum key. */
+    auto pop() -> item_t
+    {
+        assert(this->_size != 0);
+        if (this->_buckets[0].empty())
+        {
+            auto i = std::size_t(1);
+            while (this->_buckets[i].empty())
+            {
+                ++i;
+            }
+            auto& bucket = this->_buckets[i];
+            auto new_last = ukey_t(bucket.front().first);
+            for (const auto& item : bucket)
+            {
+                if (ukey_t(item.first) < new_last)
+                {
+                    new_last = ukey_t(item.first);
+                }
+            }
+            this->_last = new_last;
+            for (const auto& item : bucket)
+            {
+                this->_buckets[this->_bucket(ukey_t(item.first))].push_back(
+                    item);
+            }
+            bucket.clear();
+        }
+        auto result = this->_buckets[0].back();
+        this->_buckets[0].pop_back();
+        --this->_size;
+        return result;
+    }
+};
+
+} // namespace xn
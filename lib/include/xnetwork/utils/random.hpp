@@ -0,0 +1,46 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+#include <cstdint>
+
+namespace xn
+{
+
+/*! A small counter-based random generator (SplitMix64).
+
+    Seeding a generator per sample (from the run seed and the sample
+    index) gives every sample a stream of its own, so randomized
+    estimates do not depend on how the samples are spread over threads.
+*/
+class SplitMix64
+{
+  public:
+    std::uint64_t _state;
+
+    explicit SplitMix64(std::uint64_t seed)
+        : _state(seed)
+    {
+    }
+
+    auto operator()() -> std::uint64_t
+    {
+        auto z = (this->_state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31U);
+    }
+
+    /*! Return a double uniform in [0, 1). */
+    auto uniform() -> double
+    {
+        return double((*this)() >> 11U) * 0x1.0p-53;
+    }
+
+    /*! Return an integer in [0, bound); the bias is below bound / 2^64. */
+    auto below(std::uint64_t bound) -> std::uint64_t
+    {
+        return (*this)() % bound;
+    }
+};
+
+} // namespace xn
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+A small fork-join thread pool for the native parallel algorithms.
+
+`ThreadPool::run(fn)` calls `fn(tid)` once on every thread of the pool
+(the calling thread takes part as thread 0) and returns when all calls
+have finished.  `parallel_for` spreads a loop over the pool: every thread
+starts on its own contiguous block of iterations and, once that block is
+used up, steals chunks from the blocks of the other threads.  Algorithms
+keep one workspace per `tid`, so a loop body never needs a lock.
+*/
+
+namespace xn
+{
+
+/*! Persistent fork-join thread pool.
+
+    Parameters
+    ----------
+    num_threads : total number of threads including the caller
+        (default: `std::thread::hardware_concurrency()`)
+
+    Notes
+    -----
+    `run` is not reentrant: a job must not call `run` on the same pool.
+    The first exception thrown by a job is rethrown by `run`.
+*/
+class ThreadPool
+{
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _start;
+    std::condition_variable _done;
+    std::function<void(unsigned)> _job;
+    std::size_t _generation = 0;
+    unsigned _pending = 0;
+    bool _stop = false;
+    std::exception_ptr _error;
+
+    template <typename Fn>
+    void _execute(Fn& fn, unsigned tid)
+    {
+        try
+        {
+            fn(tid);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            if (!this->_error)
+            {
+                this->_error = std::current_exception();
+            }
+        }
+    }
+
+    void _worker(unsigned tid)
+    {
+        auto seen = std::size_t(0);
+        while (true)
+        {
+            std::unique_lock<std::mutex> lock(this->_mutex);
+            this->_start.wait(lock,
+                [&] { return this->_stop || this->_generation != seen; });
+            if (this->_stop)
+            {
+                return;
+            }
+            seen = this->_generation;
+            lock.unlock();
+            this->_execute(this->_job, tid);
+            lock.lock();
+            if (--this->_pending == 0)
+            {
+                this->_done.notify_all();
+            }
+        }
+    }
+
+  public:
+    explicit ThreadPool(
+        unsigned num_threads = std::thread::hardware_concurrency())
+    {
+        num_threads = std::max(num_threads, 1U);
+        this->_workers.reserve(num_threads - 1);
+        for (auto tid = 1U; tid != num_threads; ++tid)
+        {
+            this->_workers.emplace_back([this, tid] { this->_worker(tid); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_stop = true;
+        }
+        this->_start.notify_all();
+        for (auto& worker : this->_workers)
+        {
+            worker.join();
+        }
+    }
+
+    /*! Return the number of threads, including the calling thread. */
+    [[nodiscard]] auto size() const -> unsigned
+    {
+        return unsigned(this->_workers.size()) + 1;
+    }
+
+    /*! Call `fn(tid)` for every `tid` in `[0, size())` and wait. */
+    template <typename Fn>
+    void run(Fn&& fn)
+    {
+        this->_error = nullptr;
+        if (!this->_workers.empty())
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_job = [&fn](unsigned tid) { fn(tid); };
+            this->_pending = unsigned(this->_workers.size());
+            ++this->_generation;
+        }
+        this->_start.notify_all();
+        this->_execute(fn, 0);
+        {
+            std::unique_lock<std::mutex> lock(this->_mutex);
+            this->_done.wait(lock, [&] { return this->_pending == 0; });
+            this->_job = nullptr;
+        }
+        if (this->_error)
+        {
+            std::rethrow_exception(this->_error);
+        }
+    }
+};
+
+/*! Call `body(tid, i)` for every i in `[first, last)` on the pool.
+
+    The range is split into one block per thread.  A thread takes `grain`
+    iterations at a time from its own block and, when it is empty, from
+    the blocks of the other threads, so uneven iteration costs are
+    balanced without a shared queue.
+*/
+template <typename Body>
+void parallel_for(ThreadPool& pool, std::size_t first, std::size_t last,
+    std::size_t grain, Body&& body)
+{
+    if (!(first < last))
+    {
+        return;
+    }
+    grain = std::max(grain, std::size_t(1));
+    const auto num_threads = pool.size();
+    const auto total = last - first;
+    if (num_threads == 1 || total <= grain)
+    {
+        for (auto i = first; i != last; ++i)
+        {
+            body(0U, i);
+        }
+        return;
+    }
+
+    struct alignas(64) Block
+    {
+        std::atomic<std::size_t> next;
+        std::size_t end;
+    };
+    auto blocks = std::unique_ptr<Block[]>(new Block[num_threads]);
+    for (auto t = 0U; t != num_threads; ++t)
+    {
+        blocks[t].next = first + total * t / num_threads;
+        blocks[t].end = first + total * (t + 1) / num_threads;
+    }
+
+    pool.run([&](unsigned tid) {
+        for (auto k = 0U; k != num_threads; ++k)
+        {
+            auto& block = blocks[(tid + k) % num_threads];
+            while (true)
+            {
+                const auto begin = block.next.fetch_add(grain);
+                if (!(begin < block.end))
+                {
+                    break;
+                }
+                const auto end = std::min(begin + grain, block.end);
+                for (auto i = begin; i != end; ++i)
+                {
+                    body(tid, i);
+                }
+            }
+        }
+    });
+}
+
+} // namespace xn
@@ -0,0 +1,283 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Native union-find over dense ids `0 .. n-1`.
+
+`UnionFind` links the smaller set under the larger one and halves the
+paths it walks (every node on the path is pointed at its grandparent),
+which keeps a sequence of m operations within O(m alpha(n)).  The size of
+every set and the number of sets come for free.
+
+`ConcurrentUnionFind` lets the threads of a pool unite and find without
+locks: a root is linked by a compare-and-swap on its parent, and path
+halving is a compare-and-swap that may fail harmlessly.  Roots are
+linked in the order of a fixed pseudo-random priority of the ids, which
+stands in for the ranks that a lock-free structure cannot keep (Jayanti
+and Tarjan, 2016).
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace xn
+{
+
+/*! Disjoint sets of the ids `0 .. n-1`, by union by size and path
+    halving.
+
+    Parameters
+    ----------
+    n : number of ids, each in a set of its own (default: 0)
+
+    Examples
+    --------
+    >>> auto sets = xn::UnionFind {5};
+    >>> sets.unite(0, 1);  // true: the sets were merged
+    >>> sets.unite(1, 0);  // false: already one set
+    >>> sets.connected(0, 1), sets.set_size(0), sets.number_of_sets();
+    (true, 2, 4)
+*/
+class UnionFind
+{
+  public:
+    using node_t = std::uint32_t;
+
+    std::vector<node_t> _parent;
+    std::vector<node_t> _size; // the size of the set, at its root
+    std::size_t _count = 0;    // number of sets
+
+    explicit UnionFind(std::size_t n = 0)
+        : _parent(n)
+        , _size(n, 1)
+        , _count {n}
+    {
+        for (auto x = std::size_t(0); x != n; ++x)
+        {
+            this->_parent[x] = node_t(x);
+        }
+    }
+
+    /*! Return the number of ids. */
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        return this->_parent.size();
+    }
+
+    [[nodiscard]] auto number_of_sets() const -> std::size_t
+    {
+        return this->_count;
+    }
+
+    /*! Add a new id in a set of its own and return it. */
+    auto add() -> node_t
+    {
+        const auto x = node_t(this->_parent.size());
+        this->_parent.push_back(x);
+        this->_size.push_back(1);
+        ++this->_count;
+        return x;
+    }
+
+    /*! Return the representative of the set of x. */
+    auto find(node_t x) -> node_t
+    {
+        auto& parent = this->_parent;
+        while (parent[x] != x)
+        {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    /*! Merge the sets of x and y; return false if they were one set. */
+    auto unite(node_t x, node_t y) -> bool
+    {
+        x = this->find(x);
+        y = this->find(y);
+        if (x == y)
+        {
+            return false;
+        }
+        if (this->_size[x] < this->_size[y])
+        {
+            std::swap(x, y);
+        }
+        this->_parent[y] = x;
+        this->_size[x] += this->_size[y];
+        --this->_count;
+        return true;
+    }
+
+    auto connected(node_t x, node_t y) -> bool
+    {
+        return this->find(x) == this->find(y);
+    }
+
+    /*! Return the number of ids in the set of x. */
+    auto set_size(node_t x) -> std::size_t
+    {
+        return this->_size[this->find(x)];
+    }
+
+    /*! Return the sets, each in increasing order, ordered by their
+        smallest ids. */
+    auto to_sets() -> std::vector<std::vector<node_t>>
+    {
+        const auto n = this->size();
+        auto index = std::vector<std::size_t>(n, n);
+        auto sets = std::vector<std::vector<node_t>> {};
+        for (auto x = node_t(0); x != n; ++x)
+        {
+            auto& i = index[this->find(x)];
+            if (i == n)
+            {
+                i = sets.size();
+                sets.emplace_back();
+            }
+            sets[i].push_back(x);
+        }
+        return sets;
+    }
+};
+
+/*! Disjoint sets of the ids `0 .. n-1` that the threads of a pool
+    update together without locks.
+
+    Parameters
+    ----------
+    n : number of ids, each in a set of its own
+
+    Notes
+    -----
+    `unite` and `connected` are linearizable: an answer of `connected`
+    holds at some instant during the call.  `number_of_sets` and
+    `find` between parallel phases see a quiescent structure.
+
+    Examples
+    --------
+    >>> auto sets = xn::ConcurrentUnionFind {C.number_of_nodes()};
+    >>> xn::parallel_for(pool, 0, C.number_of_nodes(), 1024,
+    ...     [&](unsigned, std::size_t u) {
+    ...         for (auto v : C.neighbors(u)) sets.unite(u, v);
+    ...     });
+    >>> sets.number_of_sets();
+*/
+class ConcurrentUnionFind
+{
+  public:
+    using node_t = std::uint32_t;
+
+    std::vector<std::atomic<node_t>> _parent;
+
+    explicit ConcurrentUnionFind(std::size_t n)
+        : _parent(n)
+    {
+        for (auto x = std::size_t(0); x != n; ++x)
+        {
+            this->_parent[x].store(node_t(x), std::memory_order_relaxed);
+        }
+    }
+
+    /*! Return the number of ids. */
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        return this->_parent.size();
+    }
+
+    /*! Return the representative of the set of x. */
+    auto find(node_t x) -> node_t
+    {
+        auto p = this->_load(x);
+        while (p != x)
+        {
+            auto gp = this->_load(p);
+            if (gp == p)
+            {
+                return p;
+            }
+            // halve the path; another thread may have moved x already
+            this->_parent[x].compare_exchange_strong(
+                p, gp, std::memory_order_relaxed);
+            x = gp;
+            p = this->_load(x);
+        }
+        return x;
+    }
+
+    /*! Merge the sets of x and y; return false if they were one set.
+        Exactly one of the calls that merge two given sets returns true. */
+    auto unite(node_t x, node_t y) -> bool
+    {
+        while (true)
+        {
+            x = this->find(x);
+            y = this->find(y);
+            if (x == y)
+            {
+                return false;
+            }
+            if (_priority(x) < _priority(y))
+            {
+                std::swap(x, y);
+            }
+            // link the root of lower priority, if it still is a root
+            auto expected = y;
+            if (this->_parent[y].compare_exchange_strong(expected, x,
+                    std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+    }
+
+    auto connected(node_t x, node_t y) -> bool
+    {
+        while (true)
+        {
+            x = this->find(x);
+            y = this->find(y);
+            if (x == y)
+            {
+                return true;
+            }
+            // x was a root when y was found: two sets at that instant
+            if (this->_load(x) == x)
+            {
+                return false;
+            }
+        }
+    }
+
+    /*! Return the number of sets. */
+    [[nodiscard]] auto number_of_sets() const -> std::size_t
+    {
+        auto count = std::size_t(0);
+        for (auto x = std::size_t(0); x != this->_parent.size(); ++x)
+        {
+            count += this->_load(node_t(x)) == x ? 1 : 0;
+        }
+        return count;
+    }
+
+  private:
+    auto _load(node_t x) const -> node_t
+    {
+        return this->_parent[x].load(std::memory_order_acquire);
+    }
+
+    /*! A bijection of the ids that orders them pseudo-randomly. */
+    static auto _priority(node_t x) -> std::uint32_t
+    {
+        auto z = x * 0x9e3779b1U;
+        z ^= z >> 16U;
+        z *= 0x85ebca6bU;
+        return z ^ (z >> 13U);
+    }
+};
+
+} // namespace xn
@@ -0,0 +1,82 @@
+// -*- coding: utf-8 -*-
+#pragma once
+
+/*!
+Pseudo-random test graphs shared by the test files.  All of them draw
+from xn::SplitMix64, so a seed gives the same graph on every platform.
+*/
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/utils/random.hpp>
+
+using RandomEdges = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+/*!
+ * @brief Create m pseudo-random arcs (u, v) of nodes below n; both
+ *        directions of every edge if symmetric
+ */
+inline auto random_arcs(std::uint32_t n, std::uint32_t m, std::uint64_t seed,
+    bool symmetric = false) -> RandomEdges
+{
+    auto rng = xn::SplitMix64 {seed};
+    auto edges = RandomEdges {};
+    edges.reserve(symmetric ? 2 * std::size_t(m) : m);
+    for (auto k = 0U; k != m; ++k)
+    {
+        const auto u = std::uint32_t(rng.below(n));
+        const auto v = std::uint32_t(rng.below(n));
+        edges.emplace_back(u, v);
+        if (symmetric)
+        {
+            edges.emplace_back(v, u);
+        }
+    }
+    return edges;
+}
+
+/*!
+ * @brief Create an unweighted CSR graph of m pseudo-random arcs, see
+ *        `random_arcs`
+ */
+inline auto random_graph(std::uint32_t n, std::uint32_t m, std::uint64_t seed,
+    bool symmetric = false)
+{
+    return xn::csr_graph_from_edges<int>(n, random_arcs(n, m, seed, symmetric));
+}
+
+/*!
+ * @brief Create m pseudo-random arcs with integer weights in [low, high]
+ */
+template <typename Weight>
+auto random_weighted_arcs(std::uint32_t n, std::uint32_t m,
+    std::uint64_t seed, int low, int high)
+    -> std::pair<RandomEdges, std::vector<Weight>>
+{
+    auto rng = xn::SplitMix64 {seed};
+    auto arcs = std::pair<RandomEdges, std::vector<Weight>> {};
+    for (auto k = 0U; k != m; ++k)
+    {
+        const auto u = std::uint32_t(rng.below(n));
+        const auto v = std::uint32_t(rng.below(n));
+        arcs.first.emplace_back(u, v);
+        arcs.second.push_back(
+            Weight(low + int(rng.below(std::uint64_t(high - low + 1)))));
+    }
+    return arcs;
+}
+
+/*!
+ * @brief Create a pseudo-random CSR digraph of m arcs with integer
+ *        weights in [low, high]
+ */
+template <typename Weight>
+auto random_weighted_digraph(std::uint32_t n, std::uint32_t m,
+    std::uint64_t seed, int low, int high)
+{
+    const auto [edges, weights] =
+        random_weighted_arcs<Weight>(n, m, seed, low, high);
+    return xn::csr_graph_from_edges<Weight>(n, edges, weights);
+}
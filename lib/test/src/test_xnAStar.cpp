@@ -0,0 +1,122 @@
+// -*- coding: utf-8 -*-
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/shortest_paths/astar.hpp>
+#include <xnetwork/algorithms/shortest_paths/weighted.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/classes/graph.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+/*!
+ * @brief Create a side x side grid with weighted arcs in both directions
+ *
+ * @param[in] symmetric both arcs of a pair get the same weight
+ */
+inline auto create_weighted_grid(std::uint32_t side, bool symmetric)
+{
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    auto weights = std::vector<int> {};
+    for (auto i = 0U; i != side; ++i)
+    {
+        for (auto j = 0U; j != side; ++j)
+        {
+            const auto u = i * side + j;
+            const auto w = int((i * 7 + j * 13) % 5 + 1);
+            const auto w2 = symmetric ? w : int((i * 3 + j * 5) % 7 + 1);
+            if (j + 1 != side)
+            {
+                edges.emplace_back(u, u + 1);
+                edges.emplace_back(u + 1, u);
+                weights.insert(weights.end(), {w, w2});
+            }
+            if (i + 1 != side)
+            {
+                edges.emplace_back(u, u + side);
+                edges.emplace_back(u + side, u);
+                weights.insert(weights.end(), {w2, w});
+            }
+        }
+    }
+    return xn::csr_graph_from_edges<int>(side * side, edges, weights);
+}
+
+template <typename CSR>
+void check_alt(const CSR& G, const xn::Landmarks<int>& L)
+{
+    auto ws = xn::AStarWorkspace<int> {G.number_of_nodes()};
+    auto ref = xn::DijkstraWorkspace<int> {G.number_of_nodes()};
+    auto ok = true;
+    auto expanded = std::size_t(0);
+    auto expanded_ref = std::size_t(0);
+    for (auto q = 0U; q != 50; ++q)
+    {
+        const auto s = (q * 577U) % G.number_of_nodes();
+        const auto t = (q * 1031U + 99U) % G.number_of_nodes();
+        const auto d = xn::astar_path_length(G, s, t, L.heuristic(t), ws);
+        ok = ok && d == xn::dijkstra_path_length(G, s, t, ref);
+        ok = ok && ws.path_to(t).front() == s;
+        expanded += ws.settled().size();
+        expanded_ref += ref.settled().size();
+    }
+    CHECK(ok);
+    CHECK(2 * expanded < expanded_ref);
+}
+
+TEST_CASE("Test A* (zero heuristic)")
+{
+    const auto G = create_weighted_grid(10, true);
+    auto ws = xn::AStarWorkspace<int> {100};
+    auto ref = xn::DijkstraWorkspace<int> {100};
+    const auto zero = [](std::uint32_t) { return 0; };
+    CHECK(xn::astar_path_length(G, 0U, 99U, zero, ws)
+        == xn::dijkstra_path_length(G, 0U, 99U, ref));
+    CHECK(xn::astar_path(G, 5U, 5U, zero, ws)
+        == std::vector<std::uint32_t> {5});
+}
+
+TEST_CASE("Test ALT on an undirected grid")
+{
+    const auto G = create_weighted_grid(40, true);
+    auto pool = xn::ThreadPool {4};
+    for (auto method : {xn::LandmarkSelection::random,
+             xn::LandmarkSelection::farthest, xn::LandmarkSelection::avoid})
+    {
+        const auto L = xn::Landmarks<int> {G, 8, pool, method};
+        CHECK(L.is_symmetric());
+        CHECK(L.landmarks().size() == 8);
+        check_alt(G, L);
+    }
+}
+
+TEST_CASE("Test ALT on a directed grid")
+{
+    const auto G = create_weighted_grid(40, false);
+    const auto GT = G.transpose();
+    auto pool = xn::ThreadPool {3};
+    for (auto method :
+        {xn::LandmarkSelection::farthest, xn::LandmarkSelection::avoid})
+    {
+        const auto L = xn::Landmarks<int> {G, GT, 8, pool, method, 7};
+        CHECK(!L.is_symmetric());
+        check_alt(G, L);
+    }
+}
+
+TEST_CASE("Test ALT on a disconnected graph")
+{
+    auto G = xn::SimpleGraph {6};
+    G.add_edge(0, 1);
+    G.add_edge(1, 2);
+    G.add_edge(3, 4);
+    const auto& CG = G;
+    const auto C = xn::to_csr_graph(CG);
+    auto pool = xn::ThreadPool {2};
+    const auto L = xn::Landmarks<int> {C, 3, pool};
+    auto ws = xn::AStarWorkspace<int> {6};
+    CHECK(xn::astar_path_length(C, 0U, 2U, L.heuristic(2), ws) == 2);
+    CHECK(L.lower_bound(0, 4) == L.infinity());
+    CHECK_THROWS_AS(xn::astar_path_length(C, 0U, 4U, L.heuristic(4), ws),
+        xn::XNetworkNoPath);
+}
@@ -0,0 +1,286 @@
+// -*- coding: utf-8 -*-
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/shortest_paths/dense.hpp>
+#include <xnetwork/algorithms/shortest_paths/unweighted.hpp>
+#include <xnetwork/algorithms/shortest_paths/weighted.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+#include "random_graphs.hpp"
+
+/*!
+ * @brief Reference distances by a plain Bellman-Ford on the full graph
+ */
+template <typename CSR>
+auto reference_distances(const CSR& G, std::uint32_t s)
+{
+    const auto inf = std::numeric_limits<int>::max();
+    auto dist = std::vector<int>(G.number_of_nodes(), inf);
+    dist[s] = 0;
+    for (auto pass = 0U; pass != G.number_of_nodes(); ++pass)
+    {
+        for (auto u = 0U; u != G.number_of_nodes(); ++u)
+        {
+            if (dist[u] == inf)
+            {
+                continue;
+            }
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                const auto v = G.target(e);
+                dist[v] = std::min(dist[v], dist[u] + G.weight(e));
+            }
+        }
+    }
+    return dist;
+}
+
+TEST_CASE("Test parallel all-pairs Dijkstra")
+{
+    const auto G = random_weighted_digraph<int>(60, 240, 12345, 1, 10);
+    auto pool = xn::ThreadPool {4};
+    auto D = xn::DistanceMatrix<int> {60, 60};
+    xn::all_pairs_dijkstra_path_length(G, pool, D);
+    auto ok = true;
+    for (auto s = 0U; s != 60; ++s)
+    {
+        const auto ref = reference_distances(G, s);
+        for (auto v = 0U; v != 60; ++v)
+        {
+            ok = ok && D(s, v) == ref[v];
+        }
+    }
+    CHECK(ok);
+
+    auto block = xn::DistanceMatrix<int> {10, 60, 20};
+    xn::all_pairs_dijkstra_path_length(G, pool, block);
+    CHECK(block(3, 7) == D(23, 7));
+
+    auto reached = std::atomic<std::size_t> {0};
+    xn::all_pairs_dijkstra_path_length(G, pool,
+        [&](std::uint32_t, const auto& ws) { reached += ws.touched().size(); });
+    auto expected = std::size_t(0);
+    for (auto s = 0U; s != 60; ++s)
+    {
+        for (auto v = 0U; v != 60; ++v)
+        {
+            expected += D(s, v) != D.infinity() ? 1 : 0;
+        }
+    }
+    CHECK(reached == expected);
+}
+
+TEST_CASE("Test parallel all-pairs Bellman-Ford")
+{
+    // weights in [-1, 8] on a DAG: no negative cycle
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    auto weights = std::vector<int> {};
+    for (auto u = 0U; u != 30; ++u)
+    {
+        for (auto v = u + 1; v < 30 && v < u + 4; ++v)
+        {
+            edges.emplace_back(u, v);
+            weights.push_back(int((u * 5 + v) % 10) - 1);
+        }
+    }
+    const auto G = xn::csr_graph_from_edges<int>(30, edges, weights);
+    auto pool = xn::ThreadPool {3};
+    auto D = xn::DistanceMatrix<int> {30, 30};
+    xn::all_pairs_bellman_ford_path_length(G, pool, D);
+    auto ok = true;
+    for (auto s = 0U; s != 30; ++s)
+    {
+        const auto ref = reference_distances(G, s);
+        for (auto v = 0U; v != 30; ++v)
+        {
+            ok = ok && D(s, v) == ref[v];
+        }
+    }
+    CHECK(ok);
+
+    const auto H = random_weighted_digraph<int>(40, 200, 12345, -3, 6);
+    CHECK_THROWS_AS(xn::all_pairs_bellman_ford_path_length(
+                        H, pool, [](std::uint32_t, const auto&) {}),
+        xn::XNetworkUnbounded);
+}
+
+TEST_CASE("Test Johnson's algorithm")
+{
+    // shifting non-negative weights by potentials keeps every cycle
+    // non-negative but makes many arcs negative
+    const auto C = random_weighted_digraph<int>(80, 400, 12345, 0, 9);
+    auto weights = C._weights;
+    for (auto u = 0U; u != 80; ++u)
+    {
+        for (auto e = C.edge_begin(u); e != C.edge_end(u); ++e)
+        {
+            weights[e] += int(u * 37 % 11) - int(C.target(e) * 37 % 11);
+        }
+    }
+    const auto G = xn::CSRGraph<int> {C._offsets, C._targets, weights};
+    auto pool = xn::ThreadPool {4};
+    auto D = xn::DistanceMatrix<int> {80, 80};
+    xn::johnson(G, pool, D);
+    auto ok = true;
+    for (auto s = 0U; s != 80; ++s)
+    {
+        const auto ref = reference_distances(G, s);
+        for (auto v = 0U; v != 80; ++v)
+        {
+            ok = ok && D(s, v) == ref[v];
+        }
+    }
+    CHECK(ok);
+
+    auto paths_ok = std::atomic<bool> {true};
+    xn::johnson(G, pool, [&](std::uint32_t s, const auto& ws) {
+        for (auto v : ws.touched())
+        {
+            const auto path = ws.path_to(v);
+            auto length = 0;
+            for (auto k = 0U; k + 1 < path.size(); ++k)
+            {
+                auto best = std::numeric_limits<int>::max();
+                for (auto e = G.edge_begin(path[k]);
+                     e != G.edge_end(path[k]); ++e)
+                {
+                    if (G.target(e) == path[k + 1])
+                    {
+                        best = std::min(best, G.weight(e));
+                    }
+                }
+                length += best;
+            }
+            if (path.front() != s || length != ws.dist(v)
+                || ws.dist(v) != D(s, v))
+            {
+                paths_ok = false;
+            }
+        }
+    });
+    CHECK(paths_ok);
+
+    const auto H = random_weighted_digraph<int>(40, 200, 12345, -3, 6);
+    CHECK_THROWS_AS(xn::johnson_potential(H), xn::XNetworkUnbounded);
+}
+
+TEST_CASE("Test parallel all-pairs BFS")
+{
+    const auto G = random_weighted_digraph<int>(50, 150, 12345, 1, 10);
+    auto pool = xn::ThreadPool {4};
+    auto D = xn::DistanceMatrix<std::uint32_t> {50, 50};
+    xn::all_pairs_shortest_path_length(G, pool, D);
+    auto ws = xn::BFSWorkspace {50};
+    auto ok = true;
+    for (auto s = 0U; s != 50; ++s)
+    {
+        xn::single_source_shortest_path_length(G, s, ws);
+        for (auto v = 0U; v != 50; ++v)
+        {
+            ok = ok && D(s, v) == ws.dist(v);
+        }
+    }
+    CHECK(ok);
+
+    // rows are filled in batches of 64 sources
+    const auto H = random_weighted_digraph<int>(300, 900, 12345, 1, 10);
+    auto block = xn::DistanceMatrix<std::uint32_t> {150, 300, 100};
+    xn::all_pairs_shortest_path_length(H, pool, block);
+    auto hs = xn::BFSWorkspace {300};
+    for (auto i = 0U; i != 150; ++i)
+    {
+        xn::single_source_shortest_path_length(H, 100 + i, hs);
+        for (auto v = 0U; v != 300; ++v)
+        {
+            ok = ok && block(i, v) == hs.dist(v);
+        }
+    }
+    CHECK(ok);
+
+    xn::single_source_shortest_path_length(G, 0U, ws, 1);
+    auto within = true;
+    for (auto v : ws.touched())
+    {
+        within = within && ws.dist(v) <= 1;
+    }
+    for (auto v : G.neighbors(0))
+    {
+        within = within && ws.reached(v);
+    }
+    CHECK(within);
+}
+
+TEST_CASE("Test blocked Floyd-Warshall")
+{
+    auto pool = xn::ThreadPool {4};
+    const auto G = random_weighted_digraph<int>(40, 200, 12345, -3, 6);
+    auto N = xn::to_distance_matrix<int>(G);
+    CHECK_THROWS_AS(xn::floyd_warshall(N, pool), xn::XNetworkUnbounded);
+
+    const auto H = random_weighted_digraph<int>(70, 400, 12345, 1, 10);
+    auto ref = xn::DistanceMatrix<int> {70, 70};
+    xn::all_pairs_dijkstra_path_length(H, pool, ref);
+    for (const auto block_size : {1, 16, 64, 100})
+    {
+        auto D = xn::to_distance_matrix<int>(H);
+        xn::floyd_warshall(D, pool, block_size);
+        auto ok = true;
+        for (auto i = 0U; i != 70; ++i)
+        {
+            for (auto j = 0U; j != 70; ++j)
+            {
+                ok = ok && D(i, j) == ref(i, j);
+            }
+        }
+        CHECK(ok);
+    }
+}
+
+TEST_CASE("Test Floyd-Warshall predecessors")
+{
+    // weights in [-1, 8] on a DAG: no negative cycle
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    auto weights = std::vector<double> {};
+    for (auto u = 0U; u != 40; ++u)
+    {
+        for (auto v = u + 1; v < 40 && v < u + 5; ++v)
+        {
+            edges.emplace_back(u, v);
+            weights.push_back(double((u * 5 + v) % 10) - 1.5);
+        }
+    }
+    const auto G = xn::csr_graph_from_edges<double>(40, edges, weights);
+    auto D = xn::to_distance_matrix<double>(G);
+    auto P = xn::PredecessorMatrix {40, 40};
+    auto pool = xn::ThreadPool {3};
+    xn::floyd_warshall_predecessor_and_distance(D, P, pool, 8);
+    const auto W = xn::to_distance_matrix<double>(G);
+    auto ok = true;
+    for (auto s = 0U; s != 40; ++s)
+    {
+        for (auto t = 0U; t != 40; ++t)
+        {
+            const auto path = xn::reconstruct_path(s, t, P);
+            if (D(s, t) == D.infinity())
+            {
+                ok = ok && path.empty();
+                continue;
+            }
+            auto length = 0.0;
+            for (auto k = 0U; k + 1 < path.size(); ++k)
+            {
+                length += W(path[k], path[k + 1]);
+            }
+            ok = ok && path.front() == s && path.back() == t
+                && length == doctest::Approx(D(s, t));
+        }
+    }
+    CHECK(ok);
+    CHECK(D(39, 0) == D.infinity());
+}
@@ -0,0 +1,179 @@
+// -*- coding: utf-8 -*-
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/shortest_paths/unweighted.hpp>
+#include <xnetwork/algorithms/traversal/breadth_first_search.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/classes/graph.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+#include "random_graphs.hpp"
+
+/*!
+ * @brief Check levels against a plain BFS and parents against the arcs
+ */
+template <typename CSR>
+auto is_bfs_tree(const CSR& G, std::uint32_t s, const xn::BFSTreeWorkspace& ws)
+    -> bool
+{
+    auto ref = xn::BFSWorkspace {G.number_of_nodes()};
+    xn::single_source_shortest_path_length(G, s, ref);
+    auto ok = ws.parent(s) == ws.none && ws.level(s) == 0;
+    for (auto v = 0U; v != G.number_of_nodes(); ++v)
+    {
+        if (!ref.reached(v))
+        {
+            ok = ok && !ws.reached(v) && ws.parent(v) == ws.none;
+            continue;
+        }
+        ok = ok && ws.level(v) == ref.dist(v);
+        if (v == s)
+        {
+            continue;
+        }
+        const auto p = ws.parent(v);
+        auto is_arc = false;
+        for (auto w : G.neighbors(p))
+        {
+            is_arc = is_arc || w == v;
+        }
+        ok = ok && is_arc && ws.level(p) + 1 == ws.level(v);
+    }
+    return ok;
+}
+
+TEST_CASE("Test direction-optimizing BFS (undirected)")
+{
+    const auto G = random_graph(5000, 40000, 99, true);
+    auto ws = xn::BFSTreeWorkspace {5000, 4};
+    auto pool = xn::ThreadPool {4};
+    for (auto s : {0U, 123U, 4999U})
+    {
+        xn::direction_optimizing_bfs(G, G, s, ws);
+        CHECK(is_bfs_tree(G, s, ws));
+        xn::direction_optimizing_bfs(G, G, s, ws, pool);
+        CHECK(is_bfs_tree(G, s, ws));
+    }
+    ws.alpha = 1000000; // top-down only
+    xn::direction_optimizing_bfs(G, G, 7U, ws, pool);
+    CHECK(is_bfs_tree(G, 7U, ws));
+    ws.alpha = 1; // bottom-up almost throughout
+    ws.beta = 1000000;
+    xn::direction_optimizing_bfs(G, G, 7U, ws, pool);
+    CHECK(is_bfs_tree(G, 7U, ws));
+}
+
+TEST_CASE("Test direction-optimizing BFS (directed)")
+{
+    const auto G = random_graph(3000, 15000, 99, false);
+    const auto GT = G.transpose();
+    auto ws = xn::BFSTreeWorkspace {3000, 3};
+    auto pool = xn::ThreadPool {3};
+    for (auto s : {1U, 2000U})
+    {
+        xn::direction_optimizing_bfs(G, GT, s, ws);
+        CHECK(is_bfs_tree(G, s, ws));
+        xn::direction_optimizing_bfs(G, GT, s, ws, pool);
+        CHECK(is_bfs_tree(G, s, ws));
+    }
+}
+
+TEST_CASE("Test direction-optimizing BFS on SimpleGraph")
+{
+    auto G = xn::SimpleGraph {6};
+    G.add_edge(0, 1);
+    G.add_edge(1, 2);
+    G.add_edge(2, 3);
+    G.add_edge(0, 4);
+    const auto& CG = G;
+    const auto C = xn::to_csr_graph(CG);
+    auto ws = xn::BFSTreeWorkspace {6};
+    xn::direction_optimizing_bfs(C, C, 3U, ws);
+    CHECK(ws.levels() == std::vector<std::uint32_t> {3, 2, 1, 0, 4, ws.none});
+    CHECK(ws.parent(4) == 0);
+    CHECK(ws.parents()[3] == ws.none);
+}
+
+/*!
+ * @brief Check a multi-source BFS of the given width against plain BFS
+ */
+template <std::size_t Width, typename CSR>
+auto check_multi_source_bfs(const CSR& G, std::uint32_t cutoff) -> bool
+{
+    const auto n = G.number_of_nodes();
+    auto sources = std::vector<std::uint32_t> {};
+    for (auto i = 0U; i != Width; ++i)
+    {
+        sources.push_back((i * 7919U) % n);
+    }
+    auto levels = std::vector<std::vector<std::uint32_t>>(
+        Width, std::vector<std::uint32_t>(n, xn::BFSWorkspace::infinity()));
+    auto ok = true;
+    auto ws = xn::MultiSourceBFSWorkspace<Width> {n};
+    xn::multi_source_bfs(G, sources, ws,
+        [&](std::uint32_t v, std::uint32_t level, const auto& mask) {
+            ok = ok && mask.any() && level <= cutoff;
+            mask.for_each([&](std::size_t i) {
+                ok = ok && levels[i][v] == xn::BFSWorkspace::infinity();
+                levels[i][v] = level;
+            });
+        },
+        cutoff);
+    auto ref = xn::BFSWorkspace {n};
+    for (auto i = 0U; i != Width; ++i)
+    {
+        xn::single_source_shortest_path_length(G, sources[i], ref, cutoff);
+        for (auto v = 0U; v != n; ++v)
+        {
+            ok = ok && levels[i][v] == ref.dist(v);
+        }
+    }
+    return ok;
+}
+
+TEST_CASE("Test multi-source BFS")
+{
+    const auto G = random_graph(2000, 6000, 99, false);
+    CHECK(check_multi_source_bfs<64>(G, xn::BFSWorkspace::infinity()));
+    CHECK(check_multi_source_bfs<256>(G, xn::BFSWorkspace::infinity()));
+    CHECK(check_multi_source_bfs<512>(G, 3));
+
+    // duplicate sources share every level
+    const auto U = random_graph(100, 150, 99, true);
+    auto ws = xn::MultiSourceBFSWorkspace<64> {100};
+    const auto sources = std::vector<std::uint32_t> {5, 9, 5};
+    auto same = true;
+    auto reached = std::size_t(0);
+    xn::multi_source_bfs(U, sources, ws,
+        [&](std::uint32_t, std::uint32_t, const xn::SourceMask<64>& mask) {
+            same = same && mask.test(0) == mask.test(2);
+            reached += mask.count();
+        });
+    CHECK(same);
+    auto ref = xn::BFSWorkspace {100};
+    xn::single_source_shortest_path_length(U, 5U, ref);
+    auto expected = 2 * ref.touched().size();
+    xn::single_source_shortest_path_length(U, 9U, ref);
+    expected += ref.touched().size();
+    CHECK(reached == expected);
+
+    // a visitor that throws halfway through a level leaves masks behind
+    CHECK_THROWS_AS(xn::multi_source_bfs(U, sources, ws,
+                        [](std::uint32_t, std::uint32_t level, const auto&) {
+                            if (level == 1)
+                            {
+                                throw std::runtime_error("stop");
+                            }
+                        }),
+        std::runtime_error);
+    reached = 0;
+    xn::multi_source_bfs(U, std::vector<std::uint32_t> {42}, ws,
+        [&](std::uint32_t, std::uint32_t, const xn::SourceMask<64>& mask) {
+            reached += mask.count();
+        });
+    xn::single_source_shortest_path_length(U, 42U, ref);
+    CHECK(reached == ref.touched().size());
+}
@@ -0,0 +1,377 @@
+// -*- coding: utf-8 -*-
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/centrality/betweenness.hpp>
+#include <xnetwork/algorithms/centrality/dynamic_betweenness.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+#include "random_graphs.hpp"
+
+/*!
+ * @brief Create a pseudo-random graph without parallel arcs
+ *
+ * For an undirected graph every edge is stored in both directions.
+ */
+inline auto create_betweenness_graph(std::uint32_t n, std::uint32_t m,
+    std::uint32_t seed, bool directed, bool weighted)
+{
+    const auto [arcs, lengths] = random_weighted_arcs<int>(n, m, seed, 1, 4);
+    auto seen = std::set<std::pair<std::uint32_t, std::uint32_t>> {};
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    auto weights = std::vector<int> {};
+    for (auto k = 0U; k != m; ++k)
+    {
+        const auto [u, v] = arcs[k];
+        const auto w = weighted ? lengths[k] : 1;
+        if (u == v || !seen.emplace(u, v).second)
+        {
+            continue;
+        }
+        edges.emplace_back(u, v);
+        weights.push_back(w);
+        if (!directed && seen.emplace(v, u).second)
+        {
+            edges.emplace_back(v, u);
+            weights.push_back(w);
+        }
+    }
+    if (!weighted)
+    {
+        weights.clear();
+    }
+    return xn::csr_graph_from_edges<int>(n, edges, weights);
+}
+
+/*!
+ * @brief Unscaled node and arc betweenness from all-pairs path counts
+ */
+template <typename CSR>
+auto brute_force_betweenness(const CSR& G, bool endpoints)
+    -> std::pair<std::vector<double>, std::vector<double>>
+{
+    const auto n = G.number_of_nodes();
+    const auto inf = std::numeric_limits<int>::max() / 4;
+    auto d = std::vector<std::vector<int>>(n, std::vector<int>(n, inf));
+    auto sigma = std::vector<std::vector<double>>(n, std::vector<double>(n));
+    for (auto v = 0U; v != n; ++v)
+    {
+        d[v][v] = 0;
+    }
+    for (auto u = 0U; u != n; ++u)
+    {
+        for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+        {
+            d[u][G.target(e)] = std::min(d[u][G.target(e)], G.weight(e));
+        }
+    }
+    for (auto k = 0U; k != n; ++k)
+    {
+        for (auto i = 0U; i != n; ++i)
+        {
+            for (auto j = 0U; j != n; ++j)
+            {
+                d[i][j] = std::min(d[i][j], d[i][k] + d[k][j]);
+            }
+        }
+    }
+    // count paths by increasing distance from every source
+    for (auto s = 0U; s != n; ++s)
+    {
+        auto order = std::vector<std::uint32_t> {};
+        for (auto v = 0U; v != n; ++v)
+        {
+            order.push_back(v);
+        }
+        std::sort(order.begin(), order.end(),
+            [&](auto a, auto b) { return d[s][a] < d[s][b]; });
+        sigma[s][s] = 1.0;
+        for (auto u : order)
+        {
+            if (d[s][u] == inf)
+            {
+                break;
+            }
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                const auto v = G.target(e);
+                if (v != s && d[s][u] + G.weight(e) == d[s][v])
+                {
+                    sigma[s][v] += sigma[s][u];
+                }
+            }
+        }
+    }
+    auto nodes = std::vector<double>(n);
+    auto arcs = std::vector<double>(G.number_of_edges());
+    for (auto s = 0U; s != n; ++s)
+    {
+        for (auto t = 0U; t != n; ++t)
+        {
+            if (s == t || d[s][t] == inf)
+            {
+                continue;
+            }
+            if (endpoints)
+            {
+                nodes[s] += 1.0;
+                nodes[t] += 1.0;
+            }
+            for (auto v = 0U; v != n; ++v)
+            {
+                if (v != s && v != t && d[s][v] + d[v][t] == d[s][t])
+                {
+                    nodes[v] += sigma[s][v] * sigma[v][t] / sigma[s][t];
+                }
+            }
+            for (auto u = 0U; u != n; ++u)
+            {
+                for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+                {
+                    const auto v = G.target(e);
+                    if (d[s][u] + G.weight(e) + d[v][t] == d[s][t])
+                    {
+                        arcs[e] += sigma[s][u] * sigma[v][t] / sigma[s][t];
+                    }
+                }
+            }
+        }
+    }
+    return {nodes, arcs};
+}
+
+TEST_CASE("Test betweenness centrality against path counting")
+{
+    auto pool = xn::ThreadPool {3};
+    auto ok = true;
+    for (auto trial = 0U; trial != 24; ++trial)
+    {
+        const auto directed = trial % 2 == 0;
+        const auto weighted = trial % 4 >= 2;
+        const auto n = 10 + trial;
+        const auto G =
+            create_betweenness_graph(n, 3 * n, trial, directed, weighted);
+        const auto half = directed ? 1.0 : 0.5;
+        for (auto endpoints : {false, true})
+        {
+            const auto ref = brute_force_betweenness(G, endpoints).first;
+            const auto bc =
+                xn::betweenness_centrality(G, pool, directed, false, endpoints);
+            const auto nbc = xn::betweenness_centrality(G, pool, directed);
+            const auto raw = brute_force_betweenness(G, false).first;
+            for (auto v = 0U; v != n; ++v)
+            {
+                ok = ok && bc[v] == doctest::Approx(half * ref[v]);
+                ok = ok
+                    && nbc[v]
+                        == doctest::Approx(raw[v] / ((n - 1.0) * (n - 2.0)));
+            }
+        }
+        const auto arcs = brute_force_betweenness(G, false).second;
+        const auto eb = xn::edge_betweenness_centrality(G, pool, directed);
+        const auto ueb =
+            xn::edge_betweenness_centrality(G, pool, directed, false);
+        for (auto u = 0U; u != n; ++u)
+        {
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                auto expected = arcs[e];
+                for (auto r = G.edge_begin(G.target(e));
+                     !directed && r != G.edge_end(G.target(e)); ++r)
+                {
+                    if (G.target(r) == u)
+                    {
+                        expected += arcs[r];
+                    }
+                }
+                ok = ok && ueb[e] == doctest::Approx(half * expected);
+                ok = ok
+                    && eb[e] == doctest::Approx(expected / (n * (n - 1.0)));
+            }
+        }
+    }
+    CHECK(ok);
+}
+
+TEST_CASE("Test betweenness centrality of a path")
+{
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    for (auto v = 0U; v != 4; ++v)
+    {
+        edges.emplace_back(v, v + 1);
+        edges.emplace_back(v + 1, v);
+    }
+    const auto G = xn::csr_graph_from_edges<int>(5, edges);
+    auto pool = xn::ThreadPool {2};
+    const auto bc = xn::betweenness_centrality(G, pool, false, false);
+    CHECK(bc == std::vector<double> {0.0, 3.0, 4.0, 3.0, 0.0});
+    const auto nbc = xn::betweenness_centrality(G, pool, false);
+    CHECK(nbc[2] == doctest::Approx(8.0 / 12.0));
+    const auto ebc = xn::betweenness_centrality(G, pool, false, false, true);
+    CHECK(ebc == std::vector<double> {4.0, 7.0, 8.0, 7.0, 4.0});
+    // the middle edges carry 2 * 3 = 6 pairs
+    const auto eb = xn::edge_betweenness_centrality(G, pool, false, false);
+    CHECK(eb[G.edge_begin(1)] == doctest::Approx(4.0));
+    CHECK(eb[G.edge_begin(2)] == doctest::Approx(6.0));
+}
+
+TEST_CASE("Test approximate betweenness centrality")
+{
+    auto pool = xn::ThreadPool {3};
+    auto ok = true;
+    for (auto directed : {false, true})
+    {
+        const auto n = 300U;
+        const auto G = create_betweenness_graph(n, 900, 11, directed, false);
+        const auto exact = xn::betweenness_centrality(G, pool, directed);
+        const auto r = xn::approximate_betweenness_centrality(
+            G, pool, directed, 0.02, 0.1);
+        CHECK(r._samples <= r._max_samples);
+        CHECK(r._error <= 0.02);
+        for (auto v = 0U; v != n; ++v)
+        {
+            const auto b = exact[v] * (n - 2.0) / n;
+            ok = ok && std::abs(r._betweenness[v] - b) <= r._error;
+        }
+        // the samples do not depend on the threads
+        auto single = xn::ThreadPool {1};
+        const auto r1 = xn::approximate_betweenness_centrality(
+            G, single, directed, 0.02, 0.1);
+        CHECK(r1._betweenness == r._betweenness);
+    }
+    CHECK(ok);
+
+    const auto W = create_betweenness_graph(20, 60, 5, true, true);
+    CHECK_THROWS_AS(xn::approximate_betweenness_centrality(W, pool, true),
+        xn::XNetworkNotImplemented);
+    const auto U = create_betweenness_graph(20, 60, 5, true, false);
+    CHECK_THROWS_AS(xn::approximate_betweenness_centrality(U, pool, true, 0.0),
+        xn::XNetworkError);
+}
+
+TEST_CASE("Test approximate betweenness top-k ranking")
+{
+    // ten 8-cliques hanging off hub 0 by their first node
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    auto connect = [&](std::uint32_t u, std::uint32_t v) {
+        edges.emplace_back(u, v);
+        edges.emplace_back(v, u);
+    };
+    for (auto c = 0U; c != 10; ++c)
+    {
+        const auto first = 1 + 8 * c;
+        connect(0, first);
+        for (auto i = first; i != first + 8; ++i)
+        {
+            for (auto j = i + 1; j != first + 8; ++j)
+            {
+                connect(i, j);
+            }
+        }
+    }
+    const auto G = xn::csr_graph_from_edges<int>(81, edges);
+    auto pool = xn::ThreadPool {2};
+    const auto r =
+        xn::approximate_betweenness_centrality(G, pool, false, 0.001, 0.1, 11);
+    CHECK(r._samples < r._max_samples);
+    REQUIRE(r._ranking.size() == 11);
+    CHECK(r._ranking[0] == 0);
+    auto top = r._ranking;
+    std::sort(top.begin(), top.end());
+    const auto expected =
+        std::vector<std::uint32_t> {0, 1, 9, 17, 25, 33, 41, 49, 57, 65, 73};
+    CHECK(top == expected);
+}
+
+TEST_CASE("Test betweenness centrality under edge insertions")
+{
+    using Edge = std::pair<std::uint32_t, std::uint32_t>;
+    auto pool = xn::ThreadPool {3};
+    auto rng = xn::SplitMix64 {2024};
+    auto ok = true;
+    auto recomputed = std::size_t(0);
+    for (auto trial = 0U; trial != 4; ++trial)
+    {
+        const auto directed = trial % 2 == 1;
+        const auto weighted = trial >= 2;
+        const auto n = 120U;
+        const auto G = create_betweenness_graph(n, 150, trial, directed,
+            weighted);
+        auto arcs = std::map<Edge, int> {};
+        for (auto u = 0U; u != n; ++u)
+        {
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                arcs[{u, G.target(e)}] = G.weight(e);
+            }
+        }
+        auto db = xn::DynamicBetweenness<int> {G, pool, directed};
+        auto insert = [&](std::uint32_t u, std::uint32_t v, int w) {
+            for (auto [a, b] : {Edge {u, v}, Edge {v, u}})
+            {
+                if (a != b && (a == u || !directed))
+                {
+                    auto [it, fresh] = arcs.emplace(Edge {a, b}, w);
+                    it->second = fresh ? w : std::min(it->second, w);
+                }
+            }
+        };
+        for (auto step = 0U; step != 24; ++step)
+        {
+            const auto u = std::uint32_t(rng.below(n));
+            const auto v = std::uint32_t(rng.below(n));
+            const auto w = weighted ? int(rng.below(4) + 1) : 1;
+            if (step % 8 == 7)
+            {
+                // a batch, with an arc given twice
+                const auto x = std::uint32_t(rng.below(n));
+                recomputed += db.insert_edges(
+                    {{u, v}, {v, x}, {u, v}}, {w, 2, 1});
+                insert(u, v, w);
+                insert(v, x, weighted ? 2 : 1);
+                insert(u, v, 1);
+            }
+            else
+            {
+                recomputed += db.update(u, v, w);
+                insert(u, v, w);
+            }
+            auto edges = std::vector<Edge> {};
+            auto weights = std::vector<int> {};
+            for (const auto& [arc, w] : arcs)
+            {
+                edges.push_back(arc);
+                weights.push_back(w);
+            }
+            if (!weighted)
+            {
+                weights.clear();
+            }
+            const auto H = xn::csr_graph_from_edges<int>(n, edges, weights);
+            CHECK(H.number_of_edges() == db.graph().number_of_edges());
+            const auto ref = xn::betweenness_centrality(H, pool, directed);
+            const auto bc = db.betweenness();
+            for (auto v = 0U; v != n; ++v)
+            {
+                ok = ok && bc[v] == doctest::Approx(ref[v]);
+            }
+        }
+    }
+    CHECK(ok);
+    // far fewer sources than a full recompute per insertion
+    CHECK(recomputed < 4 * 24 * 120 / 2);
+    auto db = xn::DynamicBetweenness<int> {
+        create_betweenness_graph(10, 20, 1, false, false), pool, false};
+    CHECK_THROWS_AS(db.update(3, 10), xn::NodeNotFound);
+    CHECK_THROWS_AS(
+        db.insert_edges({{1, 2}, {2, 3}}, {1}), xn::XNetworkError);
+    CHECK(db.update(4, 4) == 0);
+}
@@ -0,0 +1,139 @@
+// -*- coding: utf-8 -*-
+#include <algorithm>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <functional>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/centrality/closeness.hpp>
+#include <xnetwork/algorithms/centrality/harmonic.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+#include "random_graphs.hpp"
+
+/*!
+ * @brief Closeness and harmonic centrality by one BFS per node
+ */
+template <typename CSR>
+auto brute_force_closeness(const CSR& G, bool directed, bool wf_improved)
+    -> std::pair<std::vector<double>, std::vector<double>>
+{
+    const auto n = G.number_of_nodes();
+    auto closeness = std::vector<double>(n);
+    auto harmonic = std::vector<double>(n);
+    for (auto u = 0U; u != n; ++u)
+    {
+        // distances to u: search the reversed arcs
+        auto dist = std::vector<int>(n, -1);
+        auto queue = std::vector<std::uint32_t> {u};
+        dist[u] = 0;
+        for (auto head = 0U; head != queue.size(); ++head)
+        {
+            const auto x = queue[head];
+            for (auto y = 0U; y != n; ++y)
+            {
+                if (dist[y] >= 0)
+                {
+                    continue;
+                }
+                auto arc = false;
+                for (auto w : G.neighbors(directed ? y : x))
+                {
+                    arc = arc || w == (directed ? x : y);
+                }
+                if (arc)
+                {
+                    dist[y] = dist[x] + 1;
+                    queue.push_back(y);
+                }
+            }
+        }
+        auto total = 0.0;
+        for (auto v : queue)
+        {
+            total += dist[v];
+            harmonic[u] += v == u ? 0.0 : 1.0 / dist[v];
+        }
+        if (total > 0.0)
+        {
+            const auto r = double(queue.size());
+            closeness[u] = (r - 1.0) / total;
+            if (wf_improved)
+            {
+                closeness[u] *= (r - 1.0) / (n - 1.0);
+            }
+        }
+    }
+    return {closeness, harmonic};
+}
+
+/*!
+ * @brief Check a top-k list against all the values
+ */
+inline auto is_top_k(const std::vector<std::pair<std::uint32_t, double>>& top,
+    const std::vector<double>& values, std::size_t k) -> bool
+{
+    auto sorted = values;
+    std::sort(sorted.begin(), sorted.end(), std::greater<double>());
+    auto ok = top.size() == k;
+    for (auto i = 0U; ok && i != k; ++i)
+    {
+        ok = top[i].second == doctest::Approx(sorted[i])
+            && top[i].second == doctest::Approx(values[top[i].first]);
+    }
+    return ok;
+}
+
+TEST_CASE("Test closeness and harmonic centrality")
+{
+    auto pool = xn::ThreadPool {3};
+    auto ok = true;
+    for (auto trial = 0U; trial != 8; ++trial)
+    {
+        const auto directed = trial % 2 == 1;
+        const auto n = 70 + 20 * trial; // more than one batch
+        const auto G = random_graph(n, n + 10 * trial, trial, !directed);
+        for (auto wf : {true, false})
+        {
+            const auto ref = brute_force_closeness(G, directed, wf);
+            const auto cc = xn::closeness_centrality(G, pool, directed, wf);
+            for (auto v = 0U; v != n; ++v)
+            {
+                ok = ok && cc[v] == doctest::Approx(ref.first[v]);
+            }
+            ok = ok
+                && is_top_k(
+                    xn::top_k_closeness_centrality(G, pool, directed, 10, wf),
+                    ref.first, 10);
+        }
+        const auto ref = brute_force_closeness(G, directed, true).second;
+        const auto hc = xn::harmonic_centrality(G, pool, directed);
+        for (auto v = 0U; v != n; ++v)
+        {
+            ok = ok && hc[v] == doctest::Approx(ref[v]);
+        }
+        ok = ok
+            && is_top_k(
+                xn::top_k_harmonic_centrality(G, pool, directed, 10), ref, 10);
+    }
+    CHECK(ok);
+}
+
+TEST_CASE("Test top-k closeness centrality of a connected graph")
+{
+    auto pool = xn::ThreadPool {2};
+    const auto G = random_graph(2000, 5000, 99, true);
+    const auto cc = xn::closeness_centrality(G, pool, false);
+    CHECK(is_top_k(xn::top_k_closeness_centrality(G, pool, false, 25), cc, 25));
+    const auto hc = xn::harmonic_centrality(G, pool, false);
+    CHECK(is_top_k(xn::top_k_harmonic_centrality(G, pool, false, 25), hc, 25));
+    CHECK(xn::top_k_closeness_centrality(G, pool, false, 0).empty());
+
+    const auto W = xn::csr_graph_from_edges<int>(2,
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> {{0, 1}},
+        std::vector<int> {3});
+    CHECK_THROWS_AS(
+        xn::closeness_centrality(W, pool, true), xn::XNetworkNotImplemented);
+}
@@ -0,0 +1,502 @@
+// -*- coding: utf-8 -*-
+#include <algorithm>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/bridges.hpp>
+#include <xnetwork/algorithms/components/biconnected.hpp>
+#include <xnetwork/algorithms/components/connected.hpp>
+#include <xnetwork/algorithms/components/strongly_connected.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/classes/graph.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+#include <xnetwork/utils/union_find.hpp>
+
+#include "random_graphs.hpp"
+
+/*!
+ * @brief Create a pseudo-random undirected graph (both directions of
+ *        every edge): a giant component, many small ones, isolated nodes
+ */
+inline auto create_component_graph(std::uint32_t n, std::uint32_t m)
+{
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    for (auto [u, v] : random_arcs(n, m, 4242))
+    {
+        if (u % 4 == 1)
+        {
+            v = u + 1 < n ? u + 1 : u; // chains of small components
+        }
+        else if (u % 4 == 2 || v % 4 == 1 || v % 4 == 2)
+        {
+            continue;
+        }
+        edges.emplace_back(u, v);
+        edges.emplace_back(v, u);
+    }
+    return xn::csr_graph_from_edges<int>(n, edges);
+}
+
+/*!
+ * @brief Label the components by sequential BFS, in node order
+ */
+template <typename CSR>
+auto brute_force_components(const CSR& G)
+{
+    const auto n = G.number_of_nodes();
+    const auto none = ~std::uint32_t(0);
+    auto labels = std::vector<std::uint32_t>(n, none);
+    auto count = 0U;
+    for (auto s = 0U; s != n; ++s)
+    {
+        if (labels[s] != none)
+        {
+            continue;
+        }
+        auto queue = std::vector<std::uint32_t> {s};
+        labels[s] = count;
+        for (auto i = std::size_t(0); i != queue.size(); ++i)
+        {
+            for (auto v : G.neighbors(queue[i]))
+            {
+                if (labels[v] == none)
+                {
+                    labels[v] = count;
+                    queue.push_back(v);
+                }
+            }
+        }
+        ++count;
+    }
+    return labels;
+}
+
+TEST_CASE("Test connected components")
+{
+    auto pool = xn::ThreadPool {4};
+    const auto n = 200000U;
+    const auto G = create_component_graph(n, 300000);
+    const auto ref = brute_force_components(G);
+    const auto cc = xn::connected_components(G, pool);
+    CHECK(cc._labels == ref);
+    auto sizes = std::vector<std::size_t>(cc.number_of_components(), 0);
+    for (auto c : ref)
+    {
+        ++sizes[c];
+    }
+    CHECK(cc._sizes == sizes);
+    CHECK(cc.number_of_components() > 1000);
+    CHECK(xn::number_connected_components(G, pool)
+        == cc.number_of_components());
+
+    // without sampling rounds, and on one thread
+    auto single = xn::ThreadPool {1};
+    CHECK(xn::connected_components(G, pool, 0)._labels == ref);
+    CHECK(xn::connected_components(G, single)._labels == ref);
+
+    const auto nodes = xn::node_connected_component(G, pool, 3U);
+    auto ok = nodes.size() == sizes[ref[3]];
+    for (auto v : nodes)
+    {
+        ok = ok && ref[v] == ref[3];
+    }
+    CHECK(ok);
+    CHECK(!xn::is_connected(G, pool));
+    CHECK_THROWS_AS(
+        xn::node_connected_component(G, pool, n), xn::NodeNotFound);
+}
+
+TEST_CASE("Test connected components on SimpleGraph")
+{
+    auto pool = xn::ThreadPool {2};
+    auto G = xn::SimpleGraph {7};
+    G.add_edge(0, 1);
+    G.add_edge(1, 2);
+    G.add_edge(3, 6);
+    G.add_edge(4, 5);
+    const auto& CG = G;
+    const auto C = xn::to_csr_graph(CG);
+    const auto cc = xn::connected_components(C, pool);
+    CHECK(cc._labels == std::vector<std::uint32_t> {0, 0, 0, 1, 2, 2, 1});
+    CHECK(cc._sizes == std::vector<std::size_t> {3, 2, 2});
+    CHECK(xn::node_connected_component(C, pool, 6U)
+        == std::vector<std::uint32_t> {3, 6});
+    G.add_edge(2, 3);
+    G.add_edge(5, 6);
+    CHECK(xn::is_connected(xn::to_csr_graph(CG), pool));
+
+    const auto E = xn::csr_graph_from_edges<int>(
+        0, std::vector<std::pair<std::uint32_t, std::uint32_t>> {});
+    CHECK(xn::connected_components(E, pool).number_of_components() == 0);
+    CHECK_THROWS_AS(xn::is_connected(E, pool), xn::XNetworkPointlessConcept);
+}
+
+/*!
+ * @brief Create a pseudo-random digraph: a giant strongly connected core,
+ *        chains of small cycles and one-way arcs between them
+ */
+inline auto create_scc_graph(std::uint32_t n, std::uint32_t m)
+{
+    auto rng = xn::SplitMix64 {1234};
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    for (auto k = 0U; k != m; ++k)
+    {
+        const auto u = std::uint32_t(rng.below(n));
+        const auto v = std::uint32_t(rng.below(n));
+        if (u % 3 == 0 && v % 3 == 0)
+        {
+            edges.emplace_back(u, v); // the core
+        }
+        else if (u % 3 == 1)
+        {
+            // short steps forwards, long ones backwards
+            edges.emplace_back(u, (u + 3 * std::uint32_t(rng.below(4))) % n);
+            edges.emplace_back(u, v < u ? v : u);
+        }
+    }
+    return xn::csr_graph_from_edges<int>(n, edges);
+}
+
+/*!
+ * @brief Label the strongly connected components by Kosaraju's algorithm
+ *        with explicit stacks, in node order
+ */
+template <typename CSR>
+auto brute_force_scc(const CSR& G)
+{
+    const auto n = G.number_of_nodes();
+    const auto GT = G.transpose();
+    const auto none = ~std::uint32_t(0);
+    auto order = std::vector<std::uint32_t> {};
+    auto seen = std::vector<bool>(n, false);
+    for (auto s = 0U; s != n; ++s)
+    {
+        if (seen[s])
+        {
+            continue;
+        }
+        seen[s] = true;
+        auto stack = std::vector<std::pair<std::uint32_t, std::size_t>> {
+            {s, G.edge_begin(s)}};
+        while (!stack.empty())
+        {
+            auto& [u, e] = stack.back();
+            if (e == G.edge_end(u))
+            {
+                order.push_back(u);
+                stack.pop_back();
+                continue;
+            }
+            const auto w = G.target(e++);
+            if (!seen[w])
+            {
+                seen[w] = true;
+                stack.emplace_back(w, G.edge_begin(w));
+            }
+        }
+    }
+    auto rep = std::vector<std::uint32_t>(n, none);
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        if (rep[*it] != none)
+        {
+            continue;
+        }
+        auto stack = std::vector<std::uint32_t> {*it};
+        rep[*it] = *it;
+        while (!stack.empty())
+        {
+            const auto u = stack.back();
+            stack.pop_back();
+            for (auto w : GT.neighbors(u))
+            {
+                if (rep[w] == none)
+                {
+                    rep[w] = *it;
+                    stack.push_back(w);
+                }
+            }
+        }
+    }
+    auto id = std::vector<std::uint32_t>(n, none);
+    auto labels = std::vector<std::uint32_t>(n);
+    auto count = 0U;
+    for (auto v = 0U; v != n; ++v)
+    {
+        if (id[rep[v]] == none)
+        {
+            id[rep[v]] = count++;
+        }
+        labels[v] = id[rep[v]];
+    }
+    return labels;
+}
+
+TEST_CASE("Test strongly connected components")
+{
+    const auto n = 100000U;
+    const auto G = create_scc_graph(n, 1000000);
+    const auto ref = brute_force_scc(G);
+    const auto scc = xn::strongly_connected_components(G);
+    CHECK(scc._labels == ref);
+    const auto k = scc.number_of_components();
+    CHECK(k > 100);
+    CHECK(*std::max_element(scc._sizes.begin(), scc._sizes.end()) > n / 10);
+    for (auto threads : {1U, 4U})
+    {
+        auto pool = xn::ThreadPool {threads};
+        CHECK(xn::parallel_strongly_connected_components(G, pool)._labels
+            == ref);
+    }
+
+    // the condensation is a DAG over the components
+    const auto D = xn::condensation(G, scc);
+    CHECK(D.number_of_nodes() == k);
+    CHECK(xn::number_strongly_connected_components(D) == k);
+    auto ok = true;
+    for (auto u = 0U; u != n; ++u)
+    {
+        for (auto v : G.neighbors(u))
+        {
+            const auto row = D.neighbors(scc._labels[u]);
+            ok = ok
+                && (scc._labels[u] == scc._labels[v]
+                    || std::binary_search(
+                        row.begin(), row.end(), scc._labels[v]));
+        }
+    }
+    for (auto c = 0U; c != k; ++c)
+    {
+        const auto row = D.neighbors(c);
+        ok = ok && std::adjacent_find(row.begin(), row.end()) == row.end();
+    }
+    CHECK(ok);
+    CHECK(D.number_of_edges() <= G.number_of_edges());
+
+    // a cycle through a million nodes does not overflow the stack
+    const auto m = 1000000U;
+    auto cycle = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    for (auto v = 0U; v != m; ++v)
+    {
+        cycle.emplace_back(v, (v + 1) % m);
+    }
+    const auto C = xn::csr_graph_from_edges<int>(m, cycle);
+    CHECK(xn::is_strongly_connected(C));
+    cycle.pop_back();
+    const auto P = xn::csr_graph_from_edges<int>(m, cycle);
+    CHECK(xn::number_strongly_connected_components(P) == m);
+    auto pool = xn::ThreadPool {4};
+    CHECK(xn::parallel_strongly_connected_components(P, pool)
+              .number_of_components()
+        == m);
+    CHECK(xn::condensation(P).number_of_edges() == m - 1);
+
+    const auto E = xn::csr_graph_from_edges<int>(
+        0, std::vector<std::pair<std::uint32_t, std::uint32_t>> {});
+    CHECK(xn::parallel_strongly_connected_components(E, pool)
+              .number_of_components()
+        == 0);
+    CHECK_THROWS_AS(
+        xn::is_strongly_connected(E), xn::XNetworkPointlessConcept);
+}
+
+/*!
+ * @brief Create a pseudo-random undirected graph (both directions of
+ *        every edge) of sparse cycles, trees, parallel edges and loops
+ */
+inline auto create_block_graph(std::uint32_t n, std::uint32_t m,
+    std::uint32_t seed)
+{
+    auto rng = xn::SplitMix64 {seed};
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    for (auto v = 1U; v != n; ++v)
+    {
+        if (v % 5 != 0)
+        {
+            // a node near by
+            const auto u = v - 1 - std::uint32_t(rng.below(std::min(v, 3U)));
+            edges.emplace_back(u, v);
+            edges.emplace_back(v, u);
+        }
+    }
+    for (auto k = 0U; k != m; ++k)
+    {
+        const auto u = std::uint32_t(rng.below(n));
+        const auto v = rng.below(7) == 0 ? u : std::uint32_t(rng.below(n));
+        edges.emplace_back(u, v);
+        edges.emplace_back(v, u);
+    }
+    return xn::csr_graph_from_edges<int>(n, edges);
+}
+
+/*!
+ * @brief Whether a reaches b without going through x, nor along the
+ *        edges between y and z
+ */
+template <typename CSR>
+auto reaches_around(const CSR& G, std::uint32_t a, std::uint32_t b,
+    std::uint32_t x, std::uint32_t y = ~0U, std::uint32_t z = ~0U) -> bool
+{
+    auto seen = std::vector<bool>(G.number_of_nodes(), false);
+    auto stack = std::vector<std::uint32_t> {a};
+    seen[a] = true;
+    while (!stack.empty())
+    {
+        const auto u = stack.back();
+        stack.pop_back();
+        for (auto w : G.neighbors(u))
+        {
+            const auto cut = (u == y && w == z) || (u == z && w == y);
+            if (w != x && !seen[w] && !cut)
+            {
+                seen[w] = true;
+                stack.push_back(w);
+            }
+        }
+    }
+    return seen[b];
+}
+
+/*!
+ * @brief Check biconnected components against their definitions
+ */
+template <typename CSR>
+auto check_biconnected(const CSR& G, const xn::BiconnectedResult& bcc)
+    -> bool
+{
+    const auto n = G.number_of_nodes();
+    // two edges at v are in one block iff their other ends are joined
+    // without v; blocks are the closure of that
+    auto blocks = xn::UnionFind {G.number_of_edges()};
+    for (auto v = 0U; v != n; ++v)
+    {
+        for (auto e = G.edge_begin(v); e != G.edge_end(v); ++e)
+        {
+            const auto a = G.target(e);
+            for (auto f = G.edge_begin(a); f != G.edge_end(a); ++f)
+            {
+                if (G.target(f) == v && a != v)
+                {
+                    blocks.unite(std::uint32_t(e), std::uint32_t(f));
+                }
+            }
+            for (auto f = e + 1; f != G.edge_end(v); ++f)
+            {
+                const auto b = G.target(f);
+                if (a != v && b != v
+                    && (a == b || reaches_around(G, a, b, v)))
+                {
+                    blocks.unite(std::uint32_t(e), std::uint32_t(f));
+                }
+            }
+        }
+    }
+    const auto none = xn::BiconnectedResult::none;
+    auto id = std::vector<std::uint32_t>(G.number_of_edges(), none);
+    auto count = 0U;
+    auto ok = true;
+    for (auto v = 0U; v != n; ++v)
+    {
+        for (auto e = G.edge_begin(v); e != G.edge_end(v); ++e)
+        {
+            if (G.target(e) == v)
+            {
+                ok = ok && bcc._arc_components[e] == none;
+                continue;
+            }
+            auto& c = id[blocks.find(std::uint32_t(e))];
+            if (c == none)
+            {
+                c = count++;
+            }
+            ok = ok && bcc._arc_components[e] == c;
+        }
+    }
+    ok = ok && bcc.number_of_components() == count;
+
+    // articulation points and bridges disconnect their neighbors
+    auto cuts = std::vector<std::uint32_t> {};
+    auto bridges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    for (auto v = 0U; v != n; ++v)
+    {
+        auto first = v;
+        auto cut = false;
+        for (auto a : G.neighbors(v))
+        {
+            if (a == v)
+            {
+                continue;
+            }
+            first = first == v ? a : first;
+            cut = cut || !reaches_around(G, a, first, v);
+            auto parallel = 0U;
+            for (auto w : G.neighbors(v))
+            {
+                parallel += w == a ? 1 : 0;
+            }
+            if (v < a && parallel == 1 && !reaches_around(G, v, a, n, v, a))
+            {
+                bridges.emplace_back(v, a);
+            }
+        }
+        if (cut)
+        {
+            cuts.push_back(v);
+        }
+    }
+    std::sort(bridges.begin(), bridges.end());
+    bridges.erase(std::unique(bridges.begin(), bridges.end()), bridges.end());
+    return ok && bcc._articulation_points == cuts && bcc._bridges == bridges;
+}
+
+TEST_CASE("Test biconnected components")
+{
+    for (auto seed : {1U, 2U, 3U, 4U, 5U})
+    {
+        const auto G = create_block_graph(40, 12, seed);
+        const auto bcc = xn::biconnected_components(G);
+        CHECK(check_biconnected(G, bcc));
+        auto pool = xn::ThreadPool {3};
+        const auto tv = xn::parallel_biconnected_components(G, pool);
+        CHECK(tv._arc_components == bcc._arc_components);
+        CHECK(tv._articulation_points == bcc._articulation_points);
+        CHECK(tv._bridges == bcc._bridges);
+        CHECK(xn::bridges(G) == bcc._bridges);
+    }
+
+    const auto n = 200000U;
+    const auto G = create_block_graph(n, n / 4, 77);
+    const auto bcc = xn::biconnected_components(G);
+    CHECK(bcc.number_of_components() > 1000);
+    CHECK(bcc._articulation_points.size() > 1000);
+    CHECK(bcc._bridges.size() > 1000);
+    for (auto threads : {1U, 4U})
+    {
+        auto pool = xn::ThreadPool {threads};
+        const auto tv = xn::parallel_biconnected_components(G, pool);
+        CHECK(tv._arc_components == bcc._arc_components);
+        CHECK(tv._sizes == bcc._sizes);
+        CHECK(tv._articulation_points == bcc._articulation_points);
+        CHECK(tv._bridges == bcc._bridges);
+    }
+
+    // a path through a million nodes does not overflow the stack
+    const auto m = 1000000U;
+    auto path = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    for (auto v = 1U; v != m; ++v)
+    {
+        path.emplace_back(v - 1, v);
+        path.emplace_back(v, v - 1);
+    }
+    const auto P = xn::csr_graph_from_edges<int>(m, path);
+    CHECK(xn::bridges(P).size() == m - 1);
+    CHECK(xn::articulation_points(P).size() == m - 2);
+    CHECK(!xn::is_biconnected(P));
+    path.emplace_back(m - 1, 0);
+    path.emplace_back(0, m - 1);
+    const auto C = xn::csr_graph_from_edges<int>(m, path);
+    CHECK(xn::is_biconnected(C));
+    CHECK(!xn::has_bridges(C));
+}
@@ -0,0 +1,256 @@
+// -*- coding: utf-8 -*-
+#include <algorithm>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/shortest_paths/contraction_hierarchy.hpp>
+#include <xnetwork/algorithms/shortest_paths/weighted.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+#include "random_graphs.hpp"
+
+/*!
+ * @brief Create a side x side road-like grid with a few long diagonals
+ */
+inline auto create_road_grid(std::uint32_t side)
+{
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    auto weights = std::vector<int> {};
+    for (auto i = 0U; i != side; ++i)
+    {
+        for (auto j = 0U; j != side; ++j)
+        {
+            const auto u = i * side + j;
+            if (j + 1 != side)
+            {
+                edges.emplace_back(u, u + 1);
+                edges.emplace_back(u + 1, u);
+                weights.insert(weights.end(),
+                    {int((i * 7 + j * 13) % 9 + 1), int((i + j) % 4 + 1)});
+            }
+            if (i + 1 != side)
+            {
+                edges.emplace_back(u, u + side);
+                edges.emplace_back(u + side, u);
+                weights.insert(weights.end(),
+                    {int((i * 3 + j * 5) % 7 + 1), int((i * j) % 5 + 1)});
+            }
+            if ((i * side + j) % 17 == 0 && i + 3 < side && j + 3 < side)
+            {
+                edges.emplace_back(u, u + 3 * side + 3);
+                weights.push_back(10);
+            }
+        }
+    }
+    return xn::csr_graph_from_edges<int>(side * side, edges, weights);
+}
+
+template <typename CSR>
+void check_queries(const CSR& G, const xn::ContractionHierarchy<int>& CH)
+{
+    const auto n = G.number_of_nodes();
+    auto ws = xn::BidirectionalDijkstraWorkspace<int> {n};
+    auto ref = xn::DijkstraWorkspace<int> {n};
+    auto ok = true;
+    for (auto q = 0U; q != 200; ++q)
+    {
+        const auto s = (q * 577U) % n;
+        const auto t = (q * 1031U + 99U) % n;
+        xn::single_source_dijkstra(G, s, ref);
+        if (!ref.reached(t))
+        {
+            CHECK_THROWS_AS(CH.path_length(s, t, ws), xn::XNetworkNoPath);
+            continue;
+        }
+        ok = ok && CH.path_length(s, t, ws) == ref.dist(t);
+        // the unpacked path must be a path of G with the same length
+        const auto path = CH.path(s, t, ws);
+        ok = ok && path.front() == s && path.back() == t;
+        auto length = 0;
+        for (auto k = 0U; k + 1 < path.size(); ++k)
+        {
+            auto best = ref.infinity();
+            for (auto e = G.edge_begin(path[k]); e != G.edge_end(path[k]);
+                 ++e)
+            {
+                if (G.target(e) == path[k + 1])
+                {
+                    best = std::min(best, G.weight(e));
+                }
+            }
+            ok = ok && best != ref.infinity();
+            length += best;
+        }
+        ok = ok && length == ref.dist(t);
+    }
+    CHECK(ok);
+}
+
+TEST_CASE("Test contraction hierarchy on a grid")
+{
+    const auto G = create_road_grid(30);
+    const auto CH = xn::ContractionHierarchy<int> {G};
+    CHECK(CH.number_of_nodes() == 900);
+    auto ok = true;
+    for (auto u = 0U; u != 900; ++u)
+    {
+        const auto& U = CH.upward_graph();
+        for (auto e = U.edge_begin(u); e != U.edge_end(u); ++e)
+        {
+            ok = ok && CH.rank(u) < CH.rank(U.target(e));
+        }
+    }
+    CHECK(ok);
+    check_queries(G, CH);
+
+    auto ws = xn::BidirectionalDijkstraWorkspace<int> {900};
+    CHECK(CH.path_length(7U, 7U, ws) == 0);
+    CHECK(CH.path(7U, 7U, ws) == std::vector<std::uint32_t> {7});
+}
+
+TEST_CASE("Test contraction hierarchy on a sparse digraph")
+{
+    const auto G = random_weighted_digraph<int>(300, 600, 31337, 0, 19);
+    check_queries(G, xn::ContractionHierarchy<int> {G});
+    // a tiny witness limit only adds shortcuts
+    check_queries(G, xn::ContractionHierarchy<int> {G, 2});
+}
+
+TEST_CASE("Test contraction hierarchy table queries")
+{
+    const auto G = random_weighted_digraph<int>(200, 500, 31337, 0, 19);
+    const auto CH = xn::ContractionHierarchy<int> {G};
+    auto pool = xn::ThreadPool {3};
+    auto sources = std::vector<std::uint32_t> {};
+    auto targets = std::vector<std::uint32_t> {};
+    for (auto v = 0U; v < 200; v += 7)
+    {
+        sources.push_back(v);
+        targets.push_back((v * 13 + 5) % 200);
+    }
+    const auto D = CH.table(sources, targets, pool);
+    auto ref = xn::DijkstraWorkspace<int> {200};
+    auto ok = true;
+    for (auto i = 0U; i != sources.size(); ++i)
+    {
+        xn::single_source_dijkstra(G, sources[i], ref);
+        for (auto j = 0U; j != targets.size(); ++j)
+        {
+            ok = ok && D(i, j) == ref.dist(targets[j]);
+        }
+    }
+    CHECK(ok);
+
+    // one-to-many
+    const auto one = std::vector<std::uint32_t> {sources[3]};
+    const auto R = CH.table(one, targets, pool);
+    xn::single_source_dijkstra(G, sources[3], ref);
+    for (auto j = 0U; j != targets.size(); ++j)
+    {
+        ok = ok && R(0, j) == ref.dist(targets[j]);
+    }
+    CHECK(ok);
+}
+
+TEST_CASE("Test contraction hierarchy save and load")
+{
+    const auto G = create_road_grid(12);
+    const auto CH = xn::ContractionHierarchy<int> {G};
+    auto file = std::stringstream {};
+    CH.save(file);
+    const auto CH2 = xn::ContractionHierarchy<int>::load(file);
+    CHECK(CH2.number_of_nodes() == CH.number_of_nodes());
+    CHECK(CH2.number_of_shortcuts() == CH.number_of_shortcuts());
+    check_queries(G, CH2);
+
+    auto bad = std::stringstream {"not a hierarchy"};
+    CHECK_THROWS_AS(
+        xn::ContractionHierarchy<int>::load(bad), xn::XNetworkError);
+    auto truncated = std::stringstream {file.str().substr(0, 40)};
+    CHECK_THROWS_AS(
+        xn::ContractionHierarchy<int>::load(truncated), xn::XNetworkError);
+    auto other = std::stringstream {file.str()};
+    CHECK_THROWS_AS(
+        xn::ContractionHierarchy<double>::load(other), xn::XNetworkError);
+}
+
+TEST_CASE("Test contraction hierarchy load of a corrupt file")
+{
+    using edge_id_t = xn::CSRGraph<int>::edge_id_t;
+    const auto CH = xn::ContractionHierarchy<int> {create_road_grid(6)};
+    auto file = std::stringstream {};
+    CH.save(file);
+    const auto data = file.str();
+    const auto n = CH.number_of_nodes();
+    const auto up_offsets = 12 + 8 + 4 * n + 8; // header, then _rank
+    const auto up_targets = up_offsets + (n + 1) * sizeof(edge_id_t) + 8;
+    auto corrupt = [&data](std::size_t pos, auto value) {
+        auto bytes = data;
+        bytes.replace(pos, sizeof(value),
+            reinterpret_cast<const char*>(&value), sizeof(value));
+        auto is = std::stringstream {bytes};
+        return is;
+    };
+    // a size beyond the end of the file
+    auto huge = corrupt(12, ~std::uint64_t(0) / 8);
+    CHECK_THROWS_AS(
+        xn::ContractionHierarchy<int>::load(huge), xn::XNetworkError);
+    // offsets that decrease
+    auto offsets = corrupt(up_offsets + sizeof(edge_id_t), edge_id_t(1000));
+    CHECK_THROWS_AS(
+        xn::ContractionHierarchy<int>::load(offsets), xn::XNetworkError);
+    // a target out of range
+    auto target = corrupt(up_targets, std::uint32_t(n));
+    CHECK_THROWS_AS(
+        xn::ContractionHierarchy<int>::load(target), xn::XNetworkError);
+    // a rank given twice
+    auto rank = corrupt(12 + 8, std::uint32_t(CH.rank(1)));
+    CHECK_THROWS_AS(
+        xn::ContractionHierarchy<int>::load(rank), xn::XNetworkError);
+    auto intact = corrupt(12 + 8, std::uint32_t(CH.rank(0)));
+    CHECK(xn::ContractionHierarchy<int>::load(intact).number_of_nodes() == n);
+}
+
+TEST_CASE("Test contraction hierarchy load of a file that is no hierarchy")
+{
+    // one edge, so that _up and _down have one arc each
+    const auto edges =
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> {{0, 1}, {1, 0}};
+    const auto G = xn::csr_graph_from_edges<int>(2, edges, {3, 3});
+    const auto CH = xn::ContractionHierarchy<int> {G};
+    auto file = std::stringstream {};
+    CH.save(file);
+    const auto data = file.str();
+    const auto up_targets = 12 + 8 + 2 * 4 + 8 + 3 * 8 + 8;
+    const auto up_weights = up_targets + 4 + 8;
+    auto patch = [](std::string& bytes, std::size_t pos, auto value) {
+        bytes.replace(pos, sizeof(value),
+            reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    auto load = [](const std::string& bytes) {
+        auto is = std::stringstream {bytes};
+        return xn::ContractionHierarchy<int>::load(is);
+    };
+    auto ws = xn::BidirectionalDijkstraWorkspace<int> {2};
+    CHECK(load(data).path(0, 1, ws) == std::vector<std::uint32_t> {0, 1});
+    // the original arcs made shortcuts through one of their ends, which
+    // would unpack forever
+    auto cyclic = data;
+    patch(cyclic, data.size() - 16, std::uint32_t(1));
+    patch(cyclic, data.size() - 4, std::uint32_t(1));
+    CHECK_THROWS_AS(load(cyclic), xn::XNetworkError);
+    // the ranks swapped, so that the up arc leads down
+    auto ranks = data;
+    patch(ranks, 12 + 8, std::uint32_t(CH.rank(1)));
+    patch(ranks, 12 + 8 + 4, std::uint32_t(CH.rank(0)));
+    CHECK_THROWS_AS(load(ranks), xn::XNetworkError);
+    // a negative weight
+    auto weight = data;
+    patch(weight, up_weights, -3);
+    CHECK_THROWS_AS(load(weight), xn::XNetworkError);
+}
@@ -0,0 +1,235 @@
+// -*- coding: utf-8 -*-
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/centrality/current_flow_betweenness.hpp>
+#include <xnetwork/algorithms/centrality/current_flow_closeness.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/linalg/laplacian_solver.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+#include "random_graphs.hpp"
+
+/*!
+ * @brief Create a connected ring with pseudo-random weighted chords
+ */
+inline auto create_resistor_network(std::uint32_t n, std::uint32_t chords)
+{
+    auto rng = xn::SplitMix64 {777};
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    auto weights = std::vector<double> {};
+    auto add = [&](std::uint32_t u, std::uint32_t v, double w) {
+        edges.emplace_back(u, v);
+        edges.emplace_back(v, u);
+        weights.push_back(w);
+        weights.push_back(w);
+    };
+    for (auto v = 0U; v != n; ++v)
+    {
+        add(v, (v + 1) % n, 1.0 + double(rng.below(3)));
+    }
+    const auto [ends, lengths] =
+        random_weighted_arcs<double>(n, chords, 778, 0, 3);
+    for (auto k = 0U; k != chords; ++k)
+    {
+        add(ends[k].first, ends[k].second, 0.5 + lengths[k]);
+    }
+    return xn::csr_graph_from_edges<double>(n, edges, weights);
+}
+
+/*!
+ * @brief Current-flow betweenness (nodes, edges) and resistance sums
+ *        from a dense grounded inverse, pair by pair
+ */
+template <typename CSR>
+auto brute_force_current_flow(const CSR& G)
+{
+    const auto n = G.number_of_nodes();
+    // dense Laplacian grounded at node 0, inverted by Gauss-Jordan
+    auto A = std::vector<std::vector<double>>(n, std::vector<double>(n));
+    for (auto u = 0U; u != n; ++u)
+    {
+        for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+        {
+            const auto v = G.target(e);
+            if (u != v)
+            {
+                A[u][v] -= G.weight(e);
+                A[u][u] += G.weight(e);
+            }
+        }
+    }
+    auto X = std::vector<std::vector<double>>(n, std::vector<double>(n));
+    for (auto i = 1U; i != n; ++i)
+    {
+        X[i][i] = 1.0;
+    }
+    for (auto c = 1U; c != n; ++c)
+    {
+        const auto pivot = A[c][c];
+        for (auto j = 1U; j != n; ++j)
+        {
+            A[c][j] /= pivot;
+            X[c][j] /= pivot;
+        }
+        for (auto r = 1U; r != n; ++r)
+        {
+            const auto f = A[r][c];
+            if (r == c || f == 0.0)
+            {
+                continue;
+            }
+            for (auto j = 1U; j != n; ++j)
+            {
+                A[r][j] -= f * A[c][j];
+                X[r][j] -= f * X[c][j];
+            }
+        }
+    }
+    auto nodes = std::vector<double>(n);
+    auto arcs = std::vector<double>(G.number_of_edges());
+    auto resistance = std::vector<double>(n);
+    for (auto s = 0U; s != n; ++s)
+    {
+        for (auto t = 0U; t != n; ++t)
+        {
+            resistance[s] += X[s][s] + X[t][t] - 2.0 * X[s][t];
+            if (t <= s)
+            {
+                continue;
+            }
+            for (auto u = 0U; u != n; ++u)
+            {
+                for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+                {
+                    const auto v = G.target(e);
+                    const auto pu = X[u][s] - X[u][t];
+                    const auto pv = X[v][s] - X[v][t];
+                    const auto current = G.weight(e) * std::abs(pu - pv);
+                    arcs[e] += current;
+                    nodes[u] += u != s && u != t ? 0.5 * current : 0.0;
+                }
+            }
+        }
+    }
+    return std::make_tuple(nodes, arcs, resistance);
+}
+
+TEST_CASE("Test grounded Laplacian solver")
+{
+    const auto G = create_resistor_network(300, 400);
+    for (auto pc : {xn::LaplacianPreconditioner::jacobi,
+             xn::LaplacianPreconditioner::incomplete_cholesky})
+    {
+        const auto L = xn::GroundedLaplacian {G, pc};
+        auto ws = xn::CGWorkspace {300};
+        auto b = std::vector<double>(300);
+        b[7] = 1.0;
+        b[250] = -1.0;
+        auto x = std::vector<double>();
+        L.solve(b, x, ws, 1.0e-10);
+        CHECK(x[L._ground] == 0.0);
+        // L x = b off the ground, with the full (ungrounded) Laplacian
+        auto error = 0.0;
+        for (auto u = 0U; u != 300; ++u)
+        {
+            auto lx = 0.0;
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                lx += G.weight(e) * (x[u] - x[G.target(e)]);
+            }
+            error = std::max(error, std::abs(lx - b[u]));
+        }
+        CHECK(error < 1.0e-8);
+    }
+    // incomplete Cholesky needs fewer iterations than Jacobi
+    const auto J =
+        xn::GroundedLaplacian {G, xn::LaplacianPreconditioner::jacobi};
+    const auto C = xn::GroundedLaplacian {G};
+    auto ws = xn::CGWorkspace {};
+    auto b = std::vector<double>(300, 1.0);
+    auto x = std::vector<double>();
+    CHECK(C.solve(b, x, ws) < J.solve(b, x, ws));
+    CHECK_THROWS_AS(J.solve(b, x, ws, 1.0e-12, 2), xn::ExceededMaxIterations);
+
+    using EdgeList = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+    const auto D = xn::csr_graph_from_edges<int>(
+        4, EdgeList {{0, 1}, {1, 0}, {2, 3}, {3, 2}});
+    CHECK_THROWS_AS(xn::GroundedLaplacian {D}, xn::XNetworkError);
+}
+
+TEST_CASE("Test current-flow betweenness centrality")
+{
+    auto pool = xn::ThreadPool {3};
+    using EdgeList = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+    const auto P = xn::csr_graph_from_edges<int>(
+        3, EdgeList {{0, 1}, {1, 0}, {1, 2}, {2, 1}});
+    const auto p = xn::current_flow_betweenness_centrality(P, pool);
+    CHECK(p[0] == doctest::Approx(0.0));
+    CHECK(p[1] == doctest::Approx(1.0));
+
+    const auto n = 60U;
+    const auto G = create_resistor_network(n, 50);
+    const auto [nodes, arcs, resistance] = brute_force_current_flow(G);
+    const auto nb = (n - 1.0) * (n - 2.0);
+    for (auto pc : {xn::LaplacianPreconditioner::jacobi,
+             xn::LaplacianPreconditioner::incomplete_cholesky})
+    {
+        const auto cfb =
+            xn::current_flow_betweenness_centrality(G, pool, true, pc);
+        const auto raw =
+            xn::current_flow_betweenness_centrality(G, pool, false, pc);
+        const auto ecf =
+            xn::edge_current_flow_betweenness_centrality(G, pool, true, pc);
+        const auto cfc = xn::current_flow_closeness_centrality(G, pool, pc);
+        auto ok = true;
+        for (auto v = 0U; v != n; ++v)
+        {
+            ok = ok && cfb[v] == doctest::Approx(nodes[v] * 2.0 / nb)
+                && raw[v] == doctest::Approx(nodes[v])
+                && cfc[v] == doctest::Approx(1.0 / resistance[v]);
+        }
+        for (auto e = 0U; e != G.number_of_edges(); ++e)
+        {
+            ok = ok && ecf[e] == doctest::Approx(arcs[e] / nb);
+        }
+        CHECK(ok);
+    }
+}
+
+TEST_CASE("Test approximate current-flow centrality")
+{
+    auto pool = xn::ThreadPool {2};
+    const auto n = 400U;
+    const auto G = create_resistor_network(n, 600);
+    const auto exact = xn::current_flow_betweenness_centrality(G, pool);
+    const auto approx = xn::approximate_current_flow_betweenness_centrality(
+        G, pool, true, 0.1, 1000);
+    auto error = 0.0;
+    for (auto v = 0U; v != n; ++v)
+    {
+        error = std::max(error, std::abs(approx[v] - exact[v]));
+    }
+    CHECK(error < 0.1);
+    CHECK_THROWS_AS(xn::approximate_current_flow_betweenness_centrality(
+                        G, pool, true, 0.01, 1000),
+        xn::XNetworkError);
+
+    const auto cfc = xn::current_flow_closeness_centrality(G, pool);
+    const auto jl =
+        xn::approximate_current_flow_closeness_centrality(G, pool, 0.3);
+    auto relative = 0.0;
+    for (auto v = 0U; v != n; ++v)
+    {
+        relative = std::max(relative, std::abs(jl[v] / cfc[v] - 1.0));
+    }
+    CHECK(relative < 0.3);
+    CHECK_THROWS_AS(
+        xn::approximate_current_flow_closeness_centrality(G, pool, 1.5),
+        xn::XNetworkError);
+}
@@ -0,0 +1,97 @@
+// -*- coding: utf-8 -*-
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/shortest_paths/delta_stepping.hpp>
+#include <xnetwork/algorithms/shortest_paths/weighted.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/classes/graph.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+#include "random_graphs.hpp"
+
+template <typename CSR, typename Dist>
+auto same_as_dijkstra(const CSR& G, std::uint32_t s,
+    const xn::DeltaSteppingWorkspace<Dist>& ws) -> bool
+{
+    auto ref = xn::DijkstraWorkspace<Dist> {G.number_of_nodes()};
+    xn::single_source_dijkstra(G, s, ref);
+    auto ok = ws.number_of_touched() == ref.touched().size();
+    for (auto v = 0U; v != G.number_of_nodes(); ++v)
+    {
+        ok = ok && ws.dist(v) == ref.dist(v);
+    }
+    return ok;
+}
+
+TEST_CASE("Test delta-stepping")
+{
+    const auto G = random_weighted_digraph<int>(2000, 10000, 2024, 1, 1000);
+    auto pool = xn::ThreadPool {4};
+    auto ws = xn::DeltaSteppingWorkspace<int> {2000, pool.size()};
+    for (const auto delta : {1, 7, xn::default_delta(G), 5000})
+    {
+        for (auto s : {0U, 17U, 1999U})
+        {
+            xn::delta_stepping(G, s, delta, pool, ws);
+            CHECK(same_as_dijkstra(G, s, ws));
+        }
+    }
+    // the workspace splits the rows again for another graph
+    const auto H = random_weighted_digraph<int>(2000, 4000, 2024, 1, 10);
+    xn::delta_stepping(H, 5U, 3, pool, ws);
+    CHECK(same_as_dijkstra(H, 5U, ws));
+}
+
+TEST_CASE("Test delta-stepping with a prepared workspace")
+{
+    auto pool = xn::ThreadPool {4};
+    auto ws = xn::DeltaSteppingWorkspace<int> {1000, pool.size()};
+    auto G = std::optional<xn::CSRGraph<int>> {};
+    G.emplace(random_weighted_digraph<int>(1000, 5000, 1, 1, 100));
+    ws.prepare(*G, 20, pool);
+    for (auto s : {0U, 500U})
+    {
+        xn::delta_stepping(*G, s, pool, ws);
+        CHECK(same_as_dijkstra(*G, s, ws));
+    }
+    // another graph at the same address with as many arcs
+    G.emplace(random_weighted_digraph<int>(1000, 5000, 2, 1, 100));
+    xn::delta_stepping(*G, 0U, 20, pool, ws);
+    CHECK(same_as_dijkstra(*G, 0U, ws));
+    ws.prepare(*G, 50, pool);
+    xn::delta_stepping(*G, 500U, pool, ws);
+    CHECK(same_as_dijkstra(*G, 500U, ws));
+
+    const auto H = random_weighted_digraph<int>(1000, 3000, 3, 1, 100);
+    CHECK_THROWS_AS(xn::delta_stepping(H, 0U, pool, ws), xn::XNetworkError);
+    CHECK_THROWS_AS(
+        xn::delta_stepping(H, 0U, 0, pool, ws), xn::XNetworkError);
+}
+
+TEST_CASE("Test delta-stepping (double weights, one thread)")
+{
+    const auto G = random_weighted_digraph<double>(500, 3000, 2024, 1, 50);
+    auto pool = xn::ThreadPool {1};
+    auto ws = xn::DeltaSteppingWorkspace<double> {500, 1};
+    xn::delta_stepping(G, 3U, 2.5, pool, ws);
+    CHECK(same_as_dijkstra(G, 3U, ws));
+}
+
+TEST_CASE("Test delta-stepping on SimpleGraph (unit weights)")
+{
+    auto G = xn::SimpleGraph {6};
+    G.add_edge(0, 1);
+    G.add_edge(1, 2);
+    G.add_edge(2, 3);
+    G.add_edge(0, 4);
+    const auto& CG = G;
+    const auto C = xn::to_csr_graph(CG);
+    auto pool = xn::ThreadPool {2};
+    auto ws = xn::DeltaSteppingWorkspace<int> {6, pool.size()};
+    xn::delta_stepping(C, 3U, 1, pool, ws);
+    CHECK(ws.dist(4) == 4);
+    CHECK(!ws.reached(5));
+}
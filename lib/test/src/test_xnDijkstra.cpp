@@ -0,0 +1,161 @@
+// -*- coding: utf-8 -*-
+#include <array>
+#include <doctest/doctest.h>
+#include <vector>
+#include <xnetwork/algorithms/shortest_paths/weighted.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/classes/digraphs.hpp>
+#include <xnetwork/classes/graph.hpp>
+
+/*!
+ * @brief Create the weighted digraph used by XNetwork's Dijkstra tests
+ *
+ *  s=0, u=1, v=2, x=3, y=4
+ */
+inline auto create_test_case_xy()
+{
+    auto G = xn::SimpleDiGraphS {5};
+    G.add_edge(0, 1, 10);
+    G.add_edge(0, 3, 5);
+    G.add_edge(1, 2, 1);
+    G.add_edge(1, 3, 2);
+    G.add_edge(2, 4, 1);
+    G.add_edge(3, 1, 3);
+    G.add_edge(3, 2, 5);
+    G.add_edge(3, 4, 2);
+    G.add_edge(4, 0, 7);
+    G.add_edge(4, 2, 6);
+    const auto& CG = G;
+    const auto get_weight = [&](const auto& edge) -> int {
+        const auto [u, v] = CG.end_points(edge);
+        return CG[u][v];
+    };
+    return xn::to_csr_graph<int>(CG, get_weight);
+}
+
+template <typename Workspace>
+void check_xy(Workspace& ws)
+{
+    const auto G = create_test_case_xy();
+    xn::single_source_dijkstra(G, 0U, ws);
+    const auto expected = std::array<int, 5> {0, 8, 9, 5, 7};
+    for (auto v = 0U; v != 5; ++v)
+    {
+        CHECK(ws.dist(v) == expected[v]);
+    }
+    CHECK(ws.settled().size() == 5);
+    CHECK(xn::dijkstra_path(G, 0U, 2U, ws)
+        == std::vector<std::uint32_t> {0, 3, 1, 2});
+    CHECK(xn::dijkstra_path_length(G, 4U, 1U, ws) == 15);
+}
+
+TEST_CASE("Test Dijkstra (4-ary heap)")
+{
+    auto ws = xn::DijkstraWorkspace<int> {5};
+    check_xy(ws);
+}
+
+TEST_CASE("Test Dijkstra (radix heap)")
+{
+    auto ws = xn::DijkstraWorkspace<int, xn::RadixHeap<int>> {5};
+    check_xy(ws);
+}
+
+TEST_CASE("Test Dijkstra cutoff, target and workspace reuse")
+{
+    const auto G = create_test_case_xy();
+    auto ws = xn::DijkstraWorkspace<int> {5};
+
+    xn::single_source_dijkstra(G, 0U, ws, 6);
+    CHECK(ws.reached(3));
+    CHECK(!ws.reached(1));
+    CHECK(ws.touched().size() == 2); // only 0 and 3 are within the cutoff
+
+    CHECK(xn::single_source_dijkstra(G, 0U, ws, ws.infinity(), 3U));
+    CHECK(ws.settled().back() == 3);
+    CHECK(ws.settled().size() == 2);
+
+    const auto sources = std::array<std::uint32_t, 2> {1, 4};
+    xn::multi_source_dijkstra(G, sources, ws);
+    CHECK(ws.dist(0) == 7);
+    CHECK(ws.dist(2) == 1);
+    CHECK(ws.pred(1) == ws.none);
+}
+
+TEST_CASE("Test Dijkstra on SimpleGraph (unit weights)")
+{
+    auto G = xn::SimpleGraph {6};
+    G.add_edge(0, 1);
+    G.add_edge(1, 2);
+    G.add_edge(2, 3);
+    G.add_edge(0, 4);
+    const auto& CG = G;
+    const auto C = xn::to_csr_graph(CG);
+    auto ws = xn::DijkstraWorkspace<int> {C.number_of_nodes()};
+    CHECK(xn::dijkstra_path_length(C, 3U, 4U, ws) == 4);
+    CHECK_THROWS_AS(
+        xn::dijkstra_path_length(C, 0U, 5U, ws), xn::XNetworkNoPath);
+}
+
+TEST_CASE("Test bidirectional Dijkstra")
+{
+    const auto G = create_test_case_xy();
+    const auto GT = G.transpose();
+    auto ws = xn::BidirectionalDijkstraWorkspace<int> {5};
+    CHECK(xn::bidirectional_dijkstra(G, GT, 0U, 2U, ws) == 9);
+    CHECK(ws.path() == std::vector<std::uint32_t> {0, 3, 1, 2});
+    CHECK(xn::bidirectional_dijkstra(G, GT, 4U, 1U, ws) == 15);
+    CHECK(ws.path() == std::vector<std::uint32_t> {4, 0, 3, 1});
+    CHECK(xn::bidirectional_dijkstra(G, GT, 3U, 3U, ws) == 0);
+    CHECK(ws.path() == std::vector<std::uint32_t> {3});
+}
+
+TEST_CASE("Test bidirectional Dijkstra on a grid")
+{
+    constexpr auto side = 40U;
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    auto weights = std::vector<int> {};
+    for (auto i = 0U; i != side; ++i)
+    {
+        for (auto j = 0U; j != side; ++j)
+        {
+            const auto u = i * side + j;
+            const auto w = int((i * 7 + j * 13) % 5 + 1);
+            if (j + 1 != side)
+            {
+                edges.emplace_back(u, u + 1);
+                edges.emplace_back(u + 1, u);
+                weights.insert(weights.end(), {w, w});
+            }
+            if (i + 1 != side)
+            {
+                edges.emplace_back(u, u + side);
+                edges.emplace_back(u + side, u);
+                weights.insert(weights.end(), {w + 1, w + 1});
+            }
+        }
+    }
+    const auto G = xn::csr_graph_from_edges<int>(side * side, edges, weights);
+    auto ws = xn::DijkstraWorkspace<int> {G.number_of_nodes()};
+    auto bws = xn::BidirectionalDijkstraWorkspace<int> {G.number_of_nodes()};
+    const auto s = 5 * side + 5;
+    const auto t = 30 * side + 28;
+    const auto d = xn::bidirectional_dijkstra(G, G, s, t, bws);
+    CHECK(d == xn::dijkstra_path_length(G, s, t, ws));
+    CHECK(bws.number_of_touched() < ws.touched().size());
+    CHECK(bws.path().front() == s);
+    CHECK(bws.path().back() == t);
+    auto length = 0;
+    for (auto k = 0U; k + 1 != bws.path().size(); ++k)
+    {
+        const auto u = bws.path()[k];
+        for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+        {
+            if (G.target(e) == bws.path()[k + 1])
+            {
+                length += G.weight(e);
+            }
+        }
+    }
+    CHECK(length == d);
+}
@@ -0,0 +1,137 @@
+// -*- coding: utf-8 -*-
+#include <cmath>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/centrality/eigenvector.hpp>
+#include <xnetwork/algorithms/centrality/katz.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/linalg/spmv.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+#include "random_graphs.hpp"
+
+using EdgeList = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+/*!
+ * @brief Create an undirected ring with pseudo-random chords
+ */
+inline auto create_chordal_ring(std::uint32_t n, std::uint32_t chords)
+{
+    auto edges = random_arcs(n, chords, 4242, true);
+    for (auto v = 0U; v != n; ++v)
+    {
+        edges.emplace_back(v, (v + 1) % n);
+        edges.emplace_back((v + 1) % n, v);
+    }
+    return edges;
+}
+
+TEST_CASE("Test balanced row partition")
+{
+    // one row holds most of the nonzeros
+    const auto offsets = std::vector<std::size_t> {0, 1, 2, 90, 91, 92, 100};
+    const auto bounds = xn::balanced_row_partition(offsets, 4);
+    CHECK(bounds.size() == 5);
+    CHECK(bounds.front() == 0);
+    CHECK(bounds.back() == 6);
+    for (auto p = 0U; p + 1 < bounds.size(); ++p)
+    {
+        CHECK(bounds[p] <= bounds[p + 1]);
+    }
+    CHECK(bounds[1] == 3); // the heavy row ends the first part
+}
+
+TEST_CASE("Test eigenvector centrality")
+{
+    auto pool = xn::ThreadPool {3};
+    auto path = EdgeList {{0, 1}, {1, 0}, {1, 2}, {2, 1}, {2, 3}, {3, 2}};
+    const auto P = xn::csr_graph_from_edges<int>(4, path);
+    const auto r = xn::eigenvector_centrality(P, pool);
+    CHECK(r._x[0] == doctest::Approx(0.37).epsilon(0.01));
+    CHECK(r._x[1] == doctest::Approx(0.60).epsilon(0.01));
+    CHECK(r._residual < 4 * 1.0e-6);
+
+    const auto n = 20000U;
+    auto edges = create_chordal_ring(n, 30000);
+    const auto G = xn::csr_graph_from_edges<int>(n, edges);
+    const auto cold = xn::eigenvector_centrality(G, pool, 1000, 1.0e-9);
+    // x is an eigenvector of A: compare A x with lambda x
+    auto ax = std::vector<double>(n);
+    for (auto u = 0U; u != n; ++u)
+    {
+        for (auto v : G.neighbors(u))
+        {
+            ax[v] += cold._x[u];
+        }
+    }
+    auto lambda = 0.0;
+    for (auto v = 0U; v != n; ++v)
+    {
+        lambda += ax[v] * cold._x[v];
+    }
+    auto error = 0.0;
+    for (auto v = 0U; v != n; ++v)
+    {
+        error = std::max(error, std::abs(ax[v] - lambda * cold._x[v]));
+    }
+    CHECK(error < 1.0e-4);
+
+    // the same bits with any number of threads
+    auto single = xn::ThreadPool {1};
+    CHECK(xn::eigenvector_centrality(G, single, 1000, 1.0e-9)._x == cold._x);
+
+    // a small change converges fast from the previous vector
+    edges.emplace_back(5, 9000);
+    edges.emplace_back(9000, 5);
+    const auto G2 = xn::csr_graph_from_edges<int>(n, edges);
+    const auto warm = xn::eigenvector_centrality(G2, pool, 100, 1e-6, cold._x);
+    const auto again = xn::eigenvector_centrality(G2, pool, 100, 1e-6);
+    CHECK(warm._iterations * 4 < again._iterations);
+    CHECK(warm._x[5] == doctest::Approx(again._x[5]).epsilon(0.01));
+
+    CHECK_THROWS_AS(xn::eigenvector_centrality(G, pool, 2),
+        xn::PowerIterationFailedConvergence);
+    CHECK_THROWS_AS(
+        xn::eigenvector_centrality(P, pool, 100, 1.0e-6, {0.0, 0.0, 0.0, 0.0}),
+        xn::XNetworkError);
+    const auto E = xn::csr_graph_from_edges<int>(0, EdgeList {});
+    CHECK_THROWS_AS(
+        xn::eigenvector_centrality(E, pool), xn::XNetworkPointlessConcept);
+}
+
+TEST_CASE("Test Katz centrality")
+{
+    auto pool = xn::ThreadPool {2};
+    const auto P = xn::csr_graph_from_edges<int>(
+        3, EdgeList {{0, 1}, {1, 0}, {1, 2}, {2, 1}});
+    // x0 = 1 + 0.1 x1, x1 = 1 + 0.2 x0
+    const auto x0 = 1.1 / 0.98;
+    const auto x1 = 1.0 + 0.2 * x0;
+    const auto r = xn::katz_centrality(P, pool, 0.1, 1.0, 1000, 1.0e-12,
+        {}, false);
+    CHECK(r._x[0] == doctest::Approx(x0));
+    CHECK(r._x[1] == doctest::Approx(x1));
+    const auto norm = std::sqrt(2 * x0 * x0 + x1 * x1);
+    const auto s = xn::katz_centrality(P, pool, 0.1);
+    CHECK(s._x[1] == doctest::Approx(x1 / norm));
+
+    // weighted directed arcs with a beta per node
+    const auto W = xn::csr_graph_from_edges<double>(3,
+        EdgeList {{0, 1}, {1, 2}, {2, 0}}, std::vector<double> {2.0, 1.0, 0.5});
+    const auto beta = std::vector<double> {1.0, 2.0, 3.0};
+    const auto k = xn::katz_centrality(W, pool, 0.2, beta, 1000, 1.0e-12,
+        {}, false);
+    CHECK(k._x[1] == doctest::Approx(0.2 * 2.0 * k._x[0] + 2.0));
+    CHECK(k._x[2] == doctest::Approx(0.2 * 1.0 * k._x[1] + 3.0));
+    CHECK(k._x[0] == doctest::Approx(0.2 * 0.5 * k._x[2] + 1.0));
+
+    // warm start from the fixed point
+    const auto w = xn::katz_centrality(W, pool, 0.2, beta, 1000, 1.0e-12,
+        k._x, false);
+    CHECK(w._iterations == 1);
+    CHECK_THROWS_AS(xn::katz_centrality(W, pool, 0.2, std::vector<double>(2)),
+        xn::XNetworkError);
+}
@@ -0,0 +1,137 @@
+// -*- coding: utf-8 -*-
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/link_analysis/hits.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+#include "random_graphs.hpp"
+
+/*!
+ * @brief Create a pseudo-random weighted digraph with sources and sinks
+ */
+inline auto create_hits_graph(std::uint32_t n, std::uint32_t m)
+{
+    auto [edges, weights] = random_weighted_arcs<double>(n, m, 2718, 1, 4);
+    for (auto& [u, v] : edges)
+    {
+        // a few hubs point to a few authorities
+        u = u % 5 == 0 ? u : u % (n / 4 + 1);
+        v = v % 3 == 0 ? v % (n / 10 + 1) : v;
+    }
+    return xn::csr_graph_from_edges<double>(n, edges, weights);
+}
+
+/*!
+ * @brief HITS by the sequential XNetwork iteration
+ */
+template <typename CSR>
+auto brute_force_hits(const CSR& G)
+{
+    const auto n = G.number_of_nodes();
+    auto h = std::vector<double>(n, 1.0 / n);
+    auto a = std::vector<double>(n);
+    for (auto it = 0U; it != 500; ++it)
+    {
+        std::fill(a.begin(), a.end(), 0.0);
+        for (auto u = 0U; u != n; ++u)
+        {
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                a[G.target(e)] += h[u] * G.weight(e);
+            }
+        }
+        for (auto u = 0U; u != n; ++u)
+        {
+            h[u] = 0.0;
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                h[u] += a[G.target(e)] * G.weight(e);
+            }
+        }
+        const auto hm = *std::max_element(h.begin(), h.end());
+        const auto am = *std::max_element(a.begin(), a.end());
+        for (auto u = 0U; u != n; ++u)
+        {
+            h[u] /= hm;
+            a[u] /= am;
+        }
+    }
+    for (auto* v : {&h, &a})
+    {
+        auto sum = 0.0;
+        for (auto x : *v)
+        {
+            sum += x;
+        }
+        for (auto& x : *v)
+        {
+            x /= sum;
+        }
+    }
+    return std::make_pair(h, a);
+}
+
+TEST_CASE("Test HITS")
+{
+    auto pool = xn::ThreadPool {3};
+    const auto n = 5000U;
+    const auto G = create_hits_graph(n, 30000);
+    const auto [href, aref] = brute_force_hits(G);
+    const auto r = xn::hits(G, pool, 200, 1.0e-12);
+    auto error = 0.0;
+    auto hsum = 0.0;
+    auto asum = 0.0;
+    for (auto v = 0U; v != n; ++v)
+    {
+        error = std::max(error, std::abs(r._hubs[v] - href[v]));
+        error = std::max(error, std::abs(r._authorities[v] - aref[v]));
+        hsum += r._hubs[v];
+        asum += r._authorities[v];
+    }
+    CHECK(error < 1.0e-10);
+    CHECK(hsum == doctest::Approx(1.0));
+    CHECK(asum == doctest::Approx(1.0));
+
+    // a kept transpose, and any number of threads, give the same bits
+    const auto GT = G.transpose();
+    auto single = xn::ThreadPool {1};
+    const auto s = xn::hits(G, GT, single, 200, 1.0e-12);
+    CHECK(s._hubs == r._hubs);
+    CHECK(s._authorities == r._authorities);
+    CHECK(s._iterations == r._iterations);
+
+    // unnormalized: the largest value is 1
+    const auto u = xn::hits(G, GT, pool, 200, 1.0e-12, {}, false);
+    CHECK(*std::max_element(u._hubs.begin(), u._hubs.end())
+        == doctest::Approx(1.0));
+    CHECK(*std::max_element(u._authorities.begin(), u._authorities.end())
+        == doctest::Approx(1.0));
+
+    // a warm start converges at once
+    const auto warm = xn::hits(G, GT, pool, 200, 1.0e-8, r._hubs);
+    CHECK(warm._iterations == 1);
+
+    CHECK_THROWS_AS(
+        xn::hits(G, GT, pool, 2), xn::PowerIterationFailedConvergence);
+    CHECK_THROWS_AS(xn::hits(G, GT, pool, 100, 1.0e-8, {1.0}),
+        xn::XNetworkError);
+    CHECK_THROWS_AS(xn::hits(G, GT, pool, 100, 1.0e-8,
+                        std::vector<double>(n, 0.0)),
+        xn::XNetworkError);
+
+    // no arcs: all zero; no nodes: empty
+    const auto I = xn::csr_graph_from_edges<int>(
+        4, std::vector<std::pair<std::uint32_t, std::uint32_t>> {});
+    const auto z = xn::hits(I, pool);
+    CHECK(z._hubs == std::vector<double>(4, 0.0));
+    CHECK(z._authorities == std::vector<double>(4, 0.0));
+    const auto E = xn::csr_graph_from_edges<int>(
+        0, std::vector<std::pair<std::uint32_t, std::uint32_t>> {});
+    CHECK(xn::hits(E, pool)._hubs.empty());
+}
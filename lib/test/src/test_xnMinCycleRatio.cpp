@@ -0,0 +1,177 @@
+// -*- coding: utf-8 -*-
+#include <array>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <py2cpp/fractions.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/shortest_paths/min_cycle_ratio.hpp>
+#include <xnetwork/classes/digraphs.hpp>
+#include <xnetwork/exception.hpp>
+
+#include "random_graphs.hpp"
+
+using Fraction = fun::Fraction<int>;
+
+/*!
+ * @brief Create a pseudo-random digraph with costs in [-5, 14]
+ */
+inline auto create_random_digraphs(int n, int m, std::uint32_t seed)
+{
+    const auto [edges, costs] = random_weighted_arcs<int>(
+        std::uint32_t(n), std::uint32_t(m), seed, -5, 14);
+    auto G = xn::SimpleDiGraphS {n};
+    for (auto k = std::size_t(0); k != edges.size(); ++k)
+    {
+        G.add_edge(int(edges[k].first), int(edges[k].second), costs[k]);
+    }
+    return G;
+}
+
+/*!
+ * @brief Minimum ratio over all simple cycles, by exhaustive search
+ *
+ * @return (cost, time) of the best cycle, time 0 if there is none
+ */
+template <typename Graph, typename TimeFn>
+auto brute_force_ratio(const Graph& G, int n, TimeFn&& get_time)
+    -> std::pair<int, int>
+{
+    auto best = std::pair<int, int> {0, 0};
+    auto on_path = std::vector<char>(std::size_t(n), 0);
+    // cycles through their smallest node s only
+    auto dfs = [&](auto&& self, int s, int u, int cost, int time) -> void {
+        for (auto&& v : G[u])
+        {
+            const auto c = cost + G[u][v];
+            const auto t = time + get_time(std::pair<int, int> {u, v});
+            if (v == s)
+            {
+                if (best.second == 0 || c * best.second < best.first * t)
+                {
+                    best = {c, t};
+                }
+            }
+            else if (v > s && !on_path[std::size_t(v)])
+            {
+                on_path[std::size_t(v)] = 1;
+                self(self, s, v, c, t);
+                on_path[std::size_t(v)] = 0;
+            }
+        }
+    };
+    for (auto s = 0; s != n; ++s)
+    {
+        on_path[std::size_t(s)] = 1;
+        dfs(dfs, s, s, 0, 0);
+        on_path[std::size_t(s)] = 0;
+    }
+    return best;
+}
+
+/*!
+ * @brief Check that a cycle is closed and has the given ratio
+ */
+template <typename Graph, typename Cycle, typename TimeFn>
+auto is_critical_cycle(const Graph& G, const Cycle& cycle, TimeFn&& get_time,
+    const Fraction& ratio) -> bool
+{
+    auto cost = 0;
+    auto time = 0;
+    auto ok = !cycle.empty();
+    for (auto k = 0U; k != cycle.size(); ++k)
+    {
+        const auto [u, v] = cycle[k];
+        ok = ok && G[u].contains(v)
+            && v == cycle[(k + 1) % cycle.size()].first;
+        cost += G[u][v];
+        time += get_time(cycle[k]);
+    }
+    return ok && Fraction(cost, time) == ratio;
+}
+
+TEST_CASE("Test minimum cycle ratio against exhaustive search")
+{
+    const auto get_time = [](const auto& e) {
+        return 1 + (e.first + e.second) % 3;
+    };
+    const auto unit = [](const auto&) { return 1; };
+    auto checked = 0;
+    for (auto trial = 0U; trial != 200; ++trial)
+    {
+        const auto n = 2 + int(trial % 6);
+        const auto G = create_random_digraphs(n, n + int(trial % 9), trial);
+        const auto get_cost = [&](const auto& e) {
+            return G[e.first][e.second];
+        };
+        const auto ref = brute_force_ratio(G, n, get_time);
+        auto S = xn::MinCycleRatioSolver<decltype(G), Fraction>(G);
+        if (ref.second == 0)
+        {
+            CHECK_THROWS_AS(
+                S.howard(get_cost, get_time), xn::XNetworkNoCycle);
+            CHECK_THROWS_AS(S.karp(get_cost), xn::XNetworkNoCycle);
+            CHECK_THROWS_AS(
+                S.young_tarjan_orlin(get_cost, get_time), xn::XNetworkNoCycle);
+            continue;
+        }
+        ++checked;
+        const auto expected = Fraction(ref.first, ref.second);
+        const auto [r1, c1] = S.howard(get_cost, get_time);
+        CHECK(r1 == expected);
+        CHECK(is_critical_cycle(G, c1, get_time, r1));
+        const auto [r2, c2] = S.young_tarjan_orlin(get_cost, get_time);
+        CHECK(r2 == expected);
+        CHECK(is_critical_cycle(G, c2, get_time, r2));
+
+        const auto mean = brute_force_ratio(G, n, unit);
+        const auto [r3, c3] = S.karp(get_cost);
+        CHECK(r3 == Fraction(mean.first, mean.second));
+        CHECK(is_critical_cycle(G, c3, unit, r3));
+        const auto [r4, c4] = xn::min_mean_cycle<Fraction>(G, get_cost);
+        CHECK(r4 == r3);
+        CHECK(is_critical_cycle(G, c4, unit, r4));
+    }
+    CHECK(checked > 100);
+}
+
+TEST_CASE("Test minimum cycle ratio in floating point")
+{
+    const auto G = create_random_digraphs(60, 300, 7);
+    const auto get_cost = [&](const auto& e) { return G[e.first][e.second]; };
+    const auto get_time = [](const auto& e) { return 1 + e.first % 4; };
+    auto S = xn::MinCycleRatioSolver<decltype(G)>(G);
+    const auto r1 = S.howard(get_cost, get_time).first;
+    const auto r2 = S.young_tarjan_orlin(get_cost, get_time).first;
+    CHECK(r1 == doctest::Approx(r2));
+    auto E = xn::MinCycleRatioSolver<decltype(G), Fraction>(G);
+    const auto exact = E.howard(get_cost, get_time).first;
+    CHECK(r1
+        == doctest::Approx(
+            double(exact._numerator) / double(exact._denominator)));
+}
+
+TEST_CASE("Test minimum cycle ratio warm start")
+{
+    using Edge = std::pair<std::string, std::string>;
+    auto G = xn::DiGraphS {std::vector<std::string> {"A", "B", "C", "D"}};
+    const auto edges = std::array<Edge, 5> {Edge {"A", "B"}, Edge {"B", "A"},
+        Edge {"B", "C"}, Edge {"C", "D"}, Edge {"D", "B"}};
+    G.add_edges_from(edges, std::array<int, 5> {4, 4, 1, 1, 1});
+    const auto& CG = G;
+    const auto get_cost = [&](const auto& e) { return CG[e.first][e.second]; };
+    const auto unit = [](const auto&) { return 1; };
+
+    auto S = xn::MinCycleRatioSolver<decltype(G), Fraction>(CG);
+    auto [ratio, cycle] = S.howard(get_cost, unit);
+    CHECK(ratio == Fraction(1));
+    CHECK(cycle.size() == 3);
+
+    G._adj["C"]["D"] = 13; // same edges, new cost
+    std::tie(ratio, cycle) = S.howard(get_cost, unit);
+    CHECK(ratio == Fraction(4));
+    CHECK(cycle.size() == 2);
+    CHECK(xn::min_cycle_ratio<Fraction>(CG, get_cost, unit).first
+        == Fraction(4));
+}
@@ -0,0 +1,262 @@
+// -*- coding: utf-8 -*-
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/link_analysis/pagerank.hpp>
+#include <xnetwork/algorithms/link_analysis/personalized_pagerank.hpp>
+#include <xnetwork/classes/csr_graph.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+
+#include "random_graphs.hpp"
+
+/*!
+ * @brief Create a pseudo-random digraph with dangling nodes and weights
+ */
+inline auto create_web_graph(std::uint32_t n, std::uint32_t m)
+{
+    const auto [arcs, lengths] =
+        random_weighted_arcs<double>(n, m, 31337, 1, 3);
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    auto weights = std::vector<double> {};
+    for (auto k = 0U; k != m; ++k)
+    {
+        const auto [u, r] = arcs[k];
+        if (u % 7 == 3)
+        {
+            continue; // dangling
+        }
+        // skewed heads, like the in-degrees of the web
+        edges.emplace_back(u, r % 97 == 0 ? r : r % (n / 8 + 1));
+        weights.push_back(lengths[k]);
+    }
+    return xn::csr_graph_from_edges<double>(n, edges, weights);
+}
+
+/*!
+ * @brief PageRank by the sequential XNetwork iteration
+ */
+template <typename CSR>
+auto brute_force_pagerank(const CSR& G, double alpha,
+    const std::vector<double>& p, const std::vector<double>& d)
+{
+    const auto n = G.number_of_nodes();
+    auto x = std::vector<double>(n, 1.0 / n);
+    for (auto it = 0U; it != 1000; ++it)
+    {
+        auto last = x;
+        auto danglesum = 0.0;
+        for (auto u = 0U; u != n; ++u)
+        {
+            danglesum += G.degree(u) == 0 ? alpha * last[u] : 0.0;
+        }
+        for (auto v = 0U; v != n; ++v)
+        {
+            x[v] = danglesum * d[v] + (1.0 - alpha) * p[v];
+        }
+        for (auto u = 0U; u != n; ++u)
+        {
+            auto out = 0.0;
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                out += G.weight(e);
+            }
+            for (auto e = G.edge_begin(u); e != G.edge_end(u); ++e)
+            {
+                x[G.target(e)] += alpha * last[u] * G.weight(e) / out;
+            }
+        }
+    }
+    return x;
+}
+
+TEST_CASE("Test PageRank")
+{
+    auto pool = xn::ThreadPool {3};
+    const auto n = 3000U;
+    const auto G = create_web_graph(n, 20000);
+    const auto uniform = std::vector<double>(n, 1.0 / n);
+    const auto ref = brute_force_pagerank(G, 0.85, uniform, uniform);
+    const auto jacobi = xn::pagerank(G, pool, 0.85, {}, 200, 1.0e-12);
+    const auto gauss_seidel = xn::pagerank(G, pool, 0.85, {}, 200, 1.0e-12,
+        {}, {}, xn::PageRankUpdate::gauss_seidel);
+    CHECK(gauss_seidel._iterations < jacobi._iterations);
+    auto error = 0.0;
+    auto sum = 0.0;
+    for (auto v = 0U; v != n; ++v)
+    {
+        error = std::max(error, std::abs(jacobi._x[v] - ref[v]));
+        error = std::max(error, std::abs(gauss_seidel._x[v] - ref[v]));
+        sum += jacobi._x[v];
+    }
+    CHECK(error < 1.0e-10);
+    CHECK(sum == doctest::Approx(1.0));
+
+    // the same bits with any number of threads
+    auto single = xn::ThreadPool {1};
+    CHECK(xn::pagerank(G, single, 0.85, {}, 200, 1.0e-12)._x == jacobi._x);
+
+    // many parts: Gauss-Seidel within each, still the same bits
+    const auto H = create_web_graph(40000, 250000);
+    const auto hj = xn::pagerank(H, pool, 0.85, {}, 200, 1.0e-10);
+    const auto hg = xn::pagerank(H, pool, 0.85, {}, 200, 1.0e-10, {}, {},
+        xn::PageRankUpdate::gauss_seidel);
+    CHECK(hg._iterations <= hj._iterations);
+    CHECK(xn::pagerank(H, single, 0.85, {}, 200, 1.0e-10, {}, {},
+              xn::PageRankUpdate::gauss_seidel)
+              ._x
+        == hg._x);
+    error = 0.0;
+    for (auto v = 0U; v != 40000; ++v)
+    {
+        error = std::max(error, std::abs(hj._x[v] - hg._x[v]));
+    }
+    CHECK(error < 1.0e-8);
+
+    // personalization, and dangling nodes sent elsewhere
+    auto p = std::vector<double>(n, 0.0);
+    auto d = std::vector<double>(n, 0.0);
+    for (auto v = 0U; v != n; v += 10)
+    {
+        p[v] = 1.0 + v % 3;
+        d[v + 1] = 2.0;
+    }
+    const auto r = xn::pagerank(G, pool, 0.9, p, 300, 1.0e-12, {}, d);
+    auto ps = 0.0;
+    auto ds = 0.0;
+    for (auto v = 0U; v != n; ++v)
+    {
+        ps += p[v];
+        ds += d[v];
+    }
+    for (auto v = 0U; v != n; ++v)
+    {
+        p[v] /= ps;
+        d[v] /= ds;
+    }
+    const auto pref = brute_force_pagerank(G, 0.9, p, d);
+    error = 0.0;
+    for (auto v = 0U; v != n; ++v)
+    {
+        error = std::max(error, std::abs(r._x[v] - pref[v]));
+    }
+    CHECK(error < 1.0e-10);
+
+    // a warm start converges at once
+    const auto warm = xn::pagerank(G, pool, 0.85, {}, 200, 1.0e-6, jacobi._x);
+    CHECK(warm._iterations == 1);
+
+    CHECK_THROWS_AS(xn::pagerank(G, pool, 0.85, {}, 3),
+        xn::PowerIterationFailedConvergence);
+    CHECK_THROWS_AS(
+        xn::pagerank(G, pool, 0.85, std::vector<double>(n)), xn::XNetworkError);
+    CHECK_THROWS_AS(xn::pagerank(G, pool, 0.85, {}, 100, 1.0e-6, {1.0}),
+        xn::XNetworkError);
+    const auto E = xn::csr_graph_from_edges<int>(
+        0, std::vector<std::pair<std::uint32_t, std::uint32_t>> {});
+    CHECK(xn::pagerank(E, pool)._x.empty());
+}
+
+TEST_CASE("Test personalized PageRank by forward push")
+{
+    auto pool = xn::ThreadPool {3};
+    const auto n = 3000U;
+    const auto G = create_web_graph(n, 20000);
+    // an undirected, unweighted graph for the error bound
+    auto edges = std::vector<std::pair<std::uint32_t, std::uint32_t>> {};
+    for (auto u = 0U; u != n; ++u)
+    {
+        for (auto v : G.neighbors(u))
+        {
+            edges.emplace_back(u, v);
+            edges.emplace_back(v, u);
+        }
+    }
+    const auto U = xn::csr_graph_from_edges<int>(n, edges);
+    const auto epsilon = 1.0e-6;
+    for (auto seed : {0U, 17U, 2999U})
+    {
+        auto e_s = std::vector<double>(n, 0.0);
+        e_s[seed] = 1.0;
+        auto ws = xn::PushWorkspace {n};
+
+        const auto ppr = xn::PersonalizedPageRankPush<decltype(U)> {
+            U, 0.85, epsilon};
+        const auto scores = ppr.query(seed, ws);
+        const auto ref =
+            xn::pagerank(U, pool, 0.85, e_s, 1000, 1.0e-15)._x;
+        auto estimate = std::vector<double>(n, 0.0);
+        for (const auto& [v, p] : scores)
+        {
+            estimate[v] = p;
+        }
+        auto ok = true;
+        for (auto v = 0U; v != n; ++v)
+        {
+            const auto gap = ref[v] - estimate[v];
+            // dangling nodes count as out-weight 1
+            const auto w = std::max(U.degree(v), std::size_t(1));
+            ok = ok && gap > -1.0e-12 && gap <= epsilon * double(w) + 1e-12;
+        }
+        CHECK(ok);
+        for (auto i = 1U; i < scores.size(); ++i)
+        {
+            ok = ok && scores[i - 1].second >= scores[i].second;
+        }
+        CHECK(ok);
+
+        // weighted arcs and dangling nodes
+        const auto wppr =
+            xn::PersonalizedPageRankPush<decltype(G)> {G, 0.85, 1.0e-9};
+        const auto wref =
+            xn::pagerank(G, pool, 0.85, e_s, 1000, 1.0e-15)._x;
+        auto error = 0.0;
+        for (const auto& [v, p] : wppr.query(seed, ws))
+        {
+            error = std::max(error, std::abs(wref[v] - p));
+        }
+        CHECK(error < 1.0e-6);
+    }
+
+    // a coarse threshold stays local
+    const auto local =
+        xn::PersonalizedPageRankPush<decltype(U)> {U, 0.85, 1.0e-3};
+    auto ws = xn::PushWorkspace {n};
+    local.push(5, ws);
+    CHECK(ws._touched.size() < n / 4);
+    const auto top = local.query(5, ws, 10);
+    CHECK(top.size() == 10);
+    CHECK(top[0].first == 5);
+
+    // batches equal the single queries, whatever the threads
+    auto seeds = std::vector<std::uint32_t> {};
+    for (auto s = 0U; s < n; s += 7)
+    {
+        seeds.push_back(s);
+    }
+    auto workspaces = std::vector<xn::PushWorkspace>(pool.size(), ws);
+    const auto batch = local.query(pool, seeds, workspaces, 10);
+    auto ok = batch.size() == seeds.size();
+    for (auto i = 0U; ok && i != seeds.size(); ++i)
+    {
+        ok = batch[i] == local.query(seeds[i], ws, 10);
+    }
+    CHECK(ok);
+    CHECK(local.query(pool, seeds, workspaces, 10) == batch);
+    CHECK_THROWS_AS(local.push(n, ws), xn::NodeNotFound);
+    CHECK_THROWS_AS(local.query(n + 5, ws), xn::NodeNotFound);
+    seeds.push_back(n);
+    CHECK_THROWS_AS(local.query(pool, seeds, workspaces), xn::NodeNotFound);
+    seeds.pop_back();
+    auto small = xn::PushWorkspace {n - 1};
+    CHECK_THROWS_AS(local.push(5, small), xn::XNetworkError);
+    auto too_few = std::vector<xn::PushWorkspace>(pool.size() - 1, ws);
+    CHECK_THROWS_AS(local.query(pool, seeds, too_few), xn::XNetworkError);
+    workspaces.back() = small;
+    CHECK_THROWS_AS(local.query(pool, seeds, workspaces), xn::XNetworkError);
+    CHECK_THROWS_AS((xn::PersonalizedPageRankPush<decltype(U)> {U, 1.0}),
+        xn::XNetworkError);
+}
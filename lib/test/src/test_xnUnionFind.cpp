@@ -0,0 +1,109 @@
+// -*- coding: utf-8 -*-
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <utility>
+#include <vector>
+#include <xnetwork/algorithms/components/incremental_connectivity.hpp>
+#include <xnetwork/classes/graph.hpp>
+#include <xnetwork/exception.hpp>
+#include <xnetwork/utils/thread_pool.hpp>
+#include <xnetwork/utils/union_find.hpp>
+
+#include "random_graphs.hpp"
+
+TEST_CASE("Test UnionFind")
+{
+    auto sets = xn::UnionFind {6};
+    CHECK(sets.number_of_sets() == 6);
+    CHECK(sets.unite(0, 1));
+    CHECK(sets.unite(2, 3));
+    CHECK(sets.unite(1, 3));
+    CHECK(!sets.unite(0, 2));
+    CHECK(sets.connected(0, 3));
+    CHECK(!sets.connected(0, 4));
+    CHECK(sets.set_size(2) == 4);
+    CHECK(sets.number_of_sets() == 3);
+    CHECK(sets.add() == 6);
+    CHECK(sets.unite(6, 5));
+    CHECK(sets.to_sets()
+        == std::vector<std::vector<std::uint32_t>> {{0, 1, 2, 3}, {4}, {5, 6}});
+
+    // a long chain stays shallow
+    const auto n = 100000U;
+    auto chain = xn::UnionFind {n};
+    for (auto x = 1U; x != n; ++x)
+    {
+        chain.unite(x - 1, x);
+    }
+    CHECK(chain.number_of_sets() == 1);
+    CHECK(chain.set_size(n / 2) == n);
+}
+
+TEST_CASE("Test ConcurrentUnionFind")
+{
+    const auto n = 100000U;
+    const auto pairs = random_arcs(n, 60000, 777);
+    auto ref = xn::UnionFind {n};
+    auto merges = std::size_t(0);
+    for (const auto& [u, v] : pairs)
+    {
+        merges += ref.unite(u, v) ? 1 : 0;
+    }
+    auto roots = std::vector<std::uint32_t>(n);
+    for (auto x = 0U; x != n; ++x)
+    {
+        roots[x] = ref.find(x);
+    }
+    for (auto threads : {1U, 4U})
+    {
+        auto pool = xn::ThreadPool {threads};
+        auto sets = xn::ConcurrentUnionFind {n};
+        auto joined = std::vector<std::size_t>(pool.size(), 0);
+        xn::parallel_for(pool, 0, pairs.size(), 64,
+            [&](unsigned tid, std::size_t i) {
+                joined[tid] +=
+                    sets.unite(pairs[i].first, pairs[i].second) ? 1 : 0;
+            });
+        auto total = std::size_t(0);
+        for (auto j : joined)
+        {
+            total += j;
+        }
+        CHECK(total == merges);
+        CHECK(sets.number_of_sets() == ref.number_of_sets());
+        auto agree = std::vector<std::uint8_t>(pairs.size(), 1);
+        xn::parallel_for(pool, 0, pairs.size(), 64,
+            [&](unsigned, std::size_t i) {
+                const auto u = pairs[i].first;
+                const auto v = std::uint32_t((i * 7919U) % n);
+                agree[i] = sets.connected(u, v) == (roots[u] == roots[v])
+                        && sets.connected(u, pairs[i].second)
+                    ? 1
+                    : 0;
+            });
+        CHECK(agree == std::vector<std::uint8_t>(pairs.size(), 1));
+    }
+}
+
+TEST_CASE("Test IncrementalConnectivity")
+{
+    auto G = xn::SimpleGraph {6};
+    G.add_edge(0, 1);
+    G.add_edge(2, 3);
+    auto cc = xn::IncrementalConnectivity<xn::SimpleGraph> {G};
+    CHECK(cc.number_connected_components() == 4);
+    CHECK(cc.connected(1, 0));
+    CHECK(!cc.connected(1, 2));
+    CHECK(cc.add_edge(1, 2));
+    CHECK(!cc.add_edge(3, 0));
+    CHECK(G.number_of_edges() == 4);
+    CHECK(cc.connected(0, 3));
+    CHECK(cc.component_size(2) == 4);
+    CHECK(cc.add_edges_from({{4, 5}, {5, 4}, {0, 5}}) == 2);
+    CHECK(cc.number_connected_components() == 1);
+    CHECK(cc.components()
+        == std::vector<std::vector<std::uint32_t>> {{0, 1, 2, 3, 4, 5}});
+    CHECK_THROWS_AS(cc.add_edge(0, 6), xn::NodeNotFound);
+    CHECK_THROWS_AS(cc.add_edges_from({{1, 4}, {7, 0}}), xn::NodeNotFound);
+    CHECK(G.number_of_edges() == 7);
+}